@@ -0,0 +1,25 @@
+#include <benchmark/benchmark.h>
+
+#include <QApplication>
+#include <QStandardPaths>
+
+// The render and skin benchmarks need a QApplication; the offscreen platform
+// keeps them runnable on headless CI machines. Skins are read from and written to
+// the QStandardPaths test locations, never the user's own skin directory.
+int main(int argc, char** argv) {
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QStandardPaths::setTestModeEnabled(true);
+
+    benchmark::Initialize(&argc, argv);
+    QApplication app(argc, argv);
+    QCoreApplication::setApplicationName("AnalogVUMeterQtBench");
+
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
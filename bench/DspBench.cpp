@@ -0,0 +1,168 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "VUBallistics.h"
+#include "VUMeterScale.h"
+#include "VuAudioDsp.h"
+
+// Same clamp range as the capture backends
+static constexpr float kFloorVu = -96.0f;
+static constexpr float kCeilingVu = 6.0f;
+
+// Interleaved programme-like test signal: a 1 kHz tone around 0 VU with a little
+// per-channel detune, so every channel's meter is awake and moving
+static std::vector<float> testSignal(unsigned int frames, unsigned int channels, float sampleRate) {
+    std::vector<float> data(static_cast<size_t>(frames) * channels);
+    for (unsigned int f = 0; f < frames; ++f) {
+        for (unsigned int c = 0; c < channels; ++c) {
+            const float hz = 1000.0f + 7.0f * static_cast<float>(c);
+            data[static_cast<size_t>(f) * channels + c] =
+                0.125f * std::sin(2.0f * 3.14159265f * hz * static_cast<float>(f) / sampleRate);
+        }
+    }
+    return data;
+}
+
+// -------- Meter DSP --------
+
+// Args: channels, frames per buffer, sample rate
+static void BM_ProcessInterleaved(benchmark::State& state) {
+    const auto channels = static_cast<unsigned int>(state.range(0));
+    const auto frames = static_cast<unsigned int>(state.range(1));
+    const auto sampleRate = static_cast<float>(state.range(2));
+
+    const std::vector<float> data = testSignal(frames, channels, sampleRate);
+    std::vector<float> vu(channels);
+    VuAudioDspState dsp(VuJitterOptions{false});
+    const VuReferenceOptions ref;
+
+    for (auto _ : state) {
+        processInterleavedFloatAudioToVuDb(
+            data.data(), frames, channels, sampleRate, ref, dsp, kFloorVu, kCeilingVu, vu.data());
+        benchmark::DoNotOptimize(vu.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * frames * channels); // samples
+    state.counters["realtime_x"] = benchmark::Counter(
+        static_cast<double>(frames) / sampleRate, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_ProcessInterleaved)
+    ->ArgNames({"channels", "frames", "rate"})
+    ->ArgsProduct({{1, 2, 8, 32, 64}, {64, 512, 4096}, {44100, 48000, 96000, 192000}});
+
+// Args: channels, frames per buffer; 48 kHz at a 1 kHz control rate
+static void BM_ProcessInterleavedFixedRate(benchmark::State& state) {
+    const auto channels = static_cast<unsigned int>(state.range(0));
+    const auto frames = static_cast<unsigned int>(state.range(1));
+    constexpr float kSampleRate = 48000.0f;
+
+    const std::vector<float> data = testSignal(frames, channels, kSampleRate);
+    std::vector<float> vu(channels);
+    VuAudioDspState dsp(VuJitterOptions{false});
+    const VuReferenceOptions ref;
+
+    for (auto _ : state) {
+        processInterleavedFloatAudioToVuDbFixedRate(
+            data.data(), frames, channels, kSampleRate, 1000.0f, ref, dsp, kFloorVu, kCeilingVu, vu.data());
+        benchmark::DoNotOptimize(vu.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * frames * channels);
+}
+BENCHMARK(BM_ProcessInterleavedFixedRate)
+    ->ArgNames({"channels", "frames"})
+    ->ArgsProduct({{2, 8, 64}, {64, 512, 4096}});
+
+// -------- Ballistics --------
+
+// Arg: ballistics preset (VuBallisticsPreset)
+static void BM_BallisticsProcess(benchmark::State& state) {
+    const VuBallisticsProfile profile = vuBallisticsPreset(static_cast<VuBallisticsPreset>(state.range(0)));
+    VUBallistics ballistics(-20.0f, profile, VuJitterOptions{false});
+
+    float target = -20.0f;
+    for (auto _ : state) {
+        target = target > 3.0f ? -20.0f : target + 0.37f;
+        benchmark::DoNotOptimize(ballistics.process(target, 0.001f));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BallisticsProcess)
+    ->ArgName("preset")
+    ->DenseRange(static_cast<int>(VuBallisticsPreset::Pioneer), static_cast<int>(VuBallisticsPreset::Nordic));
+
+// Args: channels, ballistics preset; one stepAll() per control step
+static void BM_BallisticsBankStepAll(benchmark::State& state) {
+    const auto channels = static_cast<unsigned int>(state.range(0));
+    const VuBallisticsProfile profile = vuBallisticsPreset(static_cast<VuBallisticsPreset>(state.range(1)));
+    const VUBallistics::Coefficients coefficients = VUBallistics::coefficientsFor(profile, 0.001f);
+
+    VUBallisticsBank bank;
+    bank.setJitter(VuJitterOptions{false});
+    bank.configure(channels, -20.0f);
+
+    std::vector<float> targets(channels);
+    std::vector<float> out(channels);
+    for (unsigned int c = 0; c < channels; ++c) {
+        targets[c] = -20.0f + static_cast<float>(c % 24);
+    }
+
+    for (auto _ : state) {
+        bank.stepAll(targets.data(), coefficients, out.data());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * channels);
+}
+BENCHMARK(BM_BallisticsBankStepAll)
+    ->ArgNames({"channels", "preset"})
+    ->ArgsProduct({{2, 8, 64},
+                   {static_cast<int>(VuBallisticsPreset::Pioneer), static_cast<int>(VuBallisticsPreset::PpmType2)}});
+
+// -------- Scale mapping --------
+
+// Levels swept over and a little beyond the default table
+static std::vector<float> sweepLevels() {
+    std::vector<float> levels(1024);
+    for (size_t i = 0; i < levels.size(); ++i) {
+        levels[i] = -24.0f + 30.0f * static_cast<float>(i) / static_cast<float>(levels.size());
+    }
+    return levels;
+}
+
+// The one-off lookup: a linear scan of the QVector table
+static void BM_VuToAngleDegTable(benchmark::State& state) {
+    const VUMeterScaleTable table = builtInDefaultScaleTable();
+    const std::vector<float> levels = sweepLevels();
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(vuToAngleDeg(levels[i], table));
+        i = (i + 1) & (levels.size() - 1);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_VuToAngleDegTable);
+
+// What the renderers use per needle
+static void BM_VuToAngleDegLut(benchmark::State& state) {
+    const VUMeterScaleLut lut(builtInDefaultScaleTable());
+    const std::vector<float> levels = sweepLevels();
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lut.angleDeg(levels[i]));
+        i = (i + 1) & (levels.size() - 1);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_VuToAngleDegLut);
@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QString>
+#include <QThread>
+
+#include "StereoVUMeterWidget.h"
+
+// Frames rendered offscreen into a QImage through the widget's own paintEvent(),
+// the same code path as on screen with the raster backend.
+
+static constexpr QSize kSizes[] = {{640, 260}, {1280, 520}, {2560, 1040}};
+
+// Lets the debounced rebuilds (skin layers, needle atlas) run, so that the timed
+// frames are steady-state frames rather than the fallback paths after a resize
+static void settle(StereoVUMeterWidget& widget, QImage& target) {
+    widget.render(&target);
+    QElapsedTimer elapsed;
+    elapsed.start();
+    while (elapsed.elapsed() < 250) {
+        QCoreApplication::processEvents();
+        QThread::msleep(5);
+    }
+    widget.render(&target);
+}
+
+// Args: style (VUMeterStyle), size index, meters
+static void BM_RenderFrame(benchmark::State& state) {
+    const auto style = static_cast<VUMeterStyle>(state.range(0));
+    const QSize size = kSizes[state.range(1)];
+    const auto meters = static_cast<int>(state.range(2));
+
+    StereoVUMeterWidget widget;
+    widget.setStyle(style);
+    widget.setMeterCount(meters);
+    widget.resize(size);
+
+    QImage target(size, QImage::Format_ARGB32_Premultiplied);
+    settle(widget, target);
+
+    std::vector<float> levels(static_cast<size_t>(meters));
+    float level = -20.0f;
+    for (auto _ : state) {
+        level = level > 3.0f ? -20.0f : level + 0.73f;
+        std::fill(levels.begin(), levels.end(), level);
+        widget.setLevels(levels.data(), meters);
+        widget.render(&target);
+        benchmark::DoNotOptimize(target.constBits());
+    }
+
+    state.SetItemsProcessed(state.iterations()); // frames
+    state.SetLabel(QStringLiteral("%1x%2").arg(size.width()).arg(size.height()).toStdString());
+}
+BENCHMARK(BM_RenderFrame)
+    ->ArgNames({"style", "size", "meters"})
+    ->ArgsProduct({{static_cast<int>(VUMeterStyle::Original),
+                    static_cast<int>(VUMeterStyle::Sony),
+                    static_cast<int>(VUMeterStyle::Vintage),
+                    static_cast<int>(VUMeterStyle::Modern),
+                    static_cast<int>(VUMeterStyle::Black),
+                    static_cast<int>(VUMeterStyle::Skin)},
+                   {0, 1, 2},
+                   {2}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Meter bridges: skin mode with many meters
+BENCHMARK(BM_RenderFrame)
+    ->ArgNames({"style", "size", "meters"})
+    ->ArgsProduct({{static_cast<int>(VUMeterStyle::Skin)}, {1, 2}, {8, 32}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Args: size index; Skin mode with the needle atlas (0.25 degree steps)
+static void BM_RenderFrameNeedleAtlas(benchmark::State& state) {
+    const QSize size = kSizes[state.range(0)];
+
+    StereoVUMeterWidget widget;
+    widget.setStyle(VUMeterStyle::Skin);
+    widget.setNeedleAtlasStep(0.25f);
+    widget.resize(size);
+
+    QImage target(size, QImage::Format_ARGB32_Premultiplied);
+    settle(widget, target);
+
+    float level = -20.0f;
+    for (auto _ : state) {
+        level = level > 3.0f ? -20.0f : level + 0.73f;
+        widget.setLevels(level, level);
+        widget.render(&target);
+        benchmark::DoNotOptimize(target.constBits());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RenderFrameNeedleAtlas)->ArgName("size")->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,135 @@
+#include <benchmark/benchmark.h>
+
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "SkinCache.h"
+#include "SkinManager.h"
+#if defined(ANALOGVU_HAS_LIBZIP) && (ANALOGVU_HAS_LIBZIP == 1)
+#include "SkinImporter.h"
+#endif
+
+// Skin timings run against QStandardPaths test locations (see BenchMain.cpp), with
+// a skin package built from the embedded default skin.
+
+static const QString kSkinId = QStringLiteral("bench_702w");
+
+static bool installBenchSkin() {
+    const QDir root(SkinManager::skinsRootPath());
+    if (!root.mkpath(kSkinId))
+        return false;
+    const QDir dir(root.filePath(kSkinId));
+
+    const char* const images[] = {"0.png", "1.png", "2.png"};
+    for (const char* image : images) {
+        const QString target = dir.filePath(QLatin1String(image));
+        QFile::remove(target);
+        if (!QFile::copy(QStringLiteral(":/images/model_702w/") + QLatin1String(image), target))
+            return false;
+        QFile::setPermissions(target, QFile::ReadOwner | QFile::WriteOwner);
+    }
+
+    QJsonObject assets;
+    assets.insert(QStringLiteral("face"), QStringLiteral("0.png"));
+    assets.insert(QStringLiteral("needle"), QStringLiteral("1.png"));
+    assets.insert(QStringLiteral("cap"), QStringLiteral("2.png"));
+    QJsonObject calibration;
+    calibration.insert(QStringLiteral("minAngle"), -47);
+    calibration.insert(QStringLiteral("minLevel"), -20);
+    calibration.insert(QStringLiteral("zeroAngle"), 20);
+    calibration.insert(QStringLiteral("zeroLevel"), 0);
+    calibration.insert(QStringLiteral("maxAngle"), 47);
+    calibration.insert(QStringLiteral("maxLevel"), 3);
+    QJsonObject single;
+    single.insert(QStringLiteral("assets"), assets);
+    single.insert(QStringLiteral("calibration"), calibration);
+    QJsonObject meters;
+    meters.insert(QStringLiteral("single"), single);
+    QJsonObject skin;
+    skin.insert(QStringLiteral("name"), QStringLiteral("Benchmark 702W"));
+    skin.insert(QStringLiteral("type"), QStringLiteral("single"));
+    skin.insert(QStringLiteral("meters"), meters);
+
+    QFile json(dir.filePath(QStringLiteral("skin.json")));
+    if (!json.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    return json.write(QJsonDocument(skin).toJson()) > 0;
+}
+
+// Arg: 1 = through the compiled skin cache, 0 = parse skin.json and decode the PNGs
+static void BM_SkinLoad(benchmark::State& state) {
+    const bool compiled = state.range(0) != 0;
+    if (!installBenchSkin()) {
+        state.SkipWithError("cannot write the benchmark skin");
+        return;
+    }
+
+    // Warm-up load writes the compiled cache file
+    {
+        SkinManager warmup;
+        warmup.scan();
+        if (!warmup.loadSkin(kSkinId).ok) {
+            state.SkipWithError("benchmark skin does not load");
+            return;
+        }
+    }
+
+    for (auto _ : state) {
+        if (!compiled) {
+            state.PauseTiming();
+            QFile::remove(CompiledSkinCache::pathFor(kSkinId));
+            state.ResumeTiming();
+        }
+
+        // A fresh manager each time: its in-memory cache would make this a hash lookup
+        SkinManager manager;
+        manager.scan();
+        const SkinManager::LoadedSkin skin = manager.loadSkin(kSkinId);
+        benchmark::DoNotOptimize(skin.ok);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SkinLoad)->ArgName("compiled")->DenseRange(0, 1)->Unit(benchmark::kMillisecond);
+
+static void BM_SkinScan(benchmark::State& state) {
+    if (!installBenchSkin()) {
+        state.SkipWithError("cannot write the benchmark skin");
+        return;
+    }
+    for (auto _ : state) {
+        SkinManager manager;
+        manager.scan();
+        benchmark::DoNotOptimize(manager.availableSkins().size());
+    }
+}
+BENCHMARK(BM_SkinScan)->Unit(benchmark::kMicrosecond);
+
+#if defined(ANALOGVU_HAS_LIBZIP) && (ANALOGVU_HAS_LIBZIP == 1)
+// Imports the AIMP skin archive named by ANALOGVU_BENCH_AIMP_ZIP (no skin is bundled)
+static void BM_SkinImportAimp(benchmark::State& state) {
+    const QString zipPath = qEnvironmentVariable("ANALOGVU_BENCH_AIMP_ZIP");
+    if (zipPath.isEmpty()) {
+        state.SkipWithError("set ANALOGVU_BENCH_AIMP_ZIP to an AIMP skin .zip");
+        return;
+    }
+
+    const SkinImporter importer;
+    for (auto _ : state) {
+        const SkinImporter::ImportResult result = importer.importAimpZip(zipPath);
+
+        state.PauseTiming();
+        if (!result.ok) {
+            state.SkipWithError(result.error.toStdString().c_str());
+            break;
+        }
+        QDir(result.skinDir).removeRecursively();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SkinImportAimp)->Unit(benchmark::kMillisecond);
+#endif
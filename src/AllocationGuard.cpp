@@ -0,0 +1,67 @@
+#include "AllocationGuard.h"
+
+#if defined(ANALOGVU_ALLOCATION_GUARD) && (ANALOGVU_ALLOCATION_GUARD == 1)
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static thread_local int tGuardDepth = 0;
+static std::atomic<std::uint64_t> gViolations{0};
+
+AllocationGuard::AllocationGuard() noexcept { ++tGuardDepth; }
+
+AllocationGuard::~AllocationGuard() { --tGuardDepth; }
+
+std::uint64_t AllocationGuard::violations() noexcept { return gViolations.load(std::memory_order_relaxed); }
+
+static inline void checkGuard() noexcept {
+    if (tGuardDepth > 0) {
+        gViolations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+static void* guardedAllocate(std::size_t size) {
+    checkGuard();
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+static void guardedFree(void* p) noexcept {
+    if (p) {
+        checkGuard();
+        std::free(p);
+    }
+}
+
+// --- Replacement global allocation functions (aligned variants keep the defaults) ---
+
+void* operator new(std::size_t size) { return guardedAllocate(size); }
+
+void* operator new[](std::size_t size) { return guardedAllocate(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    checkGuard();
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    checkGuard();
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void* p) noexcept { guardedFree(p); }
+
+void operator delete[](void* p) noexcept { guardedFree(p); }
+
+void operator delete(void* p, std::size_t) noexcept { guardedFree(p); }
+
+void operator delete[](void* p, std::size_t) noexcept { guardedFree(p); }
+
+void operator delete(void* p, const std::nothrow_t&) noexcept { guardedFree(p); }
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept { guardedFree(p); }
+
+#endif // ANALOGVU_ALLOCATION_GUARD
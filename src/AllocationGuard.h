@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+// Debug check that the audio path does not allocate.
+//
+// In builds with ANALOGVU_ALLOCATION_GUARD=1 (Debug by default) the global
+// operator new/delete are replaced, and every allocation or deallocation made
+// while an AllocationGuard is alive on the calling thread is counted as a
+// violation. Otherwise the guard compiles to nothing.
+#if defined(ANALOGVU_ALLOCATION_GUARD) && (ANALOGVU_ALLOCATION_GUARD == 1)
+
+class AllocationGuard final {
+  public:
+    AllocationGuard() noexcept;
+    ~AllocationGuard();
+
+    AllocationGuard(const AllocationGuard&) = delete;
+    AllocationGuard& operator=(const AllocationGuard&) = delete;
+
+    // Violations in the whole process since startup
+    static std::uint64_t violations() noexcept;
+    static constexpr bool enabled() { return true; }
+};
+
+#else
+
+class AllocationGuard final {
+  public:
+    // User-provided so that unused-variable warnings treat the guard like the real one
+    AllocationGuard() noexcept {}
+    ~AllocationGuard() {}
+
+    AllocationGuard(const AllocationGuard&) = delete;
+    AllocationGuard& operator=(const AllocationGuard&) = delete;
+
+    static std::uint64_t violations() noexcept { return 0; }
+    static constexpr bool enabled() { return false; }
+};
+
+#endif
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "PerfCounters.h"
+
+// Watchdog counters of one capture's audio callback.
+//
+// record() is called by the audio thread at the end of every callback with the time
+// the callback took and the audio it handled: a callback that runs longer than the
+// audio it consumed cannot keep up in real time and counts as a deadline miss.
+// Readers on other threads see relaxed snapshots. The same numbers also go to the
+// process-wide PerfCounters while those are enabled.
+class AudioCallbackMetrics final {
+  public:
+    void record(std::int64_t durationNs, std::int64_t budgetNs) noexcept {
+        callbacks_.fetch_add(1, std::memory_order_relaxed);
+        if (durationNs > worstNs_.load(std::memory_order_relaxed)) {
+            worstNs_.store(durationNs, std::memory_order_relaxed); // single writer
+        }
+        if (budgetNs > 0 && durationNs > budgetNs) {
+            deadlineMisses_.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (PerfCounters::enabled()) {
+            PerfCounters::record(PerfCounters::Histogram::AudioCallback, durationNs);
+            PerfCounters::record(PerfCounters::Histogram::AudioBlock, budgetNs);
+        }
+    }
+
+    void setRealtime(bool realtime) noexcept { realtime_.store(realtime, std::memory_order_relaxed); }
+
+    std::uint64_t callbacks() const noexcept { return callbacks_.load(std::memory_order_relaxed); }
+    std::int64_t worstNs() const noexcept { return worstNs_.load(std::memory_order_relaxed); }
+    std::uint64_t deadlineMisses() const noexcept { return deadlineMisses_.load(std::memory_order_relaxed); }
+    bool realtime() const noexcept { return realtime_.load(std::memory_order_relaxed); }
+
+  private:
+    std::atomic<std::uint64_t> callbacks_{0};
+    std::atomic<std::int64_t> worstNs_{0};
+    std::atomic<std::uint64_t> deadlineMisses_{0};
+    std::atomic<bool> realtime_{false};
+};
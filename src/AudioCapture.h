@@ -4,22 +4,38 @@
 #include <QObject>
 #include <QString>
 
+#include <array>
 #include <atomic>
-#include <thread>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
 
+#include "AudioCallbackMetrics.h"
+#include "CaptureIdleState.h"
+#include "LevelRingBuffer.h"
 #include "VUBallistics.h"
+#include "VuAudioDsp.h"
 
 #if defined(__APPLE__)
 // Forward declarations for CoreAudio types
-struct AudioQueueBuffer;
-typedef struct OpaqueAudioQueue* AudioQueueRef;
+struct AudioBufferList;
+struct AudioObjectPropertyAddress;
+struct AudioTimeStamp;
+#elif defined(ANALOGVU_HAS_PIPEWIRE) && (ANALOGVU_HAS_PIPEWIRE == 1)
+// Forward declarations for PipeWire types
+class PipeWireConnection;
 #else
 // Forward declarations for PulseAudio types
-struct pa_mainloop;
+class PulseConnection;
 struct pa_context;
+struct pa_operation;
 struct pa_stream;
 struct pa_sink_info;
 struct pa_source_info;
+struct pa_sample_spec;
+struct pa_channel_map;
 #endif
 
 class AudioCapture final : public QObject {
@@ -33,6 +49,8 @@ class AudioCapture final : public QObject {
         int channels = 0;    // Number of channels
         bool isInput = true; // true for input devices, false for output
         bool isDefault = false;
+
+        bool operator==(const DeviceInfo&) const = default;
     };
 
     struct Options final {
@@ -40,13 +58,45 @@ class AudioCapture final : public QObject {
         double referenceDbfs = -18.0;
         bool referenceDbfsOverride = false;
         int sampleRate = 48000;
-        unsigned long framesPerBuffer = 512;
+        unsigned long framesPerBuffer = 512; // unused: macOS captures at the device's own buffer size
 
         // Optional: override device name (sink or source on Linux, device UID on macOS)
         QString deviceName;
 
         // 0 = sink monitor/system output, 1 = source/microphone
         int deviceType = 0;
+
+        // Run RMS and ballistics at this fixed rate, independent of the capture buffer size
+        // (0 = advance once per captured buffer)
+        double controlRateHz = 0.0;
+
+        // Run the audio callbacks with realtime priority: SCHED_FIFO or rtkit on Linux
+        // (failure is not fatal). The macOS HAL IO thread is always realtime.
+        bool realtime = false;
+
+        // Needle micro-jitter; disable or seed it for reproducible levels
+        VuJitterOptions jitter;
+
+        // Meter type: VU timing or a peak programme meter, see vuBallisticsPreset()
+        VuBallisticsProfile ballistics;
+
+        // Seconds of silence, with the needles at rest, before the capture goes idle and
+        // asks for larger blocks (0 = never). The first loud block wakes it again.
+        double idleAfterSeconds = 3.0;
+    };
+
+    // Stream health counters, cumulative over the lifetime of the capture
+    struct CaptureStats final {
+        std::uint64_t holes = 0;         // gaps in the captured data (nothing was recorded there)
+        std::uint64_t overflows = 0;     // capture buffer overruns: audio was lost before we read it
+        std::uint64_t droppedLevels = 0; // level samples the UI did not drain in time
+
+        // --- Audio callback watchdog ---
+        std::uint64_t callbacks = 0;
+        std::int64_t worstCallbackNs = 0;
+        std::uint64_t deadlineMisses = 0;       // callbacks that took longer than the audio they handled
+        bool realtime = false;                  // the callback thread runs with realtime priority
+        std::uint64_t allocationViolations = 0; // process-wide; only counted with ANALOGVU_ALLOCATION_GUARD
     };
 
     explicit AudioCapture(const Options& options, QObject* parent = nullptr);
@@ -55,9 +105,15 @@ class AudioCapture final : public QObject {
     bool start(QString* errorOut = nullptr);
     void stop();
 
-    // Switch to a different audio device at runtime
+    // Switch to a different audio device at runtime (stops, then restarts the capture)
     bool switchDevice(const QString& deviceUID, QString* errorOut = nullptr);
 
+    // Switches without a gap: the new device's stream is opened while the current one
+    // keeps metering, and takes over the ballistics once it delivers audio. Returns at
+    // once; deviceChanged() reports completion, errorOccurred() a failed switch (the
+    // current device then stays active). A newer request replaces a pending one.
+    bool switchDeviceAsync(const QString& deviceUID, QString* errorOut = nullptr);
+
     // Get the currently active device UID
     QString currentDeviceUID() const;
 
@@ -65,11 +121,25 @@ class AudioCapture final : public QObject {
     double referenceDbfs() const;
     void setReferenceDbfs(double value);
 
+    // Meter dynamics; may be changed while running, the audio thread picks it up with
+    // its next block and the needles carry on from where they are
+    VuBallisticsProfile ballisticsProfile() const;
+    void setBallisticsProfile(const VuBallisticsProfile& profile);
+
     float leftVuDb() const;
     float rightVuDb() const;
 
-    // Get list of available input devices (for UI)
-    static QList<DeviceInfo> enumerateInputDevices();
+    // Every channel of the captured stream is metered (up to kVuMaxChannels)
+    unsigned int channelCount() const;
+    float channelVuDb(unsigned int channel) const;
+
+    CaptureStats stats() const;
+
+    // Silent with the needles at rest (see Options::idleAfterSeconds); any thread
+    bool isIdle() const { return idleState_.idle(); }
+
+    // Timestamped levels, one entry per processed block. Single consumer (the UI thread).
+    LevelRingBuffer& levelRing() { return levelRing_; }
 
     // Legacy: string output for command line
     static QString listDevicesString();
@@ -80,51 +150,150 @@ class AudioCapture final : public QObject {
 
   private:
 #if defined(__APPLE__)
-    // CoreAudio callback
-    static void audioInputCallback(void* inUserData,
-                                   AudioQueueRef inAQ,
-                                   AudioQueueBuffer* inBuffer,
-                                   const void* inStartTime,
-                                   unsigned int inNumberPacketDescriptions,
-                                   const void* inPacketDescs);
-
-    void processAudioBuffer(const float* data, unsigned int frames, unsigned int channels, float sampleRate);
+    // CoreAudio HAL callbacks: the IOProc runs on the device's IO thread, the
+    // property listener on a HAL notification thread
+    static std::int32_t deviceIOProc(std::uint32_t inDevice,
+                                     const AudioTimeStamp* inNow,
+                                     const AudioBufferList* inInputData,
+                                     const AudioTimeStamp* inInputTime,
+                                     AudioBufferList* outOutputData,
+                                     const AudioTimeStamp* inOutputTime,
+                                     void* inClientData);
+    static std::int32_t devicePropertyListener(std::uint32_t inObjectID,
+                                               std::uint32_t inNumberAddresses,
+                                               const AudioObjectPropertyAddress* inAddresses,
+                                               void* inClientData);
+    using DeviceIOProcId = decltype(&AudioCapture::deviceIOProc);
+
+    // One device with its IOProc. A switch runs two until the new one delivers audio.
+    struct DeviceStream {
+        AudioCapture* owner = nullptr;
+        std::uint32_t device = 0; // kAudioObjectUnknown
+        DeviceIOProcId ioProc = nullptr;
+        QString uid;
+
+        // Nominal device rate: written by the property listener, read by the IOProc
+        std::atomic<float> sampleRate{0.0f};
+
+        // Sized for one hardware buffer when opened; larger blocks are metered in pieces
+        std::vector<float> interleaveScratch;
+    };
+
+    bool openDevice(DeviceStream& slot, const QString& uid, QString* errorOut);
+    void closeDevice(DeviceStream& slot);
+    void removeDeviceListeners(DeviceStream& slot);
+
+    // GUI thread, after a handover: stops the retired device and reports the switch
+    void retireDevices();
+
+    // Interleaves a multi-buffer block (non-interleaved or aggregate devices) and meters it
+    void processBufferList(const AudioBufferList& buffers,
+                           unsigned int frames,
+                           unsigned int channels,
+                           float sampleRate,
+                           std::int64_t blockEndNs,
+                           std::vector<float>& scratch);
+#elif defined(ANALOGVU_HAS_PIPEWIRE) && (ANALOGVU_HAS_PIPEWIRE == 1)
+    // pw_stream event handlers and per-stream state, defined next to the backend
+    struct PipeWireEvents;
+    struct PipeWireStream;
+
+    // With the loop lock held
+    bool connectStream(PipeWireStream& slot, const QString& deviceName, int deviceType, QString* errorOut);
+    void destroyStream(PipeWireStream& slot);
 #else
-    // PulseAudio callbacks
-    static void context_state_callback(pa_context* c, void* userdata);
+    // Looks up the configured sink/source; the info callbacks then create the stream
+    void requestDeviceInfo(const QString& deviceName, int deviceType);
+    pa_stream* connectStream(const pa_sample_spec& spec, const pa_channel_map& map, const char* sourceName);
+    void onDeviceInfo(const pa_sample_spec& spec, const pa_channel_map& map, const char* sourceName);
+    void resetStreamState(unsigned int channels);
+
+    // Device switching: retires stream_ in favour of nextStream_ (mainloop thread)
+    void promoteNextStream();
+    void abandonSwitch(const QString& reason);
+    static void releaseStream(pa_stream*& stream);
+
+    // Requests the fragment size of the current idle state on the active stream
+    void applyIdleFragments(pa_stream* s);
+
+    // Feeds one peeked fragment to the DSP in place, carrying a split frame over to the next one
+    void consumeFragment(pa_stream* s, const unsigned char* data, size_t bytes);
+    void skipHole(size_t bytes);
+
+    // PulseAudio callbacks (run on the shared mainloop thread with its lock held)
     static void sink_info_callback(pa_context* c, const pa_sink_info* si, int is_last, void* userdata);
     static void source_info_callback(pa_context* c, const pa_source_info* si, int is_last, void* userdata);
     static void stream_state_callback(pa_stream* s, void* userdata);
     static void stream_read_callback(pa_stream* s, size_t length, void* userdata);
+    static void stream_overflow_callback(pa_stream* s, void* userdata);
 #endif
 
+    // Runs the meter DSP on one block and publishes the levels (audio thread)
+    void processAudioBuffer(
+        const float* data, unsigned int frames, unsigned int channels, float sampleRate, std::int64_t blockEndNs);
+
   private:
     Options options_;
     QString currentDeviceUID_;
 
-    std::atomic<float> leftVuDb_{-22.0f};
-    std::atomic<float> rightVuDb_{-22.0f};
+    // Read by the audio thread on every block; Options is only touched while stopped
+    std::atomic<double> referenceDbfs_;
+    std::atomic<bool> referenceDbfsOverride_;
+
+    // Ballistics handoff: the audio thread only try_locks, and only when the version moved
+    mutable std::mutex ballisticsMutex_;
+    VuBallisticsProfile pendingBallistics_;
+    std::atomic<unsigned int> ballisticsVersion_{0};
+    unsigned int appliedBallisticsVersion_ = 0; // audio thread only
+
+    std::array<std::atomic<float>, kVuMaxChannels> channelVuDb_;
+    std::atomic<unsigned int> channelCount_{0};
+    LevelRingBuffer levelRing_;
+
+    // Meter DSP state (audio thread only)
+    VuAudioDspState dspState_;
+    std::vector<float> vuScratch_;
 
     std::atomic<bool> running_{false};
 
+    std::atomic<std::uint64_t> holes_{0};
+    std::atomic<std::uint64_t> overflows_{0};
+    AudioCallbackMetrics callbackMetrics_;
+    bool realtimeChecked_ = false; // audio thread only; reset for every new stream
+
+    CaptureIdleState idleState_;
+    bool idleChanged_ = false; // audio thread only; the Linux backends then resize their blocks
+
 #if defined(__APPLE__)
-    AudioQueueRef audioQueue_ = nullptr;
-    static constexpr int kNumBuffers = 3;
-    AudioQueueBuffer* buffers_[kNumBuffers] = {};
-
-    // Smoothed RMS values (persistent across callbacks)
-    float rmsL_smooth_ = 0.0f;
-    float rmsR_smooth_ = 0.0f;
-    float prevL_ = 0.0f;
-    float prevR_ = 0.0f;
-    bool meterAwake_ = false;
+    // Only activeDevice_ feeds the DSP; incomingDevice_ replaces it with its first buffer
+    std::array<DeviceStream, 2> devices_;
+    std::atomic<DeviceStream*> activeDevice_{nullptr};
+    std::atomic<DeviceStream*> incomingDevice_{nullptr};
+    std::atomic_flag dspBusy_ = ATOMIC_FLAG_INIT;
+#elif defined(ANALOGVU_HAS_PIPEWIRE) && (ANALOGVU_HAS_PIPEWIRE == 1)
+    std::shared_ptr<PipeWireConnection> pipewire_;
+
+    // Two slots, so that a device switch can connect the new stream next to the
+    // running one. Only activeStream_ feeds the DSP; incomingStream_ replaces it
+    // with its first buffer.
+    std::array<std::unique_ptr<PipeWireStream>, 2> streams_;
+    std::atomic<PipeWireStream*> activeStream_{nullptr};
+    std::atomic<PipeWireStream*> incomingStream_{nullptr};
+    std::atomic_flag dspBusy_ = ATOMIC_FLAG_INIT;
 #else
-    std::thread thread_;
-    pa_mainloop* mainloop_ = nullptr;
-    pa_context* context_ = nullptr;
+    std::shared_ptr<PulseConnection> pulse_;
+    pa_operation* infoOp_ = nullptr;
     pa_stream* stream_ = nullptr;
-#endif
 
-    VUBallistics ballisticsL_;
-    VUBallistics ballisticsR_;
+    // Incoming stream of a device switch; runs next to stream_ until its first data
+    pa_stream* nextStream_ = nullptr;
+    QString nextDeviceUID_;
+    bool switchPending_ = false;
+
+    // Fragments need not end on a frame (or even a sample) boundary
+    std::array<float, kVuMaxChannels> partialFrame_{};
+    size_t partialBytes_ = 0;
+    size_t skipBytes_ = 0; // realigns the stream to a frame after a hole
+    std::vector<float> unalignedScratch_;
+#endif
 };
@@ -1,9 +1,13 @@
 #if defined(__linux__)
 
+#include "AllocationGuard.h"
 #include "AudioCapture.h"
+#include "PulseConnection.h"
+#include "RealtimeThread.h"
 #include "VuAudioDsp.h"
 
-#include <thread>
+#include <algorithm>
+#include <cstring>
 
 #include <QByteArray>
 #include <QPair>
@@ -12,9 +16,19 @@
 static constexpr float kAudioFloorVu = -96.0f;
 static constexpr float kAudioCeilingVu = 6.0f;
 
+// Capture fragment size: short for a responsive needle, ten times longer while idle
+static constexpr pa_usec_t kFragmentUs = 10 * PA_USEC_PER_MSEC;
+static constexpr pa_usec_t kIdleFragmentUs = 100 * PA_USEC_PER_MSEC;
+
 AudioCapture::AudioCapture(const Options& options, QObject* parent)
-    : QObject(parent), options_(options), currentDeviceUID_(options.deviceName), ballisticsL_(kAudioFloorVu),
-      ballisticsR_(kAudioFloorVu) {}
+    : QObject(parent), options_(options), currentDeviceUID_(options.deviceName),
+      referenceDbfs_(options.referenceDbfs), referenceDbfsOverride_(options.referenceDbfsOverride),
+      pendingBallistics_(options.ballistics), dspState_(options.jitter, options.ballistics) {
+    for (auto& vu : channelVuDb_) {
+        vu.store(kAudioFloorVu, std::memory_order_relaxed);
+    }
+    idleState_.setHoldNs(static_cast<std::int64_t>(options.idleAfterSeconds * 1'000'000'000.0));
+}
 
 AudioCapture::~AudioCapture() { stop(); }
 
@@ -23,47 +37,23 @@ bool AudioCapture::start(QString* errorOut) {
         return true;
     }
 
-    // Initialize PulseAudio mainloop and context
-    mainloop_ = pa_mainloop_new();
-    if (!mainloop_) {
-        if (errorOut) {
-            *errorOut = QStringLiteral("Failed to create PulseAudio mainloop");
-        }
-        running_.store(false, std::memory_order_relaxed);
-        return false;
-    }
-
-    context_ = pa_context_new(pa_mainloop_get_api(mainloop_), "Analog VU Meter");
-    if (!context_) {
-        if (errorOut) {
-            *errorOut = QStringLiteral("Failed to create PulseAudio context");
-        }
-        pa_mainloop_free(mainloop_);
-        mainloop_ = nullptr;
+    // Every capture shares the process-wide PulseAudio connection and its mainloop thread
+    pulse_ = PulseConnection::acquire(errorOut);
+    if (!pulse_) {
         running_.store(false, std::memory_order_relaxed);
         return false;
     }
 
-    pa_context_set_state_callback(context_, &AudioCapture::context_state_callback, this);
-
-    int connect_result = pa_context_connect(context_, nullptr, PA_CONTEXT_NOFLAGS, nullptr);
-    if (connect_result < 0) {
-        if (errorOut) {
-            *errorOut = QStringLiteral("Failed to connect to PulseAudio: %1").arg(pa_strerror(connect_result));
+    if (options_.realtime) {
+        QString realtimeError;
+        if (!pulse_->makeRealtime(&realtimeError)) {
+            qWarning("AudioCapture: realtime scheduling unavailable: %s", qPrintable(realtimeError));
         }
-        pa_context_unref(context_);
-        context_ = nullptr;
-        pa_mainloop_free(mainloop_);
-        mainloop_ = nullptr;
-        running_.store(false, std::memory_order_relaxed);
-        return false;
     }
 
-    // Start the PulseAudio mainloop in a separate thread, but with simple synchronization
-    thread_ = std::thread([this]() {
-        int ret = 0;
-        pa_mainloop_run(mainloop_, &ret);
-    });
+    PulseConnection::Lock lock(*pulse_);
+    switchPending_ = false;
+    requestDeviceInfo(options_.deviceName, options_.deviceType);
 
     if (errorOut) {
         *errorOut = QString();
@@ -76,39 +66,39 @@ void AudioCapture::stop() {
         return;
     }
 
-    if (mainloop_) {
-        pa_mainloop_quit(mainloop_, 0);
+    if (!pulse_) {
+        return;
     }
 
-    if (thread_.joinable()) {
-        thread_.join();
-    }
+    {
+        // Callbacks run with this lock held, so none of ours is in flight once we own it
+        PulseConnection::Lock lock(*pulse_);
 
-    if (stream_) {
-        pa_stream_disconnect(stream_);
-        pa_stream_unref(stream_);
-        stream_ = nullptr;
-    }
-    if (context_) {
-        pa_context_disconnect(context_);
-        pa_context_unref(context_);
-        context_ = nullptr;
-    }
-    if (mainloop_) {
-        pa_mainloop_free(mainloop_);
-        mainloop_ = nullptr;
+        if (infoOp_) {
+            if (pa_operation_get_state(infoOp_) == PA_OPERATION_RUNNING) {
+                pa_operation_cancel(infoOp_);
+            }
+            pa_operation_unref(infoOp_);
+            infoOp_ = nullptr;
+        }
+
+        releaseStream(stream_);
+        releaseStream(nextStream_);
+        switchPending_ = false;
     }
+
+    pulse_.reset();
 }
 
 bool AudioCapture::switchDevice(const QString& deviceUID, QString* errorOut) {
     // Stop current capture
     stop();
 
-    // Reset ballistics
-    ballisticsL_.reset(kAudioFloorVu);
-    ballisticsR_.reset(kAudioFloorVu);
-    leftVuDb_.store(kAudioFloorVu, std::memory_order_relaxed);
-    rightVuDb_.store(kAudioFloorVu, std::memory_order_relaxed);
+    // Reset ballistics and smoothed values
+    dspState_ = VuAudioDspState(options_.jitter, ballisticsProfile());
+    for (auto& vu : channelVuDb_) {
+        vu.store(kAudioFloorVu, std::memory_order_relaxed);
+    }
 
     // Update options with new device
     options_.deviceName = deviceUID;
@@ -124,102 +114,83 @@ bool AudioCapture::switchDevice(const QString& deviceUID, QString* errorOut) {
     return success;
 }
 
-QString AudioCapture::currentDeviceUID() const { return currentDeviceUID_; }
-
-double AudioCapture::referenceDbfs() const { return options_.referenceDbfs; }
-
-void AudioCapture::setReferenceDbfs(double value) {
-    options_.referenceDbfs = value;
-    options_.referenceDbfsOverride = true;
-}
-
-float AudioCapture::leftVuDb() const { return leftVuDb_.load(std::memory_order_relaxed); }
-
-float AudioCapture::rightVuDb() const { return rightVuDb_.load(std::memory_order_relaxed); }
-
-QList<AudioCapture::DeviceInfo> AudioCapture::enumerateInputDevices() {
-    QList<DeviceInfo> result;
-
-    // Temporary mainloop + context for enumeration
-    pa_mainloop* ml = pa_mainloop_new();
-    if (!ml)
-        return result;
-
-    pa_context* ctx = pa_context_new(pa_mainloop_get_api(ml), "VU Meter Device List");
-    if (!ctx) {
-        pa_mainloop_free(ml);
-        return result;
+bool AudioCapture::switchDeviceAsync(const QString& deviceUID, QString* errorOut) {
+    if (!running_.load(std::memory_order_relaxed) || !pulse_) {
+        // Nothing is metering, so there is no gap to avoid
+        return switchDevice(deviceUID, errorOut);
     }
 
-    bool ready = false;
-    int ret = 0;
-
-    auto ctx_state_cb = [](pa_context* c, void* userdata) {
-        auto* flag = static_cast<bool*>(userdata);
-        pa_context_state_t st = pa_context_get_state(c);
-        if (st == PA_CONTEXT_READY || st == PA_CONTEXT_FAILED || st == PA_CONTEXT_TERMINATED)
-            *flag = true;
-    };
-
-    pa_context_set_state_callback(ctx, ctx_state_cb, &ready);
-    pa_context_connect(ctx, nullptr, PA_CONTEXT_NOFLAGS, nullptr);
+    PulseConnection::Lock lock(*pulse_);
 
-    while (!ready)
-        pa_mainloop_iterate(ml, 1, &ret);
+    if (infoOp_) {
+        if (pa_operation_get_state(infoOp_) == PA_OPERATION_RUNNING) {
+            pa_operation_cancel(infoOp_);
+        }
+        pa_operation_unref(infoOp_);
+        infoOp_ = nullptr;
+    }
+    releaseStream(nextStream_);
+
+    // Menu entries are source names, sink monitors included
+    switchPending_ = true;
+    nextDeviceUID_ = deviceUID;
+    requestDeviceInfo(deviceUID, 1);
+    if (!infoOp_) {
+        switchPending_ = false; // reported by requestDeviceInfo
+    }
 
-    if (pa_context_get_state(ctx) != PA_CONTEXT_READY) {
-        pa_context_disconnect(ctx);
-        pa_context_unref(ctx);
-        pa_mainloop_free(ml);
-        return result;
+    if (errorOut) {
+        *errorOut = QString();
     }
+    return true;
+}
 
-    // Get default source
-    QString defaultSource;
-    auto server_cb = [](pa_context*, const pa_server_info* info, void* userdata) {
-        auto* defSource = static_cast<QString*>(userdata);
-        *defSource = QString::fromUtf8(info->default_source_name);
-    };
+QString AudioCapture::currentDeviceUID() const { return currentDeviceUID_; }
 
-    pa_operation* op0 = pa_context_get_server_info(ctx, server_cb, &defaultSource);
-    while (pa_operation_get_state(op0) == PA_OPERATION_RUNNING)
-        pa_mainloop_iterate(ml, 1, &ret);
-    pa_operation_unref(op0);
+double AudioCapture::referenceDbfs() const { return referenceDbfs_.load(std::memory_order_relaxed); }
 
-    // Enumerate sources
-    struct SourceListContext {
-        QList<DeviceInfo>* result;
-        QString defaultName;
-    };
+void AudioCapture::setReferenceDbfs(double value) {
+    options_.referenceDbfs = value;
+    options_.referenceDbfsOverride = true;
+    referenceDbfs_.store(value, std::memory_order_relaxed);
+    referenceDbfsOverride_.store(true, std::memory_order_relaxed);
+}
 
-    auto source_cb = [](pa_context*, const pa_source_info* info, int eol, void* userdata) {
-        if (eol > 0 || !info)
-            return;
+VuBallisticsProfile AudioCapture::ballisticsProfile() const {
+    std::lock_guard<std::mutex> lock(ballisticsMutex_);
+    return pendingBallistics_;
+}
 
-        auto* ctx = static_cast<SourceListContext*>(userdata);
+void AudioCapture::setBallisticsProfile(const VuBallisticsProfile& profile) {
+    std::lock_guard<std::mutex> lock(ballisticsMutex_);
+    pendingBallistics_ = profile;
+    ballisticsVersion_.fetch_add(1, std::memory_order_release);
+}
 
-        DeviceInfo device;
-        device.name = QString::fromUtf8(info->description);
-        device.uid = QString::fromUtf8(info->name);
-        device.channels = static_cast<int>(info->sample_spec.channels);
-        device.isInput = true;
-        device.isDefault = (QString::fromUtf8(info->name) == ctx->defaultName);
+float AudioCapture::leftVuDb() const { return channelVuDb(0); }
 
-        ctx->result->append(device);
-    };
+float AudioCapture::rightVuDb() const { return channelVuDb(channelCount() > 1 ? 1 : 0); }
 
-    SourceListContext sourceCtx{&result, defaultSource};
-    pa_operation* op1 = pa_context_get_source_info_list(ctx, source_cb, &sourceCtx);
-    while (pa_operation_get_state(op1) == PA_OPERATION_RUNNING)
-        pa_mainloop_iterate(ml, 1, &ret);
-    pa_operation_unref(op1);
+unsigned int AudioCapture::channelCount() const { return channelCount_.load(std::memory_order_relaxed); }
 
-    // Cleanup
-    pa_context_disconnect(ctx);
-    pa_context_unref(ctx);
-    pa_mainloop_free(ml);
+float AudioCapture::channelVuDb(unsigned int channel) const {
+    if (channel >= kVuMaxChannels) {
+        return kAudioFloorVu;
+    }
+    return channelVuDb_[channel].load(std::memory_order_relaxed);
+}
 
-    return result;
+AudioCapture::CaptureStats AudioCapture::stats() const {
+    CaptureStats stats;
+    stats.holes = holes_.load(std::memory_order_relaxed);
+    stats.overflows = overflows_.load(std::memory_order_relaxed);
+    stats.droppedLevels = levelRing_.droppedCount();
+    stats.callbacks = callbackMetrics_.callbacks();
+    stats.worstCallbackNs = callbackMetrics_.worstNs();
+    stats.deadlineMisses = callbackMetrics_.deadlineMisses();
+    stats.realtime = callbackMetrics_.realtime();
+    stats.allocationViolations = AllocationGuard::violations();
+    return stats;
 }
 
 QString AudioCapture::listDevicesString() {
@@ -357,56 +328,209 @@ QString AudioCapture::listDevicesString() {
     return out;
 }
 
-// -------- PulseAudio callbacks --------
+void AudioCapture::processAudioBuffer(
+    const float* data, unsigned int frames, unsigned int channels, float sampleRate, std::int64_t blockEndNs) {
+    VuReferenceOptions ref;
+    ref.referenceDbfs = referenceDbfs_.load(std::memory_order_relaxed);
+    ref.referenceDbfsOverride = referenceDbfsOverride_.load(std::memory_order_relaxed);
+    ref.deviceType = options_.deviceType;
+
+    if (vuScratch_.size() != channels || dspState_.channels != channels) {
+        // Sized when the stream is set up; this only catches format changes
+        vuScratch_.resize(channels);
+        dspState_.configure(channels, kAudioFloorVu);
+    }
 
-void AudioCapture::stream_read_callback(pa_stream* s, size_t length, void* userdata) {
-    auto* self = static_cast<AudioCapture*>(userdata);
-    const void* p = nullptr;
+    // A profile change is picked up by a later block if the GUI thread holds the lock
+    const unsigned int ballisticsVersion = ballisticsVersion_.load(std::memory_order_acquire);
+    if (ballisticsVersion != appliedBallisticsVersion_) {
+        std::unique_lock<std::mutex> lock(ballisticsMutex_, std::try_to_lock);
+        if (lock.owns_lock()) {
+            dspState_.setBallisticsProfile(pendingBallistics_);
+            appliedBallisticsVersion_ = ballisticsVersion;
+        }
+    }
 
-    if (pa_stream_peek(s, &p, &length) < 0 || !p || length == 0) {
-        return;
+    // Nothing below may allocate: it runs on the (possibly realtime) audio thread
+    AllocationGuard allocationGuard;
+
+    if (options_.controlRateHz > 0.0) {
+        processInterleavedFloatAudioToVuDbFixedRate(data,
+                                                    frames,
+                                                    channels,
+                                                    sampleRate,
+                                                    static_cast<float>(options_.controlRateHz),
+                                                    ref,
+                                                    dspState_,
+                                                    kAudioFloorVu,
+                                                    kAudioCeilingVu,
+                                                    vuScratch_.data());
+    } else {
+        processInterleavedFloatAudioToVuDb(
+            data, frames, channels, sampleRate, ref, dspState_, kAudioFloorVu, kAudioCeilingVu, vuScratch_.data());
+    }
+
+    LevelSample sample;
+    sample.timeNs = blockEndNs;
+    sample.channels = std::min(channels, kVuMaxChannels);
+    for (unsigned int c = 0; c < sample.channels; ++c) {
+        sample.vu[c] = vuScratch_[c];
+        sample.peakDbfs[c] = dspState_.peakDbfs[c];
+        channelVuDb_[c].store(vuScratch_[c], std::memory_order_relaxed);
+    }
+    channelCount_.store(sample.channels, std::memory_order_relaxed);
+    levelRing_.push(sample);
+
+    const auto blockNs = static_cast<std::int64_t>(static_cast<double>(frames) * 1e9 / sampleRate);
+    if (idleState_.update(dspState_, vuScratch_.data(), sample.channels, blockNs)) {
+        idleChanged_ = true;
     }
+}
+
+// -------- PulseAudio callbacks --------
+
+// Capture time of the last frame of a fragment starting at the stream's read index.
+// That is the oldest buffered audio: its last frame was captured (stream latency -
+// fragment duration) ago.
+static std::int64_t fragmentEndTimeNs(pa_stream* s, const pa_sample_spec& ss, size_t bytes) {
+    std::int64_t endNs = levelClockNowNs();
+    pa_usec_t latencyUs = 0;
+    int negative = 0;
+    if (pa_stream_get_latency(s, &latencyUs, &negative) == 0 && !negative) {
+        const std::int64_t fragmentNs = static_cast<std::int64_t>(pa_bytes_to_usec(bytes, &ss)) * 1000;
+        endNs -= std::max<std::int64_t>(0, static_cast<std::int64_t>(latencyUs) * 1000 - fragmentNs);
+    }
+    return endNs;
+}
 
-    const float* data = static_cast<const float*>(p);
+void AudioCapture::consumeFragment(pa_stream* s, const unsigned char* data, size_t bytes) {
     const pa_sample_spec* ss = pa_stream_get_sample_spec(s);
     if (!ss || ss->channels < 1) {
-        pa_stream_drop(s);
         return;
     }
 
     const unsigned int channels = ss->channels;
-    const unsigned int samples = static_cast<unsigned int>(length / sizeof(float));
-    const unsigned int frames = samples / channels;
-    if (frames == 0) {
-        pa_stream_drop(s);
+    const size_t frameBytes = channels * sizeof(float);
+    const float sampleRate = static_cast<float>(ss->rate);
+    const std::int64_t endNs = fragmentEndTimeNs(s, *ss, bytes);
+
+    if (skipBytes_ > 0) {
+        const size_t n = std::min(skipBytes_, bytes);
+        skipBytes_ -= n;
+        data += n;
+        bytes -= n;
+    }
+
+    // Complete a frame split by the previous fragment; it is the only data copied
+    if (partialBytes_ > 0 && bytes > 0) {
+        const size_t n = std::min(frameBytes - partialBytes_, bytes);
+        std::memcpy(reinterpret_cast<unsigned char*>(partialFrame_.data()) + partialBytes_, data, n);
+        partialBytes_ += n;
+        data += n;
+        bytes -= n;
+
+        if (partialBytes_ == frameBytes) {
+            const std::int64_t frameEndNs = endNs - static_cast<std::int64_t>(pa_bytes_to_usec(bytes, ss)) * 1000;
+            processAudioBuffer(partialFrame_.data(), 1, channels, sampleRate, frameEndNs);
+            partialBytes_ = 0;
+        }
+    }
+
+    const size_t frames = bytes / frameBytes;
+    if (frames > 0) {
+        const float* samples = nullptr;
+        if (reinterpret_cast<std::uintptr_t>(data) % alignof(float) == 0) {
+            samples = reinterpret_cast<const float*>(data); // run the DSP on PulseAudio's memory
+        } else {
+            // A fragment boundary inside a sample leaves the rest misaligned for float loads
+            const size_t count = frames * channels;
+            if (unalignedScratch_.size() < count) {
+                unalignedScratch_.resize(count);
+            }
+            std::memcpy(unalignedScratch_.data(), data, count * sizeof(float));
+            samples = unalignedScratch_.data();
+        }
+        processAudioBuffer(samples, static_cast<unsigned int>(frames), channels, sampleRate, endNs);
+    }
+
+    const size_t tail = bytes - frames * frameBytes;
+    if (tail > 0) {
+        std::memcpy(partialFrame_.data(), data + frames * frameBytes, tail);
+        partialBytes_ = tail;
+    }
+}
+
+void AudioCapture::skipHole(size_t bytes) {
+    holes_.fetch_add(1, std::memory_order_relaxed);
+
+    const pa_sample_spec* ss = pa_stream_get_sample_spec(stream_);
+    if (!ss || ss->channels < 1) {
         return;
     }
 
-    static VuAudioDspState dspState;
-    VuReferenceOptions ref;
-    ref.referenceDbfs = self->options_.referenceDbfs;
-    ref.referenceDbfsOverride = self->options_.referenceDbfsOverride;
-    ref.deviceType = self->options_.deviceType;
-
-    float vuL = kAudioFloorVu;
-    float vuR = kAudioFloorVu;
-    processInterleavedFloatAudioToVuDb(data,
-                                        frames,
-                                        channels,
-                                        static_cast<float>(ss->rate),
-                                        ref,
-                                        self->ballisticsL_,
-                                        self->ballisticsR_,
-                                        dspState,
-                                        kAudioFloorVu,
-                                        kAudioCeilingVu,
-                                        vuL,
-                                        vuR);
-
-    self->leftVuDb_.store(vuL, std::memory_order_relaxed);
-    self->rightVuDb_.store(vuR, std::memory_order_relaxed);
-
-    pa_stream_drop(s);
+    // Nothing was recorded in the hole: drop the split frame and skip forward to the
+    // next frame boundary, which may lie inside the following fragment
+    const size_t frameBytes = ss->channels * sizeof(float);
+    const size_t offset = skipBytes_ > 0 ? frameBytes - skipBytes_ : partialBytes_;
+    const size_t newOffset = (offset + bytes) % frameBytes;
+    skipBytes_ = newOffset > 0 ? frameBytes - newOffset : 0;
+    partialBytes_ = 0;
+}
+
+void AudioCapture::stream_read_callback(pa_stream* s, size_t length, void* userdata) {
+    (void)length;
+    auto* self = static_cast<AudioCapture*>(userdata);
+
+    // Both streams of a switch call back on this thread, so the handover needs no
+    // synchronization: the old stream is gone before the new one's data is metered
+    if (s == self->nextStream_) {
+        self->promoteNextStream();
+    }
+
+    const std::int64_t callbackStartNs = levelClockNowNs();
+
+    if (!self->realtimeChecked_) {
+        self->callbackMetrics_.setRealtime(currentThreadIsRealtime());
+        self->realtimeChecked_ = true;
+    }
+
+    // Drain everything readable: the data may be spread over several fragments, and
+    // whatever is left here waits for the next wakeup and adds latency
+    size_t consumed = 0;
+    while (pa_stream_readable_size(s) > 0) {
+        const void* p = nullptr;
+        size_t bytes = 0;
+        if (pa_stream_peek(s, &p, &bytes) < 0 || bytes == 0) {
+            break;
+        }
+
+        if (p) {
+            self->consumeFragment(s, static_cast<const unsigned char*>(p), bytes);
+            consumed += bytes;
+        } else {
+            self->skipHole(bytes); // a hole must be dropped too, or the stream stalls
+        }
+        pa_stream_drop(s);
+    }
+
+    // Fewer wakeups while idle; the first loud fragment switches back
+    if (self->idleChanged_ && s == self->stream_) {
+        self->idleChanged_ = false;
+        self->applyIdleFragments(s);
+    }
+
+    // The callback has as long as the audio it consumed lasts
+    const pa_sample_spec* ss = pa_stream_get_sample_spec(s);
+    if (consumed > 0 && ss) {
+        const auto budgetNs = static_cast<std::int64_t>(pa_bytes_to_usec(consumed, ss)) * 1000;
+        self->callbackMetrics_.record(levelClockNowNs() - callbackStartNs, budgetNs);
+    }
+}
+
+void AudioCapture::stream_overflow_callback(pa_stream* s, void* userdata) {
+    (void)s;
+    auto* self = static_cast<AudioCapture*>(userdata);
+    self->overflows_.fetch_add(1, std::memory_order_relaxed);
 }
 
 void AudioCapture::stream_state_callback(pa_stream* s, void* userdata) {
@@ -417,7 +541,11 @@ void AudioCapture::stream_state_callback(pa_stream* s, void* userdata) {
         break;
     }
     case PA_STREAM_FAILED: {
-        emit self->errorOccurred(QStringLiteral("PulseAudio stream failed"));
+        if (s == self->nextStream_) {
+            self->abandonSwitch(QStringLiteral("the stream failed"));
+        } else {
+            emit self->errorOccurred(QStringLiteral("PulseAudio stream failed"));
+        }
         break;
     }
     default:
@@ -429,110 +557,196 @@ void AudioCapture::sink_info_callback(pa_context* c, const pa_sink_info* si, int
     (void)c;
     auto* self = static_cast<AudioCapture*>(userdata);
 
-    if (is_last < 0 || !si) {
-        emit self->errorOccurred(QStringLiteral("Failed to get sink info"));
+    if (is_last < 0) {
+        if (self->switchPending_) {
+            self->abandonSwitch(QStringLiteral("device not found"));
+        } else {
+            emit self->errorOccurred(QStringLiteral("Failed to get sink info"));
+        }
+        return;
+    }
+
+    if (is_last > 0 || !si || !self->running_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    self->onDeviceInfo(si->sample_spec, si->channel_map, si->monitor_source_name);
+}
+
+void AudioCapture::source_info_callback(pa_context* c, const pa_source_info* si, int is_last, void* userdata) {
+    (void)c;
+    auto* self = static_cast<AudioCapture*>(userdata);
+
+    if (is_last < 0) {
+        if (self->switchPending_) {
+            self->abandonSwitch(QStringLiteral("device not found"));
+        } else {
+            emit self->errorOccurred(QStringLiteral("Failed to get source info"));
+        }
+        return;
+    }
+
+    if (is_last > 0 || !si || !self->running_.load(std::memory_order_relaxed)) {
         return;
     }
 
-    if (is_last > 0) {
+    self->onDeviceInfo(si->sample_spec, si->channel_map, si->name);
+}
+
+void AudioCapture::onDeviceInfo(const pa_sample_spec& spec, const pa_channel_map& map, const char* sourceName) {
+    // List lookups report every device and then an end marker; the first device wins
+    pa_stream*& target = switchPending_ ? nextStream_ : stream_;
+    if (target) {
         return;
     }
 
-    pa_sample_spec nss = si->sample_spec;
+    target = connectStream(spec, map, sourceName);
+    if (!target) {
+        switchPending_ = false;
+        return;
+    }
+
+    if (target == stream_) {
+        resetStreamState(spec.channels);
+    }
+}
+
+pa_stream* AudioCapture::connectStream(const pa_sample_spec& spec, const pa_channel_map& map, const char* sourceName) {
+    pa_sample_spec nss = spec;
     nss.format = PA_SAMPLE_FLOAT32;
 
     pa_proplist* props = pa_proplist_new();
     pa_proplist_sets(props, PA_PROP_FILTER_APPLY, "echo-cancel noise-suppression=0 aec=0 agc=0");
 
-    self->stream_ = pa_stream_new_with_proplist(self->context_, "VU Meter Capture", &nss, &si->channel_map, props);
-
+    pa_stream* stream = pa_stream_new_with_proplist(pulse_->context(), "VU Meter Capture", &nss, &map, props);
     pa_proplist_free(props);
-    pa_stream_set_state_callback(self->stream_, &AudioCapture::stream_state_callback, self);
-    pa_stream_set_read_callback(self->stream_, &AudioCapture::stream_read_callback, self);
+    if (!stream) {
+        emit errorOccurred(QStringLiteral("Failed to create PulseAudio stream: %1")
+                               .arg(pa_strerror(pa_context_errno(pulse_->context()))));
+        return nullptr;
+    }
+
+    pa_stream_set_state_callback(stream, &AudioCapture::stream_state_callback, this);
+    pa_stream_set_read_callback(stream, &AudioCapture::stream_read_callback, this);
+    pa_stream_set_overflow_callback(stream, &AudioCapture::stream_overflow_callback, this);
 
     pa_buffer_attr attr;
     attr.maxlength = (uint32_t)-1;
     attr.tlength = (uint32_t)-1;
     attr.prebuf = (uint32_t)-1;
     attr.minreq = (uint32_t)-1;
-    attr.fragsize = self->options_.sampleRate / 100; // ~10 ms
+    attr.fragsize = static_cast<uint32_t>(pa_usec_to_bytes(kFragmentUs, &nss)); // ~10 ms, in bytes
 
-    pa_stream_connect_record(self->stream_, si->monitor_source_name, &attr, PA_STREAM_ADJUST_LATENCY);
+    // Timing info is needed to timestamp levels in stream_read_callback
+    const auto flags = static_cast<pa_stream_flags_t>(PA_STREAM_ADJUST_LATENCY | PA_STREAM_INTERPOLATE_TIMING |
+                                                      PA_STREAM_AUTO_TIMING_UPDATE);
+    pa_stream_connect_record(stream, sourceName, &attr, flags);
+    return stream;
 }
 
-void AudioCapture::source_info_callback(pa_context* c, const pa_source_info* si, int is_last, void* userdata) {
-    (void)c;
-    auto* self = static_cast<AudioCapture*>(userdata);
+void AudioCapture::resetStreamState(unsigned int channels) {
+    partialBytes_ = 0;
+    skipBytes_ = 0;
+    realtimeChecked_ = false;
 
-    if (is_last < 0 || !si) {
-        emit self->errorOccurred(QStringLiteral("Failed to get source info"));
-        return;
-    }
+    // New streams start with the short fragments
+    idleState_.reset();
+    idleChanged_ = false;
+
+    // Keeps the ballistics when the layout is unchanged, so the needle moves on from
+    // where it was instead of dropping
+    dspState_.configure(channels, kAudioFloorVu);
+    vuScratch_.resize(channels);
+}
 
-    if (is_last > 0) {
+void AudioCapture::applyIdleFragments(pa_stream* s) {
+    const pa_sample_spec* ss = pa_stream_get_sample_spec(s);
+    if (!ss) {
         return;
     }
 
-    pa_sample_spec nss = si->sample_spec;
-    nss.format = PA_SAMPLE_FLOAT32;
-
-    pa_proplist* props = pa_proplist_new();
-    pa_proplist_sets(props, PA_PROP_FILTER_APPLY, "echo-cancel noise-suppression=0 aec=0 agc=0");
-
-    self->stream_ = pa_stream_new_with_proplist(self->context_, "VU Meter Capture", &nss, &si->channel_map, props);
-
-    pa_proplist_free(props);
-    pa_stream_set_state_callback(self->stream_, &AudioCapture::stream_state_callback, self);
-    pa_stream_set_read_callback(self->stream_, &AudioCapture::stream_read_callback, self);
-
+    // With PA_STREAM_ADJUST_LATENCY the source's own latency follows, so the server
+    // wakes less often too
     pa_buffer_attr attr;
     attr.maxlength = (uint32_t)-1;
     attr.tlength = (uint32_t)-1;
     attr.prebuf = (uint32_t)-1;
     attr.minreq = (uint32_t)-1;
-    attr.fragsize = self->options_.sampleRate / 100; // ~10 ms
+    attr.fragsize = static_cast<uint32_t>(pa_usec_to_bytes(idleState_.idle() ? kIdleFragmentUs : kFragmentUs, ss));
 
-    pa_stream_connect_record(self->stream_, si->name, &attr, PA_STREAM_ADJUST_LATENCY);
+    pa_operation* op = pa_stream_set_buffer_attr(s, &attr, nullptr, nullptr);
+    if (op) {
+        pa_operation_unref(op);
+    }
 }
 
-void AudioCapture::context_state_callback(pa_context* c, void* userdata) {
-    auto* self = static_cast<AudioCapture*>(userdata);
+void AudioCapture::releaseStream(pa_stream*& stream) {
+    if (!stream) {
+        return;
+    }
+    pa_stream_set_read_callback(stream, nullptr, nullptr);
+    pa_stream_set_overflow_callback(stream, nullptr, nullptr);
+    pa_stream_set_state_callback(stream, nullptr, nullptr);
+    pa_stream_disconnect(stream);
+    pa_stream_unref(stream);
+    stream = nullptr;
+}
 
-    switch (pa_context_get_state(c)) {
-    case PA_CONTEXT_READY: {
-        const char* name = nullptr;
-        QByteArray utf8;
-        if (!self->options_.deviceName.isEmpty()) {
-            utf8 = self->options_.deviceName.toUtf8();
-            name = utf8.constData();
-        }
+void AudioCapture::promoteNextStream() {
+    releaseStream(stream_);
+    stream_ = nextStream_;
+    nextStream_ = nullptr;
+    switchPending_ = false;
+
+    const pa_sample_spec* ss = pa_stream_get_sample_spec(stream_);
+    resetStreamState(ss ? ss->channels : dspState_.channels);
+
+    // The device name belongs to the GUI thread
+    const QString uid = nextDeviceUID_;
+    QMetaObject::invokeMethod(
+        this,
+        [this, uid] {
+            options_.deviceName = uid;
+            currentDeviceUID_ = uid;
+            emit deviceChanged(uid);
+        },
+        Qt::QueuedConnection);
+}
 
-        pa_operation* op = nullptr;
-        if (self->options_.deviceType == 1) {
-            // Source (mic)
-            if (name) {
-                op = pa_context_get_source_info_by_name(c, name, &AudioCapture::source_info_callback, self);
-            } else {
-                op = pa_context_get_source_info_list(c, &AudioCapture::source_info_callback, self);
-            }
+void AudioCapture::abandonSwitch(const QString& reason) {
+    releaseStream(nextStream_);
+    switchPending_ = false;
+    emit errorOccurred(QStringLiteral("Failed to switch to %1: %2").arg(nextDeviceUID_, reason));
+}
+
+void AudioCapture::requestDeviceInfo(const QString& deviceName, int deviceType) {
+    pa_context* c = pulse_->context();
+
+    const char* name = nullptr;
+    QByteArray utf8;
+    if (!deviceName.isEmpty()) {
+        utf8 = deviceName.toUtf8();
+        name = utf8.constData();
+    }
+
+    if (deviceType == 1) {
+        // Source (mic)
+        if (name) {
+            infoOp_ = pa_context_get_source_info_by_name(c, name, &AudioCapture::source_info_callback, this);
         } else {
-            // Sink monitor (system output)
-            if (name) {
-                op = pa_context_get_sink_info_by_name(c, name, &AudioCapture::sink_info_callback, self);
-            } else {
-                op = pa_context_get_sink_info_list(c, &AudioCapture::sink_info_callback, self);
-            }
+            infoOp_ = pa_context_get_source_info_list(c, &AudioCapture::source_info_callback, this);
+        }
+    } else {
+        // Sink monitor (system output)
+        if (name) {
+            infoOp_ = pa_context_get_sink_info_by_name(c, name, &AudioCapture::sink_info_callback, this);
+        } else {
+            infoOp_ = pa_context_get_sink_info_list(c, &AudioCapture::sink_info_callback, this);
         }
-        if (op)
-            pa_operation_unref(op);
-        break;
-    }
-    case PA_CONTEXT_FAILED: {
-        emit self->errorOccurred(QStringLiteral("PulseAudio context failed"));
-        break;
     }
-    default:
-        break;
+
+    if (!infoOp_) {
+        emit errorOccurred(QStringLiteral("PulseAudio device lookup failed: %1").arg(pa_strerror(pa_context_errno(c))));
     }
 }
 
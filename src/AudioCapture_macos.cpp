@@ -1,149 +1,164 @@
 #if defined(__APPLE__)
 
+#include "AllocationGuard.h"
 #include "AudioCapture.h"
+#include "RealtimeThread.h"
 #include "VuAudioDsp.h"
 
 #include <algorithm>
 #include <cmath>
+#include <vector>
 
-#include <AudioToolbox/AudioToolbox.h>
 #include <CoreAudio/CoreAudio.h>
+#include <mach/mach_time.h>
 
 static constexpr float kMinVu = -22.0f;
 static constexpr float kMaxVu = 3.0f;
 
 AudioCapture::AudioCapture(const Options& options, QObject* parent)
-    : QObject(parent), options_(options), currentDeviceUID_(options.deviceName), ballisticsL_(kMinVu),
-      ballisticsR_(kMinVu) {}
+    : QObject(parent), options_(options), currentDeviceUID_(options.deviceName),
+      referenceDbfs_(options.referenceDbfs), referenceDbfsOverride_(options.referenceDbfsOverride),
+      pendingBallistics_(options.ballistics), dspState_(options.jitter, options.ballistics) {
+    for (auto& vu : channelVuDb_) {
+        vu.store(kMinVu, std::memory_order_relaxed);
+    }
+    idleState_.setHoldNs(static_cast<std::int64_t>(options.idleAfterSeconds * 1'000'000'000.0));
+}
 
-AudioCapture::~AudioCapture() { stop(); }
+// Device that capture will open: the requested UID, else the default input
+static AudioDeviceID captureDeviceId(const QString& uid) {
+    AudioDeviceID deviceID = kAudioObjectUnknown;
+    UInt32 dataSize = sizeof(deviceID);
+
+    if (!uid.isEmpty()) {
+        CFStringRef cfUid = uid.toCFString();
+        AudioObjectPropertyAddress address = {
+            kAudioHardwarePropertyTranslateUIDToDevice, kAudioObjectPropertyScopeGlobal, kAudioObjectPropertyElementMain};
+        AudioObjectGetPropertyData(
+            kAudioObjectSystemObject, &address, sizeof(cfUid), &cfUid, &dataSize, &deviceID);
+        CFRelease(cfUid);
+        return deviceID;
+    }
 
-bool AudioCapture::start(QString* errorOut) {
-    if (running_.exchange(true)) {
-        return true;
+    AudioObjectPropertyAddress address = {
+        kAudioHardwarePropertyDefaultInputDevice, kAudioObjectPropertyScopeGlobal, kAudioObjectPropertyElementMain};
+    AudioObjectGetPropertyData(kAudioObjectSystemObject, &address, 0, nullptr, &dataSize, &deviceID);
+    return deviceID;
+}
+
+static UInt32 inputChannelCount(AudioDeviceID deviceID) {
+    if (deviceID == kAudioObjectUnknown) {
+        return 0;
     }
 
-    // Set up audio format - 32-bit float, stereo, at requested sample rate
-    AudioStreamBasicDescription format = {};
-    format.mSampleRate = options_.sampleRate;
-    format.mFormatID = kAudioFormatLinearPCM;
-    format.mFormatFlags = kAudioFormatFlagIsFloat | kAudioFormatFlagIsPacked;
-    format.mBitsPerChannel = 32;
-    format.mChannelsPerFrame = 2; // Stereo
-    format.mBytesPerFrame = format.mChannelsPerFrame * sizeof(float);
-    format.mFramesPerPacket = 1;
-    format.mBytesPerPacket = format.mBytesPerFrame;
-
-    // Create the audio queue for input
-    OSStatus status = AudioQueueNewInput(
-        &format,
-        [](void* inUserData,
-           AudioQueueRef inAQ,
-           AudioQueueBufferRef inBuffer,
-           const AudioTimeStamp* inStartTime,
-           UInt32 inNumberPacketDescriptions,
-           const AudioStreamPacketDescription* inPacketDescs) {
-            // Bridge to our static callback
-            AudioCapture::audioInputCallback(inUserData,
-                                             inAQ,
-                                             reinterpret_cast<AudioQueueBuffer*>(inBuffer),
-                                             inStartTime,
-                                             inNumberPacketDescriptions,
-                                             inPacketDescs);
-        },
-        this,
-        nullptr, // Run loop (null = use internal thread)
-        nullptr, // Run loop mode
-        0,       // Reserved
-        &audioQueue_);
+    AudioObjectPropertyAddress address = {
+        kAudioDevicePropertyStreamConfiguration, kAudioDevicePropertyScopeInput, kAudioObjectPropertyElementMain};
+    UInt32 dataSize = 0;
+    if (AudioObjectGetPropertyDataSize(deviceID, &address, 0, nullptr, &dataSize) != noErr || dataSize == 0) {
+        return 0;
+    }
 
-    if (status != noErr) {
-        if (errorOut) {
-            *errorOut = QStringLiteral("Failed to create audio input queue: %1").arg(status);
-        }
-        running_.store(false, std::memory_order_relaxed);
-        return false;
+    std::vector<UInt8> bufferListData(dataSize);
+    AudioBufferList* bufferList = reinterpret_cast<AudioBufferList*>(bufferListData.data());
+    if (AudioObjectGetPropertyData(deviceID, &address, 0, nullptr, &dataSize, bufferList) != noErr) {
+        return 0;
     }
 
-    // If a specific device is requested or if we want system output (loopback)
-    // Note: macOS system audio loopback requires special handling or third-party extensions
-    if (!options_.deviceName.isEmpty()) {
-        CFStringRef deviceUID = CFStringCreateWithCString(
-            kCFAllocatorDefault, options_.deviceName.toUtf8().constData(), kCFStringEncodingUTF8);
+    UInt32 channels = 0;
+    for (UInt32 i = 0; i < bufferList->mNumberBuffers; ++i) {
+        channels += bufferList->mBuffers[i].mNumberChannels;
+    }
+    return channels;
+}
 
-        status = AudioQueueSetProperty(audioQueue_, kAudioQueueProperty_CurrentDevice, &deviceUID, sizeof(deviceUID));
+// UID of a device, for reporting which one the default input resolved to
+static QString deviceUid(AudioDeviceID deviceID) {
+    CFStringRef uid = nullptr;
+    UInt32 dataSize = sizeof(uid);
+    AudioObjectPropertyAddress address = {
+        kAudioDevicePropertyDeviceUID, kAudioObjectPropertyScopeGlobal, kAudioObjectPropertyElementMain};
+    if (AudioObjectGetPropertyData(deviceID, &address, 0, nullptr, &dataSize, &uid) != noErr || !uid) {
+        return QString();
+    }
+    QString result = QString::fromCFString(uid);
+    CFRelease(uid);
+    return result;
+}
 
-        CFRelease(deviceUID);
+static Float64 nominalSampleRate(AudioDeviceID deviceID) {
+    Float64 rate = 0.0;
+    UInt32 dataSize = sizeof(rate);
+    AudioObjectPropertyAddress address = {
+        kAudioDevicePropertyNominalSampleRate, kAudioObjectPropertyScopeGlobal, kAudioObjectPropertyElementMain};
+    if (AudioObjectGetPropertyData(deviceID, &address, 0, nullptr, &dataSize, &rate) != noErr) {
+        return 0.0;
+    }
+    return rate;
+}
 
-        if (status != noErr) {
-            if (errorOut) {
-                *errorOut = QStringLiteral("Failed to set audio device: %1").arg(status);
-            }
-            AudioQueueDispose(audioQueue_, true);
-            audioQueue_ = nullptr;
-            running_.store(false, std::memory_order_relaxed);
-            return false;
-        }
-        currentDeviceUID_ = options_.deviceName;
-    } else {
-        // Get the default input device UID
-        AudioDeviceID defaultInput = 0;
-        AudioObjectPropertyAddress propertyAddress = {
-            kAudioHardwarePropertyDefaultInputDevice, kAudioObjectPropertyScopeGlobal, kAudioObjectPropertyElementMain};
-        UInt32 dataSize = sizeof(defaultInput);
-        if (AudioObjectGetPropertyData(
-                kAudioObjectSystemObject, &propertyAddress, 0, nullptr, &dataSize, &defaultInput) == noErr) {
-            CFStringRef deviceUID = nullptr;
-            propertyAddress.mSelector = kAudioDevicePropertyDeviceUID;
-            dataSize = sizeof(deviceUID);
-            if (AudioObjectGetPropertyData(defaultInput, &propertyAddress, 0, nullptr, &dataSize, &deviceUID) ==
-                    noErr &&
-                deviceUID) {
-                currentDeviceUID_ = QString::fromCFString(deviceUID);
-                CFRelease(deviceUID);
-            }
-        }
+static UInt32 bufferFrameSize(AudioDeviceID deviceID) {
+    UInt32 frames = 0;
+    UInt32 dataSize = sizeof(frames);
+    AudioObjectPropertyAddress address = {
+        kAudioDevicePropertyBufferFrameSize, kAudioObjectPropertyScopeGlobal, kAudioObjectPropertyElementMain};
+    if (AudioObjectGetPropertyData(deviceID, &address, 0, nullptr, &dataSize, &frames) != noErr) {
+        return 0;
+    }
+    return frames;
+}
+
+// IOProcs see each input stream in its virtual format; the meter reads 32-bit float
+// (what the HAL presents for practically every device, aggregates included)
+static bool inputStreamsAreFloat32(AudioDeviceID deviceID) {
+    AudioObjectPropertyAddress address = {
+        kAudioDevicePropertyStreams, kAudioDevicePropertyScopeInput, kAudioObjectPropertyElementMain};
+    UInt32 dataSize = 0;
+    if (AudioObjectGetPropertyDataSize(deviceID, &address, 0, nullptr, &dataSize) != noErr || dataSize == 0) {
+        return false;
     }
 
-    // Allocate and enqueue buffers
-    UInt32 bufferSize = options_.framesPerBuffer * format.mBytesPerFrame;
+    std::vector<AudioStreamID> streams(dataSize / sizeof(AudioStreamID));
+    if (AudioObjectGetPropertyData(deviceID, &address, 0, nullptr, &dataSize, streams.data()) != noErr) {
+        return false;
+    }
 
-    for (int i = 0; i < kNumBuffers; ++i) {
-        status =
-            AudioQueueAllocateBuffer(audioQueue_, bufferSize, reinterpret_cast<AudioQueueBufferRef*>(&buffers_[i]));
-        if (status != noErr) {
-            if (errorOut) {
-                *errorOut = QStringLiteral("Failed to allocate audio buffer: %1").arg(status);
-            }
-            AudioQueueDispose(audioQueue_, true);
-            audioQueue_ = nullptr;
-            running_.store(false, std::memory_order_relaxed);
+    for (AudioStreamID stream : streams) {
+        AudioStreamBasicDescription format = {};
+        UInt32 formatSize = sizeof(format);
+        AudioObjectPropertyAddress formatAddress = {
+            kAudioStreamPropertyVirtualFormat, kAudioObjectPropertyScopeGlobal, kAudioObjectPropertyElementMain};
+        if (AudioObjectGetPropertyData(stream, &formatAddress, 0, nullptr, &formatSize, &format) != noErr) {
             return false;
         }
-
-        status = AudioQueueEnqueueBuffer(audioQueue_, reinterpret_cast<AudioQueueBufferRef>(buffers_[i]), 0, nullptr);
-        if (status != noErr) {
-            if (errorOut) {
-                *errorOut = QStringLiteral("Failed to enqueue audio buffer: %1").arg(status);
-            }
-            AudioQueueDispose(audioQueue_, true);
-            audioQueue_ = nullptr;
-            running_.store(false, std::memory_order_relaxed);
+        if (format.mFormatID != kAudioFormatLinearPCM || !(format.mFormatFlags & kAudioFormatFlagIsFloat) ||
+            format.mBitsPerChannel != 32) {
             return false;
         }
     }
+    return !streams.empty();
+}
 
-    // Start the queue
-    status = AudioQueueStart(audioQueue_, nullptr);
-    if (status != noErr) {
-        if (errorOut) {
-            *errorOut = QStringLiteral("Failed to start audio queue: %1").arg(status);
-        }
-        AudioQueueDispose(audioQueue_, true);
-        audioQueue_ = nullptr;
+// Device properties the capture follows while it runs
+static const AudioObjectPropertyAddress kDeviceListenerAddresses[] = {
+    {kAudioDevicePropertyNominalSampleRate, kAudioObjectPropertyScopeGlobal, kAudioObjectPropertyElementMain},
+    {kAudioDevicePropertyDeviceIsAlive, kAudioObjectPropertyScopeGlobal, kAudioObjectPropertyElementMain},
+};
+
+AudioCapture::~AudioCapture() { stop(); }
+
+bool AudioCapture::start(QString* errorOut) {
+    if (running_.exchange(true)) {
+        return true;
+    }
+    realtimeChecked_ = false;
+
+    DeviceStream& slot = devices_[0];
+    if (!openDevice(slot, options_.deviceName, errorOut)) {
         running_.store(false, std::memory_order_relaxed);
         return false;
     }
+    activeDevice_.store(&slot, std::memory_order_release);
+    currentDeviceUID_ = slot.uid;
 
     if (errorOut) {
         *errorOut = QString();
@@ -151,19 +166,119 @@ bool AudioCapture::start(QString* errorOut) {
     return true;
 }
 
+bool AudioCapture::openDevice(DeviceStream& slot, const QString& uid, QString* errorOut) {
+    const auto fail = [&slot, errorOut](const QString& message) {
+        if (errorOut) {
+            *errorOut = message;
+        }
+        slot.device = kAudioObjectUnknown;
+        return false;
+    };
+
+    slot.owner = this;
+    slot.device = captureDeviceId(uid);
+    if (slot.device == kAudioObjectUnknown) {
+        return fail(uid.isEmpty() ? QStringLiteral("No default audio input device")
+                                  : QStringLiteral("Audio device not found: %1").arg(uid));
+    }
+
+    // The IOProc reads the device's own layout, rate and buffer size: no queue, no conversion
+    const UInt32 channels = inputChannelCount(slot.device);
+    if (channels == 0) {
+        return fail(QStringLiteral("Audio device has no input channels"));
+    }
+    if (!inputStreamsAreFloat32(slot.device)) {
+        return fail(QStringLiteral("Audio device does not deliver 32-bit float input"));
+    }
+    const Float64 sampleRate = nominalSampleRate(slot.device);
+    if (sampleRate <= 0.0) {
+        return fail(QStringLiteral("Failed to read the device sample rate"));
+    }
+    slot.sampleRate.store(static_cast<float>(sampleRate), std::memory_order_relaxed);
+
+    UInt32 frames = bufferFrameSize(slot.device);
+    if (frames == 0) {
+        frames = static_cast<UInt32>(options_.framesPerBuffer);
+    }
+
+    // Everything the IO thread touches is sized here. While another device is metering,
+    // the DSP is its; a new layout is adopted at the handover.
+    if (!activeDevice_.load(std::memory_order_acquire)) {
+        dspState_.configure(channels, kMinVu);
+        vuScratch_.resize(channels);
+    }
+    slot.interleaveScratch.assign(static_cast<size_t>(frames) * channels, 0.0f);
+
+    for (const auto& address : kDeviceListenerAddresses) {
+        AudioObjectAddPropertyListener(slot.device, &address, &AudioCapture::devicePropertyListener, &slot);
+    }
+
+    OSStatus status = AudioDeviceCreateIOProcID(slot.device, &AudioCapture::deviceIOProc, &slot, &slot.ioProc);
+    if (status != noErr) {
+        slot.ioProc = nullptr;
+        removeDeviceListeners(slot);
+        return fail(QStringLiteral("Failed to create audio device IOProc: %1").arg(status));
+    }
+
+    status = AudioDeviceStart(slot.device, slot.ioProc);
+    if (status != noErr) {
+        AudioDeviceDestroyIOProcID(slot.device, slot.ioProc);
+        slot.ioProc = nullptr;
+        removeDeviceListeners(slot);
+        return fail(QStringLiteral("Failed to start audio device: %1").arg(status));
+    }
+
+    slot.uid = uid.isEmpty() ? deviceUid(slot.device) : uid;
+    return true;
+}
+
+void AudioCapture::closeDevice(DeviceStream& slot) {
+    if (slot.device == kAudioObjectUnknown) {
+        return;
+    }
+
+    removeDeviceListeners(slot);
+
+    // AudioDeviceStop returns once the IOProc is no longer running
+    if (slot.ioProc) {
+        AudioDeviceStop(slot.device, slot.ioProc);
+        AudioDeviceDestroyIOProcID(slot.device, slot.ioProc);
+        slot.ioProc = nullptr;
+    }
+    slot.device = kAudioObjectUnknown;
+}
+
 void AudioCapture::stop() {
     if (!running_.exchange(false)) {
         return;
     }
 
-    if (audioQueue_) {
-        AudioQueueStop(audioQueue_, true);
-        AudioQueueDispose(audioQueue_, true);
-        audioQueue_ = nullptr;
+    activeDevice_.store(nullptr, std::memory_order_release);
+    incomingDevice_.store(nullptr, std::memory_order_release);
+    for (DeviceStream& slot : devices_) {
+        closeDevice(slot);
+    }
+}
+
+void AudioCapture::removeDeviceListeners(DeviceStream& slot) {
+    for (const auto& address : kDeviceListenerAddresses) {
+        AudioObjectRemovePropertyListener(slot.device, &address, &AudioCapture::devicePropertyListener, &slot);
     }
+}
 
-    for (int i = 0; i < kNumBuffers; ++i) {
-        buffers_[i] = nullptr;
+void AudioCapture::retireDevices() {
+    DeviceStream* active = activeDevice_.load(std::memory_order_acquire);
+    DeviceStream* incoming = incomingDevice_.load(std::memory_order_acquire);
+    for (DeviceStream& slot : devices_) {
+        if (&slot != active && &slot != incoming) {
+            closeDevice(slot);
+        }
+    }
+
+    if (active && active->uid != currentDeviceUID_) {
+        options_.deviceName = active->uid;
+        currentDeviceUID_ = active->uid;
+        emit deviceChanged(active->uid);
     }
 }
 
@@ -172,15 +287,10 @@ bool AudioCapture::switchDevice(const QString& deviceUID, QString* errorOut) {
     stop();
 
     // Reset ballistics and smoothed values
-    rmsL_smooth_ = 0.0f;
-    rmsR_smooth_ = 0.0f;
-    prevL_ = 0.0f;
-    prevR_ = 0.0f;
-    meterAwake_ = false;
-    ballisticsL_.reset(kMinVu);
-    ballisticsR_.reset(kMinVu);
-    leftVuDb_.store(kMinVu, std::memory_order_relaxed);
-    rightVuDb_.store(kMinVu, std::memory_order_relaxed);
+    dspState_ = VuAudioDspState(options_.jitter, ballisticsProfile());
+    for (auto& vu : channelVuDb_) {
+        vu.store(kMinVu, std::memory_order_relaxed);
+    }
 
     // Update options with new device
     options_.deviceName = deviceUID;
@@ -196,104 +306,77 @@ bool AudioCapture::switchDevice(const QString& deviceUID, QString* errorOut) {
     return success;
 }
 
-QString AudioCapture::currentDeviceUID() const { return currentDeviceUID_; }
-
-double AudioCapture::referenceDbfs() const { return options_.referenceDbfs; }
-
-void AudioCapture::setReferenceDbfs(double value) {
-    options_.referenceDbfs = value;
-    options_.referenceDbfsOverride = true;
-}
-
-float AudioCapture::leftVuDb() const { return leftVuDb_.load(std::memory_order_relaxed); }
-
-float AudioCapture::rightVuDb() const { return rightVuDb_.load(std::memory_order_relaxed); }
-
-QList<AudioCapture::DeviceInfo> AudioCapture::enumerateInputDevices() {
-    QList<DeviceInfo> result;
-
-    AudioObjectPropertyAddress propertyAddress = {
-        kAudioHardwarePropertyDevices, kAudioObjectPropertyScopeGlobal, kAudioObjectPropertyElementMain};
-
-    UInt32 dataSize = 0;
-    OSStatus status = AudioObjectGetPropertyDataSize(kAudioObjectSystemObject, &propertyAddress, 0, nullptr, &dataSize);
-
-    if (status != noErr) {
-        return result;
+bool AudioCapture::switchDeviceAsync(const QString& deviceUID, QString* errorOut) {
+    if (!running_.load(std::memory_order_relaxed)) {
+        // Nothing is metering, so there is no gap to avoid
+        return switchDevice(deviceUID, errorOut);
     }
 
-    UInt32 deviceCount = dataSize / sizeof(AudioDeviceID);
-    std::vector<AudioDeviceID> devices(deviceCount);
-
-    status =
-        AudioObjectGetPropertyData(kAudioObjectSystemObject, &propertyAddress, 0, nullptr, &dataSize, devices.data());
+    // The slot that is not active: free, still waiting for an earlier switch's first
+    // buffer, or holding a device that waits to be retired
+    DeviceStream* active = activeDevice_.load(std::memory_order_acquire);
+    DeviceStream& slot = (active == &devices_[0]) ? devices_[1] : devices_[0];
+    incomingDevice_.store(nullptr, std::memory_order_release);
+    closeDevice(slot);
 
-    if (status != noErr) {
-        return result;
+    if (!openDevice(slot, deviceUID, errorOut)) {
+        return false;
     }
+    incomingDevice_.store(&slot, std::memory_order_release);
 
-    // Get default input device
-    AudioDeviceID defaultInput = 0;
-    propertyAddress.mSelector = kAudioHardwarePropertyDefaultInputDevice;
-    dataSize = sizeof(defaultInput);
-    AudioObjectGetPropertyData(kAudioObjectSystemObject, &propertyAddress, 0, nullptr, &dataSize, &defaultInput);
+    if (errorOut) {
+        *errorOut = QString();
+    }
+    return true;
+}
 
-    for (AudioDeviceID deviceID : devices) {
-        // Check if device has input channels
-        propertyAddress.mSelector = kAudioDevicePropertyStreamConfiguration;
-        propertyAddress.mScope = kAudioDevicePropertyScopeInput;
+QString AudioCapture::currentDeviceUID() const { return currentDeviceUID_; }
 
-        dataSize = 0;
-        status = AudioObjectGetPropertyDataSize(deviceID, &propertyAddress, 0, nullptr, &dataSize);
-        if (status != noErr)
-            continue;
+double AudioCapture::referenceDbfs() const { return referenceDbfs_.load(std::memory_order_relaxed); }
 
-        std::vector<UInt8> bufferListData(dataSize);
-        AudioBufferList* bufferList = reinterpret_cast<AudioBufferList*>(bufferListData.data());
+void AudioCapture::setReferenceDbfs(double value) {
+    options_.referenceDbfs = value;
+    options_.referenceDbfsOverride = true;
+    referenceDbfs_.store(value, std::memory_order_relaxed);
+    referenceDbfsOverride_.store(true, std::memory_order_relaxed);
+}
 
-        status = AudioObjectGetPropertyData(deviceID, &propertyAddress, 0, nullptr, &dataSize, bufferList);
-        if (status != noErr)
-            continue;
+VuBallisticsProfile AudioCapture::ballisticsProfile() const {
+    std::lock_guard<std::mutex> lock(ballisticsMutex_);
+    return pendingBallistics_;
+}
 
-        UInt32 inputChannels = 0;
-        for (UInt32 i = 0; i < bufferList->mNumberBuffers; ++i) {
-            inputChannels += bufferList->mBuffers[i].mNumberChannels;
-        }
+void AudioCapture::setBallisticsProfile(const VuBallisticsProfile& profile) {
+    std::lock_guard<std::mutex> lock(ballisticsMutex_);
+    pendingBallistics_ = profile;
+    ballisticsVersion_.fetch_add(1, std::memory_order_release);
+}
 
-        if (inputChannels > 0) {
-            DeviceInfo info;
-            info.channels = static_cast<int>(inputChannels);
-            info.isInput = true;
-            info.isDefault = (deviceID == defaultInput);
+float AudioCapture::leftVuDb() const { return channelVuDb(0); }
 
-            // Get device name
-            CFStringRef deviceName = nullptr;
-            propertyAddress.mSelector = kAudioDevicePropertyDeviceNameCFString;
-            propertyAddress.mScope = kAudioObjectPropertyScopeGlobal;
-            dataSize = sizeof(deviceName);
-            if (AudioObjectGetPropertyData(deviceID, &propertyAddress, 0, nullptr, &dataSize, &deviceName) == noErr &&
-                deviceName) {
-                info.name = QString::fromCFString(deviceName);
-                CFRelease(deviceName);
-            } else {
-                info.name = "Unknown Device";
-            }
+float AudioCapture::rightVuDb() const { return channelVuDb(channelCount() > 1 ? 1 : 0); }
 
-            // Get device UID
-            CFStringRef deviceUID = nullptr;
-            propertyAddress.mSelector = kAudioDevicePropertyDeviceUID;
-            dataSize = sizeof(deviceUID);
-            if (AudioObjectGetPropertyData(deviceID, &propertyAddress, 0, nullptr, &dataSize, &deviceUID) == noErr &&
-                deviceUID) {
-                info.uid = QString::fromCFString(deviceUID);
-                CFRelease(deviceUID);
-            }
+unsigned int AudioCapture::channelCount() const { return channelCount_.load(std::memory_order_relaxed); }
 
-            result.append(info);
-        }
+float AudioCapture::channelVuDb(unsigned int channel) const {
+    if (channel >= kVuMaxChannels) {
+        return kMinVu;
     }
+    return channelVuDb_[channel].load(std::memory_order_relaxed);
+}
 
-    return result;
+AudioCapture::CaptureStats AudioCapture::stats() const {
+    // The IOProc is handed whole hardware buffers; HAL overloads surface as deadline misses
+    CaptureStats stats;
+    stats.holes = holes_.load(std::memory_order_relaxed);
+    stats.overflows = overflows_.load(std::memory_order_relaxed);
+    stats.droppedLevels = levelRing_.droppedCount();
+    stats.callbacks = callbackMetrics_.callbacks();
+    stats.worstCallbackNs = callbackMetrics_.worstNs();
+    stats.deadlineMisses = callbackMetrics_.deadlineMisses();
+    stats.realtime = callbackMetrics_.realtime();
+    stats.allocationViolations = AllocationGuard::violations();
+    return stats;
 }
 
 QString AudioCapture::listDevicesString() {
@@ -449,71 +532,238 @@ QString AudioCapture::listDevicesString() {
     return out;
 }
 
-// -------- CoreAudio callback --------
+// -------- CoreAudio callbacks --------
 
-void AudioCapture::audioInputCallback(void* inUserData,
-                                      AudioQueueRef inAQ,
-                                      AudioQueueBuffer* inBuffer,
-                                      const void* inStartTime,
-                                      unsigned int inNumberPacketDescriptions,
-                                      const void* inPacketDescs) {
-    (void)inStartTime;
-    (void)inNumberPacketDescriptions;
-    (void)inPacketDescs;
+// Capture time of the buffer's last frame on the steady_clock time base
+static std::int64_t blockEndTimeNs(const AudioTimeStamp* inputTime, unsigned int frames, float sampleRate) {
+    const std::int64_t nowNs = levelClockNowNs();
+    if (!inputTime || !(inputTime->mFlags & kAudioTimeStampHostTimeValid) || sampleRate <= 0.0f) {
+        return nowNs;
+    }
 
-    auto* self = static_cast<AudioCapture*>(inUserData);
+    static mach_timebase_info_data_t timebase = [] {
+        mach_timebase_info_data_t info{};
+        mach_timebase_info(&info);
+        return info;
+    }();
+
+    // Host time and steady_clock need not share an epoch; map through "now"
+    const auto hostToNs = [](std::uint64_t host) {
+        return static_cast<std::int64_t>(static_cast<long double>(host) * timebase.numer / timebase.denom);
+    };
+    const std::int64_t startNs = nowNs - (hostToNs(mach_absolute_time()) - hostToNs(inputTime->mHostTime));
+    return startNs + static_cast<std::int64_t>(static_cast<double>(frames) * 1e9 / sampleRate);
+}
 
-    if (!self->running_.load(std::memory_order_relaxed)) {
-        return;
+OSStatus AudioCapture::deviceIOProc(AudioObjectID inDevice,
+                                    const AudioTimeStamp* inNow,
+                                    const AudioBufferList* inInputData,
+                                    const AudioTimeStamp* inInputTime,
+                                    AudioBufferList* outOutputData,
+                                    const AudioTimeStamp* inOutputTime,
+                                    void* inClientData) {
+    (void)inDevice;
+    (void)inNow;
+    (void)outOutputData;
+    (void)inOutputTime;
+
+    auto* slot = static_cast<DeviceStream*>(inClientData);
+    AudioCapture* self = slot->owner;
+
+    if (!self->running_.load(std::memory_order_relaxed) || !inInputData || inInputData->mNumberBuffers == 0) {
+        return noErr;
+    }
+
+    // The first buffer of the new device ends a switch. The old IOProc is stopped from
+    // the GUI thread: one queued call per switch, the only allocation on this thread.
+    DeviceStream* incoming = slot;
+    if (self->incomingDevice_.compare_exchange_strong(incoming, nullptr, std::memory_order_acq_rel)) {
+        self->activeDevice_.store(slot, std::memory_order_release);
+        self->realtimeChecked_ = false;
+        QMetaObject::invokeMethod(self, [self] { self->retireDevices(); }, Qt::QueuedConnection);
+    }
+
+    // Only the active device feeds the ballistics; both IO threads run during a switch,
+    // and the busy flag keeps them off the DSP at the same time
+    if (slot != self->activeDevice_.load(std::memory_order_acquire) ||
+        self->dspBusy_.test_and_set(std::memory_order_acquire)) {
+        return noErr;
+    }
+
+    // One buffer per input stream; a block is as long as its shortest buffer
+    unsigned int channels = 0;
+    unsigned int frames = ~0u;
+    for (UInt32 b = 0; b < inInputData->mNumberBuffers; ++b) {
+        const AudioBuffer& buffer = inInputData->mBuffers[b];
+        if (buffer.mNumberChannels == 0) {
+            continue;
+        }
+        channels += buffer.mNumberChannels;
+        frames = std::min<unsigned int>(frames, buffer.mDataByteSize / (buffer.mNumberChannels * sizeof(float)));
+    }
+
+    const float sampleRate = slot->sampleRate.load(std::memory_order_relaxed);
+    if (channels == 0 || frames == 0 || frames == ~0u || sampleRate <= 0.0f) {
+        self->dspBusy_.clear(std::memory_order_release);
+        return noErr;
+    }
+
+    const std::int64_t callbackStartNs = levelClockNowNs();
+    const std::int64_t budgetNs = static_cast<std::int64_t>(static_cast<double>(frames) * 1e9 / sampleRate);
+
+    // The HAL runs IOProcs on its own time-constraint thread; report what we got
+    if (!self->realtimeChecked_) {
+        self->callbackMetrics_.setRealtime(currentThreadIsRealtime());
+        self->realtimeChecked_ = true;
+    }
+
+    const std::int64_t blockEndNs = blockEndTimeNs(inInputTime, frames, sampleRate);
+    const AudioBuffer& first = inInputData->mBuffers[0];
+    if (inInputData->mNumberBuffers == 1 && first.mData) {
+        // Interleaved device: meter the HAL's buffer in place
+        self->processAudioBuffer(static_cast<const float*>(first.mData), frames, channels, sampleRate, blockEndNs);
+    } else {
+        self->processBufferList(*inInputData, frames, channels, sampleRate, blockEndNs, slot->interleaveScratch);
     }
+    self->callbackMetrics_.record(levelClockNowNs() - callbackStartNs, budgetNs);
 
-    AudioQueueBufferRef buffer = reinterpret_cast<AudioQueueBufferRef>(inBuffer);
+    self->dspBusy_.clear(std::memory_order_release);
+    return noErr;
+}
 
-    const float* data = static_cast<const float*>(buffer->mAudioData);
-    const unsigned int frames = buffer->mAudioDataByteSize / (2 * sizeof(float)); // stereo
+OSStatus AudioCapture::devicePropertyListener(AudioObjectID inObjectID,
+                                              UInt32 inNumberAddresses,
+                                              const AudioObjectPropertyAddress* inAddresses,
+                                              void* inClientData) {
+    auto* slot = static_cast<DeviceStream*>(inClientData);
+    AudioCapture* self = slot->owner;
+
+    for (UInt32 i = 0; i < inNumberAddresses; ++i) {
+        switch (inAddresses[i].mSelector) {
+        case kAudioDevicePropertyNominalSampleRate: {
+            // Ballistics follow the new rate from the next block on
+            const Float64 rate = nominalSampleRate(inObjectID);
+            if (rate > 0.0) {
+                slot->sampleRate.store(static_cast<float>(rate), std::memory_order_relaxed);
+            }
+            break;
+        }
+        case kAudioDevicePropertyDeviceIsAlive: {
+            UInt32 alive = 1;
+            UInt32 dataSize = sizeof(alive);
+            AudioObjectGetPropertyData(inObjectID, &inAddresses[i], 0, nullptr, &dataSize, &alive);
+            DeviceStream* incoming = slot;
+            if (alive) {
+                break;
+            }
+            if (self->incomingDevice_.compare_exchange_strong(incoming, nullptr, std::memory_order_acq_rel)) {
+                emit self->errorOccurred(
+                    QStringLiteral("Failed to switch to %1: device was disconnected").arg(slot->uid));
+            } else {
+                emit self->errorOccurred(QStringLiteral("Audio device was disconnected"));
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    return noErr;
+}
 
-    self->processAudioBuffer(data, frames, 2, static_cast<float>(self->options_.sampleRate));
+void AudioCapture::processBufferList(const AudioBufferList& buffers,
+                                     unsigned int frames,
+                                     unsigned int channels,
+                                     float sampleRate,
+                                     std::int64_t blockEndNs,
+                                     std::vector<float>& scratch) {
+    // Sized for the layout when the device was opened; a grown aggregate is metered in shorter pieces
+    const unsigned int chunkFrames = static_cast<unsigned int>(scratch.size() / channels);
+    if (chunkFrames == 0) {
+        return;
+    }
 
-    // Re-enqueue the buffer
-    AudioQueueEnqueueBuffer(inAQ, buffer, 0, nullptr);
+    float* out = scratch.data();
+    for (unsigned int done = 0; done < frames;) {
+        const unsigned int n = std::min(chunkFrames, frames - done);
+
+        unsigned int channelOffset = 0;
+        for (UInt32 b = 0; b < buffers.mNumberBuffers; ++b) {
+            const AudioBuffer& buffer = buffers.mBuffers[b];
+            const unsigned int bufferChannels = buffer.mNumberChannels;
+            const float* in = static_cast<const float*>(buffer.mData);
+            for (unsigned int f = 0; f < n; ++f) {
+                for (unsigned int c = 0; c < bufferChannels; ++c) {
+                    out[f * channels + channelOffset + c] = in ? in[(done + f) * bufferChannels + c] : 0.0f;
+                }
+            }
+            channelOffset += bufferChannels;
+        }
+
+        done += n;
+        const std::int64_t pieceEndNs =
+            blockEndNs - static_cast<std::int64_t>(static_cast<double>(frames - done) * 1e9 / sampleRate);
+        processAudioBuffer(out, n, channels, sampleRate, pieceEndNs);
+    }
 }
 
-void AudioCapture::processAudioBuffer(const float* data, unsigned int frames, unsigned int channels, float sampleRate) {
+void AudioCapture::processAudioBuffer(
+    const float* data, unsigned int frames, unsigned int channels, float sampleRate, std::int64_t blockEndNs) {
     VuReferenceOptions ref;
-    ref.referenceDbfs = options_.referenceDbfs;
-    ref.referenceDbfsOverride = options_.referenceDbfsOverride;
+    ref.referenceDbfs = referenceDbfs_.load(std::memory_order_relaxed);
+    ref.referenceDbfsOverride = referenceDbfsOverride_.load(std::memory_order_relaxed);
     ref.deviceType = options_.deviceType;
 
-    VuAudioDspState dspState;
-    dspState.prevL = prevL_;
-    dspState.prevR = prevR_;
-    dspState.rmsL_smooth = rmsL_smooth_;
-    dspState.rmsR_smooth = rmsR_smooth_;
-    dspState.meterAwake = meterAwake_;
-
-    float vuL = kMinVu;
-    float vuR = kMinVu;
-    processInterleavedFloatAudioToVuDb(data,
-                                        frames,
-                                        channels,
-                                        sampleRate,
-                                        ref,
-                                        ballisticsL_,
-                                        ballisticsR_,
-                                        dspState,
-                                        kMinVu,
-                                        kMaxVu,
-                                        vuL,
-                                        vuR);
-
-    prevL_ = dspState.prevL;
-    prevR_ = dspState.prevR;
-    rmsL_smooth_ = dspState.rmsL_smooth;
-    rmsR_smooth_ = dspState.rmsR_smooth;
-    meterAwake_ = dspState.meterAwake;
-
-    leftVuDb_.store(vuL, std::memory_order_relaxed);
-    rightVuDb_.store(vuR, std::memory_order_relaxed);
+    if (vuScratch_.size() != channels || dspState_.channels != channels) {
+        // Sized when the stream is set up; this only catches format changes
+        vuScratch_.resize(channels);
+        dspState_.configure(channels, kMinVu);
+    }
+
+    // A profile change is picked up by a later block if the GUI thread holds the lock
+    const unsigned int ballisticsVersion = ballisticsVersion_.load(std::memory_order_acquire);
+    if (ballisticsVersion != appliedBallisticsVersion_) {
+        std::unique_lock<std::mutex> lock(ballisticsMutex_, std::try_to_lock);
+        if (lock.owns_lock()) {
+            dspState_.setBallisticsProfile(pendingBallistics_);
+            appliedBallisticsVersion_ = ballisticsVersion;
+        }
+    }
+
+    // Nothing below may allocate: it runs on the (possibly realtime) audio thread
+    AllocationGuard allocationGuard;
+
+    if (options_.controlRateHz > 0.0) {
+        processInterleavedFloatAudioToVuDbFixedRate(data,
+                                                    frames,
+                                                    channels,
+                                                    sampleRate,
+                                                    static_cast<float>(options_.controlRateHz),
+                                                    ref,
+                                                    dspState_,
+                                                    kMinVu,
+                                                    kMaxVu,
+                                                    vuScratch_.data());
+    } else {
+        processInterleavedFloatAudioToVuDb(
+            data, frames, channels, sampleRate, ref, dspState_, kMinVu, kMaxVu, vuScratch_.data());
+    }
+
+    LevelSample sample;
+    sample.timeNs = blockEndNs;
+    sample.channels = std::min(channels, kVuMaxChannels);
+    for (unsigned int c = 0; c < sample.channels; ++c) {
+        sample.vu[c] = vuScratch_[c];
+        sample.peakDbfs[c] = dspState_.peakDbfs[c];
+        channelVuDb_[c].store(vuScratch_[c], std::memory_order_relaxed);
+    }
+    channelCount_.store(sample.channels, std::memory_order_relaxed);
+    levelRing_.push(sample);
+
+    // The HAL buffer size is the device's, shared with every client, so it stays as it
+    // is; idle only stops the UI frames here
+    const auto blockNs = static_cast<std::int64_t>(static_cast<double>(frames) * 1e9 / sampleRate);
+    idleState_.update(dspState_, vuScratch_.data(), sample.channels, blockNs);
 }
 
 #endif // __APPLE__
@@ -0,0 +1,740 @@
+#if defined(__linux__) && defined(ANALOGVU_HAS_PIPEWIRE) && (ANALOGVU_HAS_PIPEWIRE == 1)
+
+#include "AllocationGuard.h"
+#include "AudioCapture.h"
+#include "PipeWireConnection.h"
+#include "RealtimeThread.h"
+#include "VuAudioDsp.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <QByteArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <pipewire/extensions/metadata.h>
+#include <pipewire/pipewire.h>
+#include <spa/param/audio/format-utils.h>
+
+static constexpr float kAudioFloorVu = -96.0f;
+static constexpr float kAudioCeilingVu = 6.0f;
+
+// Requested graph quantum. PipeWire runs the graph at the smallest quantum any
+// client asks for (within its configured limits), so this is an upper bound on
+// the block size rather than a guarantee.
+static constexpr unsigned int kQuantumFrames = 256;
+
+// Requested while idle: PipeWire's default clock.max-quantum, so that the graph can
+// slow down when no other client needs short blocks
+static constexpr unsigned int kIdleQuantumFrames = 2048;
+
+// PulseAudio-compatible names: a sink is metered through "<sink name>.monitor"
+static const QString kMonitorSuffix = QStringLiteral(".monitor");
+
+// -------- pw_stream events --------
+
+// One capture stream. A device switch runs two: the current one keeps metering
+// while the new one connects, and the new one takes over from its first buffer.
+struct AudioCapture::PipeWireStream {
+    AudioCapture* owner = nullptr;
+    pw_stream* stream = nullptr;
+    spa_hook listener{};
+    QString deviceUID; // loop thread, or with the lock held
+
+    // Negotiated format: written on format changes, read by the realtime process callback
+    std::atomic<unsigned int> channels{0};
+    std::atomic<unsigned int> rate{0};
+};
+
+struct AudioCapture::PipeWireEvents {
+    static void state_changed(void* userdata, pw_stream_state old, pw_stream_state state, const char* error) {
+        (void)old;
+        auto* slot = static_cast<PipeWireStream*>(userdata);
+        AudioCapture* self = slot->owner;
+        if (state != PW_STREAM_STATE_ERROR) {
+            return;
+        }
+
+        const QString reason = QString::fromUtf8(error);
+        PipeWireStream* incoming = slot;
+        if (self->incomingStream_.compare_exchange_strong(incoming, nullptr, std::memory_order_acq_rel)) {
+            // The current device keeps running. A stream cannot be destroyed from its own
+            // events; the failed one stays idle until the next switch or stop().
+            emit self->errorOccurred(QStringLiteral("Failed to switch to %1: %2").arg(slot->deviceUID, reason));
+        } else {
+            emit self->errorOccurred(QStringLiteral("PipeWire stream failed: %1").arg(reason));
+        }
+    }
+
+    // Runs on the loop thread before any buffer of the new format is processed;
+    // sizes everything here so the realtime callback never allocates
+    static void param_changed(void* userdata, std::uint32_t id, const spa_pod* param) {
+        auto* slot = static_cast<PipeWireStream*>(userdata);
+        AudioCapture* self = slot->owner;
+        if (!param || id != SPA_PARAM_Format) {
+            return;
+        }
+
+        std::uint32_t mediaType = 0;
+        std::uint32_t mediaSubtype = 0;
+        if (spa_format_parse(param, &mediaType, &mediaSubtype) < 0 || mediaType != SPA_MEDIA_TYPE_audio ||
+            mediaSubtype != SPA_MEDIA_SUBTYPE_raw) {
+            return;
+        }
+
+        spa_audio_info_raw info{};
+        if (spa_format_audio_raw_parse(param, &info) < 0 || info.channels == 0 || info.rate == 0) {
+            return;
+        }
+
+        // The DSP belongs to the active stream; an incoming stream with another layout
+        // resizes it once, when it takes over
+        if (slot == self->activeStream_.load(std::memory_order_acquire)) {
+            self->dspState_.configure(info.channels, kAudioFloorVu);
+            self->vuScratch_.resize(info.channels);
+        }
+        slot->rate.store(info.rate, std::memory_order_relaxed);
+        slot->channels.store(info.channels, std::memory_order_release);
+    }
+
+    // Realtime data thread: no allocation, no locks
+    static void process(void* userdata) {
+        auto* slot = static_cast<PipeWireStream*>(userdata);
+        AudioCapture* self = slot->owner;
+        const std::int64_t callbackStartNs = levelClockNowNs();
+
+        pw_buffer* b = pw_stream_dequeue_buffer(slot->stream);
+        if (!b) {
+            return;
+        }
+
+        // The first buffer of the new device ends the switch; the retired stream is
+        // destroyed on the loop thread and the GUI hears about it from there
+        PipeWireStream* incoming = slot;
+        if (self->incomingStream_.compare_exchange_strong(incoming, nullptr, std::memory_order_acq_rel)) {
+            self->activeStream_.store(slot, std::memory_order_release);
+            self->realtimeChecked_ = false;
+            self->idleState_.reset(); // connected with the normal quantum
+            self->idleChanged_ = false;
+            pw_loop_invoke(pw_thread_loop_get_loop(self->pipewire_->loop()),
+                           &PipeWireEvents::retire_streams,
+                           0,
+                           nullptr,
+                           0,
+                           false,
+                           self);
+        }
+
+        // Only the active stream feeds the ballistics. The busy flag covers the moment of
+        // the handover, in case the two streams are served by different data threads.
+        if (slot != self->activeStream_.load(std::memory_order_acquire) ||
+            self->dspBusy_.test_and_set(std::memory_order_acquire)) {
+            pw_stream_queue_buffer(slot->stream, b);
+            return;
+        }
+
+        // module-rt normally promotes the data thread already; report what we got
+        if (!self->realtimeChecked_) {
+            self->callbackMetrics_.setRealtime(currentThreadIsRealtime());
+            self->realtimeChecked_ = true;
+        }
+
+        const unsigned int channels = slot->channels.load(std::memory_order_acquire);
+        const spa_buffer* buf = b->buffer;
+        if (channels > 0 && buf->n_datas > 0 && self->running_.load(std::memory_order_relaxed)) {
+            const spa_data& d = buf->datas[0];
+            if (!d.data || !d.chunk || (d.chunk->flags & SPA_CHUNK_FLAG_CORRUPTED)) {
+                self->holes_.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                const std::uint32_t offset = std::min(d.chunk->offset, d.maxsize);
+                const std::uint32_t size = std::min(d.chunk->size, d.maxsize - offset);
+                const unsigned int frames = size / static_cast<std::uint32_t>(channels * sizeof(float));
+                const unsigned int rate = slot->rate.load(std::memory_order_relaxed);
+
+                if (frames > 0) {
+                    // delay: how long ago the data left the capture device, in graph ticks
+                    std::int64_t blockEndNs = levelClockNowNs();
+                    pw_time time{};
+                    if (pw_stream_get_time_n(slot->stream, &time, sizeof(time)) == 0 && time.rate.denom > 0) {
+                        const std::int64_t delayNs = time.delay * 1'000'000'000 * time.rate.num / time.rate.denom;
+                        blockEndNs -= std::max<std::int64_t>(0, delayNs);
+                    }
+
+                    const auto* bytes = static_cast<const unsigned char*>(d.data) + offset;
+                    const auto* data = reinterpret_cast<const float*>(bytes);
+                    self->processAudioBuffer(data, frames, channels, static_cast<float>(rate), blockEndNs);
+
+                    const std::int64_t budgetNs = static_cast<std::int64_t>(frames) * 1'000'000'000 / rate;
+                    self->callbackMetrics_.record(levelClockNowNs() - callbackStartNs, budgetNs);
+
+                    // Properties can only change on the loop thread
+                    if (self->idleChanged_) {
+                        self->idleChanged_ = false;
+                        pw_loop_invoke(pw_thread_loop_get_loop(self->pipewire_->loop()),
+                                       &PipeWireEvents::update_latency,
+                                       0,
+                                       nullptr,
+                                       0,
+                                       false,
+                                       self);
+                    }
+                }
+            }
+        }
+
+        self->dspBusy_.clear(std::memory_order_release);
+        pw_stream_queue_buffer(slot->stream, b);
+    }
+
+    // Loop thread, after the active stream went idle or woke up: asks for the matching quantum
+    static int update_latency(
+        spa_loop* loop, bool async, std::uint32_t seq, const void* data, size_t size, void* userdata) {
+        (void)loop;
+        (void)async;
+        (void)seq;
+        (void)data;
+        (void)size;
+        auto* self = static_cast<AudioCapture*>(userdata);
+
+        PipeWireStream* active = self->activeStream_.load(std::memory_order_acquire);
+        if (!active || !active->stream) {
+            return 0;
+        }
+
+        const unsigned int frames = self->idleState_.idle() ? kIdleQuantumFrames : kQuantumFrames;
+        char latency[32];
+        std::snprintf(latency, sizeof(latency), "%u/%d", frames, self->options_.sampleRate);
+        const spa_dict_item items[] = {SPA_DICT_ITEM_INIT(PW_KEY_NODE_LATENCY, latency)};
+        const spa_dict dict = SPA_DICT_INIT_ARRAY(items);
+        pw_stream_update_properties(active->stream, &dict);
+        return 0;
+    }
+
+    // Loop thread, after a handover: destroys the retired stream and reports the
+    // completed switch to the GUI thread
+    static int retire_streams(
+        spa_loop* loop, bool async, std::uint32_t seq, const void* data, size_t size, void* userdata) {
+        (void)loop;
+        (void)async;
+        (void)seq;
+        (void)data;
+        (void)size;
+        auto* self = static_cast<AudioCapture*>(userdata);
+
+        PipeWireStream* active = self->activeStream_.load(std::memory_order_acquire);
+        PipeWireStream* incoming = self->incomingStream_.load(std::memory_order_acquire);
+        for (const auto& slot : self->streams_) {
+            if (slot.get() != active && slot.get() != incoming) {
+                self->destroyStream(*slot);
+            }
+        }
+
+        if (active) {
+            const QString uid = active->deviceUID;
+            QMetaObject::invokeMethod(
+                self,
+                [self, uid] {
+                    self->options_.deviceName = uid;
+                    self->currentDeviceUID_ = uid;
+                    emit self->deviceChanged(uid);
+                },
+                Qt::QueuedConnection);
+        }
+        return 0;
+    }
+};
+
+// -------- AudioCapture --------
+
+AudioCapture::AudioCapture(const Options& options, QObject* parent)
+    : QObject(parent), options_(options), currentDeviceUID_(options.deviceName),
+      referenceDbfs_(options.referenceDbfs), referenceDbfsOverride_(options.referenceDbfsOverride),
+      pendingBallistics_(options.ballistics), dspState_(options.jitter, options.ballistics) {
+    for (auto& vu : channelVuDb_) {
+        vu.store(kAudioFloorVu, std::memory_order_relaxed);
+    }
+    idleState_.setHoldNs(static_cast<std::int64_t>(options.idleAfterSeconds * 1'000'000'000.0));
+    for (auto& slot : streams_) {
+        slot = std::make_unique<PipeWireStream>();
+        slot->owner = this;
+    }
+}
+
+AudioCapture::~AudioCapture() { stop(); }
+
+bool AudioCapture::start(QString* errorOut) {
+    if (running_.exchange(true)) {
+        return true;
+    }
+
+    pipewire_ = PipeWireConnection::acquire(errorOut);
+    if (!pipewire_) {
+        running_.store(false, std::memory_order_relaxed);
+        return false;
+    }
+
+    // PipeWire manages the data thread's priority itself; process() reports the result
+    realtimeChecked_ = false;
+
+    PipeWireConnection::Lock lock(*pipewire_);
+
+    PipeWireStream& slot = *streams_[0];
+    activeStream_.store(&slot, std::memory_order_release);
+    if (!connectStream(slot, options_.deviceName, options_.deviceType, errorOut)) {
+        activeStream_.store(nullptr, std::memory_order_release);
+        running_.store(false, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (errorOut) {
+        *errorOut = QString();
+    }
+    return true;
+}
+
+bool AudioCapture::connectStream(PipeWireStream& slot, const QString& deviceName, int deviceType, QString* errorOut) {
+    // Same device naming as the libpulse backend (pipewire-pulse uses node names)
+    QString target = deviceName;
+    bool captureSink = deviceType != 1;
+    if (target.endsWith(kMonitorSuffix)) {
+        target.chop(kMonitorSuffix.size());
+        captureSink = true;
+    }
+
+    pw_properties* props = pw_properties_new(PW_KEY_MEDIA_TYPE,
+                                             "Audio",
+                                             PW_KEY_MEDIA_CATEGORY,
+                                             "Capture",
+                                             PW_KEY_MEDIA_ROLE,
+                                             "DSP",
+                                             PW_KEY_APP_NAME,
+                                             "Analog VU Meter",
+                                             nullptr);
+    pw_properties_setf(props, PW_KEY_NODE_LATENCY, "%u/%d", kQuantumFrames, options_.sampleRate);
+    if (captureSink) {
+        pw_properties_set(props, PW_KEY_STREAM_CAPTURE_SINK, "true");
+    }
+    if (!target.isEmpty()) {
+#if defined(PW_KEY_TARGET_OBJECT)
+        pw_properties_set(props, PW_KEY_TARGET_OBJECT, target.toUtf8().constData());
+#else
+        pw_properties_set(props, PW_KEY_NODE_TARGET, target.toUtf8().constData());
+#endif
+    }
+
+    slot.stream = pw_stream_new(pipewire_->core(), "VU Meter Capture", props);
+    if (!slot.stream) {
+        if (errorOut) {
+            *errorOut = QStringLiteral("Failed to create PipeWire stream");
+        }
+        return false;
+    }
+    slot.deviceUID = deviceName;
+    slot.channels.store(0, std::memory_order_relaxed);
+
+    static const pw_stream_events streamEvents = {
+        .version = PW_VERSION_STREAM_EVENTS,
+        .state_changed = &PipeWireEvents::state_changed,
+        .param_changed = &PipeWireEvents::param_changed,
+        .process = &PipeWireEvents::process,
+    };
+    slot.listener = spa_hook{};
+    pw_stream_add_listener(slot.stream, &slot.listener, &streamEvents, &slot);
+
+    // F32 interleaved at the node's own rate and channel count
+    std::uint8_t podBuffer[1024];
+    spa_pod_builder builder{};
+    spa_pod_builder_init(&builder, podBuffer, sizeof(podBuffer));
+    spa_audio_info_raw info{};
+    info.format = SPA_AUDIO_FORMAT_F32;
+    const spa_pod* params[1] = {spa_format_audio_raw_build(&builder, SPA_PARAM_EnumFormat, &info)};
+
+    // RT_PROCESS: buffers are handled on the realtime data thread, without a hop to the loop thread
+    const auto flags = static_cast<pw_stream_flags>(PW_STREAM_FLAG_AUTOCONNECT | PW_STREAM_FLAG_MAP_BUFFERS |
+                                                    PW_STREAM_FLAG_RT_PROCESS);
+    const int res = pw_stream_connect(slot.stream, PW_DIRECTION_INPUT, PW_ID_ANY, flags, params, 1);
+    if (res < 0) {
+        if (errorOut) {
+            *errorOut =
+                QStringLiteral("Failed to connect PipeWire stream: %1").arg(QString::fromUtf8(spa_strerror(res)));
+        }
+        destroyStream(slot);
+        return false;
+    }
+    return true;
+}
+
+void AudioCapture::destroyStream(PipeWireStream& slot) {
+    // Destroying the stream deactivates its node on the data thread first, so
+    // process() is not running for it once this returns
+    if (!slot.stream) {
+        return;
+    }
+    spa_hook_remove(&slot.listener);
+    pw_stream_destroy(slot.stream);
+    slot.stream = nullptr;
+    slot.channels.store(0, std::memory_order_relaxed);
+}
+
+void AudioCapture::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    if (!pipewire_) {
+        return;
+    }
+
+    {
+        PipeWireConnection::Lock lock(*pipewire_);
+        activeStream_.store(nullptr, std::memory_order_release);
+        incomingStream_.store(nullptr, std::memory_order_release);
+        for (const auto& slot : streams_) {
+            destroyStream(*slot);
+        }
+    }
+
+    // A handover may still have retire_streams queued for this instance; invokes run
+    // in order, so waiting for an empty one drains it
+    pw_loop_invoke(pw_thread_loop_get_loop(pipewire_->loop()),
+                   [](spa_loop*, bool, std::uint32_t, const void*, size_t, void*) { return 0; },
+                   0,
+                   nullptr,
+                   0,
+                   true,
+                   nullptr);
+
+    pipewire_.reset();
+}
+
+bool AudioCapture::switchDevice(const QString& deviceUID, QString* errorOut) {
+    // Stop current capture
+    stop();
+
+    // Reset ballistics and smoothed values
+    dspState_ = VuAudioDspState(options_.jitter, ballisticsProfile());
+    for (auto& vu : channelVuDb_) {
+        vu.store(kAudioFloorVu, std::memory_order_relaxed);
+    }
+
+    // Update options with new device
+    options_.deviceName = deviceUID;
+
+    // Restart with new device
+    bool success = start(errorOut);
+
+    if (success) {
+        currentDeviceUID_ = deviceUID;
+        emit deviceChanged(deviceUID);
+    }
+
+    return success;
+}
+
+bool AudioCapture::switchDeviceAsync(const QString& deviceUID, QString* errorOut) {
+    if (!running_.load(std::memory_order_relaxed) || !pipewire_) {
+        // Nothing is metering, so there is no gap to avoid
+        return switchDevice(deviceUID, errorOut);
+    }
+
+    PipeWireConnection::Lock lock(*pipewire_);
+
+    // The slot that is not active: free, still connecting an earlier switch, or
+    // holding a stream that waits to be retired
+    PipeWireStream* active = activeStream_.load(std::memory_order_acquire);
+    PipeWireStream& slot = (active == streams_[0].get()) ? *streams_[1] : *streams_[0];
+    incomingStream_.store(nullptr, std::memory_order_release);
+    destroyStream(slot);
+
+    // Menu entries are source names, sink monitors included
+    if (!connectStream(slot, deviceUID, 1, errorOut)) {
+        return false;
+    }
+    incomingStream_.store(&slot, std::memory_order_release);
+
+    if (errorOut) {
+        *errorOut = QString();
+    }
+    return true;
+}
+
+QString AudioCapture::currentDeviceUID() const { return currentDeviceUID_; }
+
+double AudioCapture::referenceDbfs() const { return referenceDbfs_.load(std::memory_order_relaxed); }
+
+void AudioCapture::setReferenceDbfs(double value) {
+    options_.referenceDbfs = value;
+    options_.referenceDbfsOverride = true;
+    referenceDbfs_.store(value, std::memory_order_relaxed);
+    referenceDbfsOverride_.store(true, std::memory_order_relaxed);
+}
+
+VuBallisticsProfile AudioCapture::ballisticsProfile() const {
+    std::lock_guard<std::mutex> lock(ballisticsMutex_);
+    return pendingBallistics_;
+}
+
+void AudioCapture::setBallisticsProfile(const VuBallisticsProfile& profile) {
+    std::lock_guard<std::mutex> lock(ballisticsMutex_);
+    pendingBallistics_ = profile;
+    ballisticsVersion_.fetch_add(1, std::memory_order_release);
+}
+
+float AudioCapture::leftVuDb() const { return channelVuDb(0); }
+
+float AudioCapture::rightVuDb() const { return channelVuDb(channelCount() > 1 ? 1 : 0); }
+
+unsigned int AudioCapture::channelCount() const { return channelCount_.load(std::memory_order_relaxed); }
+
+float AudioCapture::channelVuDb(unsigned int channel) const {
+    if (channel >= kVuMaxChannels) {
+        return kAudioFloorVu;
+    }
+    return channelVuDb_[channel].load(std::memory_order_relaxed);
+}
+
+AudioCapture::CaptureStats AudioCapture::stats() const {
+    // PipeWire does not report capture overruns to the stream
+    CaptureStats stats;
+    stats.holes = holes_.load(std::memory_order_relaxed);
+    stats.overflows = overflows_.load(std::memory_order_relaxed);
+    stats.droppedLevels = levelRing_.droppedCount();
+    stats.callbacks = callbackMetrics_.callbacks();
+    stats.worstCallbackNs = callbackMetrics_.worstNs();
+    stats.deadlineMisses = callbackMetrics_.deadlineMisses();
+    stats.realtime = callbackMetrics_.realtime();
+    stats.allocationViolations = AllocationGuard::violations();
+    return stats;
+}
+
+// -------- Device enumeration --------
+
+namespace {
+
+struct AudioNode {
+    QString name;
+    QString description;
+    int channels = 0;
+    bool isSink = false;
+};
+
+struct RegistryScan {
+    pw_registry* registry = nullptr;
+    spa_hook registryListener{};
+
+    pw_metadata* metadata = nullptr;
+    spa_hook metadataListener{};
+
+    QList<AudioNode> nodes;
+    QString defaultSink;
+    QString defaultSource;
+};
+
+// Metadata values look like {"name":"alsa_output.pci-0000_00_1b.0.analog-stereo"}
+QString metadataNodeName(const char* value) {
+    if (!value) {
+        return QString();
+    }
+    return QJsonDocument::fromJson(QByteArray(value)).object().value(QStringLiteral("name")).toString();
+}
+
+int onMetadataProperty(void* userdata, std::uint32_t subject, const char* key, const char* type, const char* value) {
+    (void)subject;
+    (void)type;
+    auto* scan = static_cast<RegistryScan*>(userdata);
+    if (key && std::strcmp(key, "default.audio.sink") == 0) {
+        scan->defaultSink = metadataNodeName(value);
+    } else if (key && std::strcmp(key, "default.audio.source") == 0) {
+        scan->defaultSource = metadataNodeName(value);
+    }
+    return 0;
+}
+
+const pw_metadata_events kMetadataEvents = {
+    .version = PW_VERSION_METADATA_EVENTS,
+    .property = &onMetadataProperty,
+};
+
+void onRegistryGlobal(void* userdata,
+                      std::uint32_t id,
+                      std::uint32_t permissions,
+                      const char* type,
+                      std::uint32_t version,
+                      const spa_dict* props) {
+    (void)permissions;
+    (void)version;
+    auto* scan = static_cast<RegistryScan*>(userdata);
+    if (!type || !props) {
+        return;
+    }
+
+    if (std::strcmp(type, PW_TYPE_INTERFACE_Node) == 0) {
+        const char* mediaClass = spa_dict_lookup(props, PW_KEY_MEDIA_CLASS);
+        const char* name = spa_dict_lookup(props, PW_KEY_NODE_NAME);
+        if (!mediaClass || !name) {
+            return;
+        }
+
+        const bool isSink = std::strcmp(mediaClass, "Audio/Sink") == 0;
+        if (!isSink && std::strcmp(mediaClass, "Audio/Source") != 0) {
+            return;
+        }
+
+        AudioNode node;
+        node.name = QString::fromUtf8(name);
+        const char* description = spa_dict_lookup(props, PW_KEY_NODE_DESCRIPTION);
+        node.description = description ? QString::fromUtf8(description) : node.name;
+        const char* channels = spa_dict_lookup(props, PW_KEY_AUDIO_CHANNELS);
+        node.channels = channels ? std::atoi(channels) : 0;
+        node.isSink = isSink;
+        scan->nodes.append(node);
+    } else if (std::strcmp(type, PW_TYPE_INTERFACE_Metadata) == 0 && !scan->metadata) {
+        const char* metadataName = spa_dict_lookup(props, PW_KEY_METADATA_NAME);
+        if (metadataName && std::strcmp(metadataName, "default") == 0) {
+            scan->metadata =
+                static_cast<pw_metadata*>(pw_registry_bind(scan->registry, id, type, PW_VERSION_METADATA, 0));
+            if (scan->metadata) {
+                pw_metadata_add_listener(scan->metadata, &scan->metadataListener, &kMetadataEvents, scan);
+            }
+        }
+    }
+}
+
+const pw_registry_events kRegistryEvents = {
+    .version = PW_VERSION_REGISTRY_EVENTS,
+    .global = &onRegistryGlobal,
+};
+
+// Collects the audio nodes and the default sink/source. Returns false if PipeWire
+// is not reachable.
+bool scanRegistry(RegistryScan& scan) {
+    std::shared_ptr<PipeWireConnection> pipewire = PipeWireConnection::acquire();
+    if (!pipewire) {
+        return false;
+    }
+
+    PipeWireConnection::Lock lock(*pipewire);
+
+    scan.registry = pw_core_get_registry(pipewire->core(), PW_VERSION_REGISTRY, 0);
+    if (!scan.registry) {
+        return false;
+    }
+    pw_registry_add_listener(scan.registry, &scan.registryListener, &kRegistryEvents, &scan);
+
+    // First for the globals, then for the properties of the metadata bound meanwhile
+    const bool ok = pipewire->roundtrip() && pipewire->roundtrip();
+
+    if (scan.metadata) {
+        spa_hook_remove(&scan.metadataListener);
+        pw_proxy_destroy(reinterpret_cast<pw_proxy*>(scan.metadata));
+        scan.metadata = nullptr;
+    }
+    spa_hook_remove(&scan.registryListener);
+    pw_proxy_destroy(reinterpret_cast<pw_proxy*>(scan.registry));
+    scan.registry = nullptr;
+
+    return ok;
+}
+
+} // namespace
+
+QString AudioCapture::listDevicesString() {
+    QString out;
+    out += "PipeWire devices:\n\n";
+
+    RegistryScan scan;
+    if (!scanRegistry(scan)) {
+        return "Failed to connect to PipeWire\n";
+    }
+
+    QString sinks;
+    QString sources;
+    for (const AudioNode& node : scan.nodes) {
+        if (node.isSink) {
+            const bool isDefault = (node.name == scan.defaultSink);
+            sinks.append(QString("Sink: %1%2\n").arg(node.name).arg(isDefault ? "   [DEFAULT]" : ""));
+            sinks.append(QString("  Description: %1\n").arg(node.description));
+            sinks.append(QString("  Monitor source: %1\n\n").arg(node.name + kMonitorSuffix));
+        } else {
+            const bool isDefault = (node.name == scan.defaultSource);
+            sources.append(QString("Source: %1%2\n").arg(node.name).arg(isDefault ? "   [DEFAULT]" : ""));
+            sources.append(QString("  Description: %1\n\n").arg(node.description));
+        }
+    }
+
+    out += "=== Output Sinks ===\n";
+    out += sinks;
+    out += "=== Input Sources ===\n";
+    out += sources;
+
+    out += "\nUsage:\n";
+    out += "  --device-type 0   Use system output (sink monitor)\n";
+    out += "  --device-type 1   Use microphone input (source)\n";
+    out += "  --device-name <name>   Use specific sink or source\n";
+
+    return out;
+}
+
+// -------- DSP --------
+
+void AudioCapture::processAudioBuffer(
+    const float* data, unsigned int frames, unsigned int channels, float sampleRate, std::int64_t blockEndNs) {
+    VuReferenceOptions ref;
+    ref.referenceDbfs = referenceDbfs_.load(std::memory_order_relaxed);
+    ref.referenceDbfsOverride = referenceDbfsOverride_.load(std::memory_order_relaxed);
+    ref.deviceType = options_.deviceType;
+
+    if (vuScratch_.size() != channels) {
+        return; // format change still in flight; param_changed sizes the state
+    }
+
+    // A profile change is picked up by a later block if the GUI thread holds the lock
+    const unsigned int ballisticsVersion = ballisticsVersion_.load(std::memory_order_acquire);
+    if (ballisticsVersion != appliedBallisticsVersion_) {
+        std::unique_lock<std::mutex> lock(ballisticsMutex_, std::try_to_lock);
+        if (lock.owns_lock()) {
+            dspState_.setBallisticsProfile(pendingBallistics_);
+            appliedBallisticsVersion_ = ballisticsVersion;
+        }
+    }
+
+    // Nothing below may allocate: it runs on the (possibly realtime) audio thread
+    AllocationGuard allocationGuard;
+
+    if (options_.controlRateHz > 0.0) {
+        processInterleavedFloatAudioToVuDbFixedRate(data,
+                                                    frames,
+                                                    channels,
+                                                    sampleRate,
+                                                    static_cast<float>(options_.controlRateHz),
+                                                    ref,
+                                                    dspState_,
+                                                    kAudioFloorVu,
+                                                    kAudioCeilingVu,
+                                                    vuScratch_.data());
+    } else {
+        processInterleavedFloatAudioToVuDb(
+            data, frames, channels, sampleRate, ref, dspState_, kAudioFloorVu, kAudioCeilingVu, vuScratch_.data());
+    }
+
+    LevelSample sample;
+    sample.timeNs = blockEndNs;
+    sample.channels = std::min(channels, kVuMaxChannels);
+    for (unsigned int c = 0; c < sample.channels; ++c) {
+        sample.vu[c] = vuScratch_[c];
+        sample.peakDbfs[c] = dspState_.peakDbfs[c];
+        channelVuDb_[c].store(vuScratch_[c], std::memory_order_relaxed);
+    }
+    channelCount_.store(sample.channels, std::memory_order_relaxed);
+    levelRing_.push(sample);
+
+    const auto blockNs = static_cast<std::int64_t>(static_cast<double>(frames) * 1e9 / sampleRate);
+    if (idleState_.update(dspState_, vuScratch_.data(), sample.channels, blockNs)) {
+        idleChanged_ = true;
+    }
+}
+
+#endif // __linux__ && ANALOGVU_HAS_PIPEWIRE
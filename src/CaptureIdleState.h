@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "VuAudioDsp.h"
+
+// Silence detection for the power-saving idle mode of one capture.
+//
+// update() is called by the audio thread after every processed block. The capture
+// goes idle once every channel has stayed below the DSP's wake threshold, with every
+// needle resting below the scale, for the configured hold time; the first block with
+// signal above the threshold wakes it again. While idle the backends ask for larger
+// capture blocks and the UI stops producing frames; other threads read idle().
+class CaptureIdleState final {
+  public:
+    // Needles below this rest against the stop of every scale
+    static constexpr float kRestVu = -30.0f;
+
+    // 0 = never go idle
+    void setHoldNs(std::int64_t holdNs) noexcept { holdNs_ = holdNs; }
+
+    // Returns true when this block changed the idle state
+    bool update(const VuAudioDspState& dsp, const float* vu, unsigned int channels, std::int64_t blockNs) noexcept {
+        bool quiet = holdNs_ > 0;
+        for (unsigned int c = 0; quiet && c < channels; ++c) {
+            quiet = dsp.peak[c] <= kVuWakeThreshold && vu[c] <= kRestVu;
+        }
+
+        quietNs_ = quiet ? quietNs_ + blockNs : 0;
+        const bool idle = quiet && quietNs_ >= holdNs_;
+        if (idle == idle_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        idle_.store(idle, std::memory_order_relaxed); // single writer
+        return true;
+    }
+
+    // New stream or device: start out awake
+    void reset() noexcept {
+        quietNs_ = 0;
+        idle_.store(false, std::memory_order_relaxed);
+    }
+
+    bool idle() const noexcept { return idle_.load(std::memory_order_relaxed); }
+
+  private:
+    std::int64_t holdNs_ = 0;
+    std::int64_t quietNs_ = 0; // audio thread only
+    std::atomic<bool> idle_{false};
+};
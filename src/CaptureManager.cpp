@@ -0,0 +1,61 @@
+#include "CaptureManager.h"
+
+#if defined(ANALOGVU_HAS_PIPEWIRE) && (ANALOGVU_HAS_PIPEWIRE == 1)
+#include "PipeWireConnection.h"
+#elif defined(__linux__)
+#include "PulseConnection.h"
+#endif
+
+#include <algorithm>
+
+CaptureManager::CaptureManager() = default;
+
+CaptureManager::~CaptureManager() {
+    stopAll();
+    captures_.clear();
+}
+
+AudioCapture* CaptureManager::addCapture(const AudioCapture::Options& options) {
+    captures_.push_back(std::make_unique<AudioCapture>(options));
+    return captures_.back().get();
+}
+
+void CaptureManager::retainConnection() {
+    // A failure here is reported, with its reason, by AudioCapture::start()
+#if defined(ANALOGVU_HAS_PIPEWIRE) && (ANALOGVU_HAS_PIPEWIRE == 1)
+    if (!pipewire_) {
+        pipewire_ = PipeWireConnection::acquire();
+    }
+#elif defined(__linux__)
+    if (!pulse_ || pulse_->isFailed()) {
+        pulse_ = PulseConnection::acquire();
+    }
+#endif
+}
+
+void CaptureManager::removeCapture(AudioCapture* capture) {
+    auto it = std::find_if(captures_.begin(), captures_.end(), [capture](const std::unique_ptr<AudioCapture>& c) {
+        return c.get() == capture;
+    });
+    if (it == captures_.end()) {
+        return;
+    }
+
+    (*it)->stop();
+    captures_.erase(it);
+}
+
+QList<AudioCapture*> CaptureManager::captures() const {
+    QList<AudioCapture*> result;
+    result.reserve(static_cast<qsizetype>(captures_.size()));
+    for (const auto& c : captures_) {
+        result.append(c.get());
+    }
+    return result;
+}
+
+void CaptureManager::stopAll() {
+    for (const auto& c : captures_) {
+        c->stop();
+    }
+}
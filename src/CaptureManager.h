@@ -0,0 +1,58 @@
+#pragma once
+
+#include "AudioCapture.h"
+
+#include <QList>
+#include <QString>
+
+#include <memory>
+#include <vector>
+
+#if defined(ANALOGVU_HAS_PIPEWIRE) && (ANALOGVU_HAS_PIPEWIRE == 1)
+class PipeWireConnection;
+#elif defined(__linux__)
+class PulseConnection;
+#endif
+
+// Owns every capture stream of the process, so several sinks/sources can be
+// metered at once.
+//
+// On Linux all of them run on the one shared PulseAudio connection (a single
+// pa_threaded_mainloop thread, see PulseConnection), or PipeWireConnection with
+// the native PipeWire backend; once retainConnection() has been called the manager
+// holds a reference to it, so that switching the device of the last running stream
+// does not tear the connection down and reconnect. On macOS each stream is its own
+// HAL IOProc.
+class CaptureManager {
+  public:
+    CaptureManager();
+    ~CaptureManager();
+
+    CaptureManager(const CaptureManager&) = delete;
+    CaptureManager& operator=(const CaptureManager&) = delete;
+
+    // Creates a capture; the caller starts it (and decides what a failed start means).
+    // Does not touch the audio server.
+    AudioCapture* addCapture(const AudioCapture::Options& options);
+
+    // Keeps the shared connection alive from now on. Connects if there is none,
+    // which blocks, so call it where start() is called (any thread, not concurrently
+    // with the destructor). Nothing to do on macOS.
+    void retainConnection();
+    void removeCapture(AudioCapture* capture);
+
+    int count() const { return static_cast<int>(captures_.size()); }
+    AudioCapture* capture(int index) const { return captures_[static_cast<size_t>(index)].get(); }
+    QList<AudioCapture*> captures() const;
+
+    void stopAll();
+
+  private:
+    std::vector<std::unique_ptr<AudioCapture>> captures_;
+
+#if defined(ANALOGVU_HAS_PIPEWIRE) && (ANALOGVU_HAS_PIPEWIRE == 1)
+    std::shared_ptr<PipeWireConnection> pipewire_;
+#elif defined(__linux__)
+    std::shared_ptr<PulseConnection> pulse_;
+#endif
+};
@@ -0,0 +1,19 @@
+#include "DeviceRegistry.h"
+
+QList<AudioCapture::DeviceInfo> DeviceRegistry::devices() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return devices_;
+}
+
+void DeviceRegistry::publish(const QList<AudioCapture::DeviceInfo>& devices) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Servers report many events (volume, ports) that leave the list as it was
+        if (scanned_ && devices == devices_) {
+            return;
+        }
+        devices_ = devices;
+        scanned_ = true;
+    }
+    emit devicesChanged();
+}
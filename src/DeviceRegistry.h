@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QList>
+#include <QObject>
+#include <QString>
+
+#include <memory>
+#include <mutex>
+
+#include "AudioCapture.h"
+
+// Cached list of the capture devices, kept current by the audio server.
+//
+// Holds one persistent connection (the shared PulseConnection or
+// PipeWireConnection on Linux, HAL property listeners on macOS), follows device
+// hotplug and default-device changes off the GUI thread, and rescans there. The
+// GUI reads the cached list without ever waiting on the server and rebuilds its
+// menus on devicesChanged().
+class DeviceRegistry final : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit DeviceRegistry(QObject* parent = nullptr);
+    ~DeviceRegistry() override;
+
+    // Connects, subscribes to device events and starts the first scan. Returns
+    // without waiting for it; devicesChanged() follows once the list is known.
+    bool start(QString* errorOut = nullptr);
+    void stop();
+
+    // Rescans without waiting for a change notification
+    void refresh();
+
+    // Snapshot of the cached list (a shared copy, cheap to take)
+    QList<AudioCapture::DeviceInfo> devices() const;
+
+  signals:
+    // Emitted from the backend's event thread (the GUI thread with libpulse); receivers
+    // on the GUI thread get it queued
+    void devicesChanged();
+
+  private:
+    // Platform connection and subscription state, defined next to each backend
+    struct Backend;
+
+    // Replaces the cached list and signals if it differs (any thread)
+    void publish(const QList<AudioCapture::DeviceInfo>& devices);
+
+    std::unique_ptr<Backend> backend_;
+
+    mutable std::mutex mutex_;
+    QList<AudioCapture::DeviceInfo> devices_;
+    bool scanned_ = false;
+};
@@ -0,0 +1,245 @@
+#if defined(__linux__)
+
+#include "DeviceRegistry.h"
+#include "PulseConnection.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include <pulse/pulseaudio.h>
+
+// Everything below runs on the shared mainloop thread, or with its lock held.
+// A scan is two chained requests: server info (for the default source), then the
+// source list, which includes the sink monitors. Events that arrive while a scan
+// is in flight only mark it stale, so a burst of hotplug events costs one rescan.
+//
+// The mainloop thread also runs every capture callback, possibly at realtime
+// priority, so it only copies the raw names into fixed buffers. A finished scan is
+// handed over under `readyMutex`, and the QStrings and the device list are built
+// on the GUI thread.
+//
+// The registry owns the context's subscription: a context has a single subscribe
+// callback, and no capture stream uses it.
+struct DeviceRegistry::Backend {
+    static constexpr int kMaxSources = 64;       // further sources are left out of the list
+    static constexpr std::size_t kMaxName = 256; // bytes, longer names are cut
+
+    struct RawSource {
+        char name[kMaxName];
+        char description[kMaxName];
+        int channels = 0;
+    };
+
+    struct RawScan {
+        char defaultSource[kMaxName] = {};
+        std::array<RawSource, kMaxSources> sources;
+        int count = 0;
+    };
+
+    std::shared_ptr<PulseConnection> pulse;
+    pa_operation* op = nullptr;
+    bool rescan = false;
+    RawScan scanning; // mainloop thread
+
+    std::mutex readyMutex;
+    RawScan ready;
+    bool readyPosted = false; // a conversion is queued on the GUI thread
+
+    void scan(DeviceRegistry* registry);
+    void handOver(DeviceRegistry* registry);
+    QList<AudioCapture::DeviceInfo> takeReady();
+
+    static void subscribe_callback(pa_context* c, pa_subscription_event_type_t t, uint32_t idx, void* userdata);
+    static void server_info_callback(pa_context* c, const pa_server_info* info, void* userdata);
+    static void source_info_callback(pa_context* c, const pa_source_info* info, int eol, void* userdata);
+};
+
+// Zero-terminated, truncated copy of a libpulse string (which may be null)
+template <std::size_t N>
+static void copyName(char (&out)[N], const char* in) {
+    if (!in) {
+        out[0] = '\0';
+        return;
+    }
+    std::strncpy(out, in, sizeof(out) - 1);
+    out[sizeof(out) - 1] = '\0';
+}
+
+DeviceRegistry::DeviceRegistry(QObject* parent) : QObject(parent), backend_(std::make_unique<Backend>()) {}
+
+DeviceRegistry::~DeviceRegistry() { stop(); }
+
+bool DeviceRegistry::start(QString* errorOut) {
+    if (backend_->pulse) {
+        return true;
+    }
+
+    backend_->pulse = PulseConnection::acquire(errorOut);
+    if (!backend_->pulse) {
+        return false;
+    }
+
+    PulseConnection::Lock lock(*backend_->pulse);
+    pa_context* c = backend_->pulse->context();
+
+    pa_context_set_subscribe_callback(c, &Backend::subscribe_callback, this);
+    const auto mask = static_cast<pa_subscription_mask_t>(PA_SUBSCRIPTION_MASK_SOURCE | PA_SUBSCRIPTION_MASK_SERVER);
+    pa_operation* op = pa_context_subscribe(c, mask, nullptr, nullptr);
+    if (op) {
+        pa_operation_unref(op);
+    }
+
+    backend_->scan(this);
+
+    if (errorOut) {
+        *errorOut = QString();
+    }
+    return true;
+}
+
+void DeviceRegistry::stop() {
+    if (!backend_->pulse) {
+        return;
+    }
+
+    {
+        PulseConnection::Lock lock(*backend_->pulse);
+        pa_context* c = backend_->pulse->context();
+
+        pa_context_set_subscribe_callback(c, nullptr, nullptr);
+        pa_operation* op = pa_context_subscribe(c, PA_SUBSCRIPTION_MASK_NULL, nullptr, nullptr);
+        if (op) {
+            pa_operation_unref(op);
+        }
+
+        if (backend_->op) {
+            pa_operation_cancel(backend_->op);
+            pa_operation_unref(backend_->op);
+            backend_->op = nullptr;
+        }
+        backend_->rescan = false;
+    }
+
+    backend_->pulse.reset();
+}
+
+void DeviceRegistry::refresh() {
+    if (!backend_->pulse) {
+        return;
+    }
+    PulseConnection::Lock lock(*backend_->pulse);
+    backend_->scan(this);
+}
+
+void DeviceRegistry::Backend::scan(DeviceRegistry* registry) {
+    if (op) {
+        rescan = true;
+        return;
+    }
+    scanning.count = 0;
+    op = pa_context_get_server_info(pulse->context(), &Backend::server_info_callback, registry);
+}
+
+void DeviceRegistry::Backend::subscribe_callback(pa_context* c,
+                                                 pa_subscription_event_type_t t,
+                                                 uint32_t idx,
+                                                 void* userdata) {
+    (void)c;
+    (void)idx;
+    auto* registry = static_cast<DeviceRegistry*>(userdata);
+
+    // Sources come and go; a server change is how a new default is announced.
+    // Source "change" events are mostly volume and port updates.
+    const unsigned int facility = t & PA_SUBSCRIPTION_EVENT_FACILITY_MASK;
+    const unsigned int type = t & PA_SUBSCRIPTION_EVENT_TYPE_MASK;
+    if ((facility == PA_SUBSCRIPTION_EVENT_SOURCE && type != PA_SUBSCRIPTION_EVENT_CHANGE) ||
+        facility == PA_SUBSCRIPTION_EVENT_SERVER) {
+        registry->backend_->scan(registry);
+    }
+}
+
+void DeviceRegistry::Backend::server_info_callback(pa_context* c, const pa_server_info* info, void* userdata) {
+    auto* registry = static_cast<DeviceRegistry*>(userdata);
+    Backend& backend = *registry->backend_;
+
+    copyName(backend.scanning.defaultSource, info ? info->default_source_name : nullptr);
+
+    pa_operation_unref(backend.op);
+    backend.op = pa_context_get_source_info_list(c, &Backend::source_info_callback, registry);
+}
+
+void DeviceRegistry::Backend::source_info_callback(pa_context* c, const pa_source_info* info, int eol, void* userdata) {
+    (void)c;
+    auto* registry = static_cast<DeviceRegistry*>(userdata);
+    Backend& backend = *registry->backend_;
+
+    if (eol == 0 && info) {
+        RawScan& scan = backend.scanning;
+        if (scan.count < kMaxSources) {
+            RawSource& source = scan.sources[static_cast<std::size_t>(scan.count++)];
+            copyName(source.name, info->name);
+            copyName(source.description, info->description);
+            source.channels = static_cast<int>(info->sample_spec.channels);
+        }
+        return;
+    }
+
+    pa_operation_unref(backend.op);
+    backend.op = nullptr;
+
+    // A failed scan keeps the previous list
+    if (eol > 0) {
+        backend.handOver(registry);
+    }
+    if (backend.rescan) {
+        backend.rescan = false;
+        backend.scan(registry);
+    }
+}
+
+void DeviceRegistry::Backend::handOver(DeviceRegistry* registry) {
+    bool post = false;
+    {
+        std::lock_guard<std::mutex> lock(readyMutex);
+        std::memcpy(ready.defaultSource, scanning.defaultSource, sizeof(ready.defaultSource));
+        std::copy_n(scanning.sources.begin(), scanning.count, ready.sources.begin());
+        ready.count = scanning.count;
+        post = !readyPosted;
+        readyPosted = true;
+    }
+
+    // A scan that completes before the GUI got to the previous one only replaces it
+    if (post) {
+        QMetaObject::invokeMethod(
+            registry, [registry] { registry->publish(registry->backend_->takeReady()); }, Qt::QueuedConnection);
+    }
+}
+
+QList<AudioCapture::DeviceInfo> DeviceRegistry::Backend::takeReady() {
+    RawScan scan;
+    {
+        std::lock_guard<std::mutex> lock(readyMutex);
+        std::memcpy(scan.defaultSource, ready.defaultSource, sizeof(scan.defaultSource));
+        std::copy_n(ready.sources.begin(), ready.count, scan.sources.begin());
+        scan.count = ready.count;
+        readyPosted = false;
+    }
+
+    const QString defaultSource = QString::fromUtf8(scan.defaultSource);
+    QList<AudioCapture::DeviceInfo> devices;
+    devices.reserve(scan.count);
+    for (int i = 0; i < scan.count; ++i) {
+        const RawSource& source = scan.sources[static_cast<std::size_t>(i)];
+        AudioCapture::DeviceInfo device;
+        device.name = QString::fromUtf8(source.description);
+        device.uid = QString::fromUtf8(source.name);
+        device.channels = source.channels;
+        device.isInput = true;
+        device.isDefault = (device.uid == defaultSource);
+        devices.append(device);
+    }
+    return devices;
+}
+
+#endif // __linux__
@@ -0,0 +1,203 @@
+#if defined(__APPLE__)
+
+#include "DeviceRegistry.h"
+
+#include <atomic>
+#include <vector>
+
+#include <CoreAudio/CoreAudio.h>
+#include <dispatch/dispatch.h>
+
+// HAL notifications arrive on a HAL thread; each one queues a scan on a serial
+// dispatch queue (at most one waiting), so the GUI thread never queries CoreAudio.
+struct DeviceRegistry::Backend {
+    dispatch_queue_t queue = nullptr;
+    std::atomic<bool> listening{false};
+    std::atomic<bool> scanQueued{false};
+
+    void queueScan(DeviceRegistry* registry);
+
+    static void scan(void* context);
+    static OSStatus systemPropertyListener(AudioObjectID inObjectID,
+                                           UInt32 inNumberAddresses,
+                                           const AudioObjectPropertyAddress* inAddresses,
+                                           void* inClientData);
+};
+
+// Device hotplug (aggregates and loopback drivers included) and default input changes
+static const AudioObjectPropertyAddress kSystemListenerAddresses[] = {
+    {kAudioHardwarePropertyDevices, kAudioObjectPropertyScopeGlobal, kAudioObjectPropertyElementMain},
+    {kAudioHardwarePropertyDefaultInputDevice, kAudioObjectPropertyScopeGlobal, kAudioObjectPropertyElementMain},
+};
+
+static QList<AudioCapture::DeviceInfo> scanInputDevices() {
+    QList<AudioCapture::DeviceInfo> result;
+
+    AudioObjectPropertyAddress propertyAddress = {
+        kAudioHardwarePropertyDevices, kAudioObjectPropertyScopeGlobal, kAudioObjectPropertyElementMain};
+
+    UInt32 dataSize = 0;
+    OSStatus status = AudioObjectGetPropertyDataSize(kAudioObjectSystemObject, &propertyAddress, 0, nullptr, &dataSize);
+
+    if (status != noErr) {
+        return result;
+    }
+
+    UInt32 deviceCount = dataSize / sizeof(AudioDeviceID);
+    std::vector<AudioDeviceID> devices(deviceCount);
+
+    status =
+        AudioObjectGetPropertyData(kAudioObjectSystemObject, &propertyAddress, 0, nullptr, &dataSize, devices.data());
+
+    if (status != noErr) {
+        return result;
+    }
+
+    // Get default input device
+    AudioDeviceID defaultInput = 0;
+    propertyAddress.mSelector = kAudioHardwarePropertyDefaultInputDevice;
+    dataSize = sizeof(defaultInput);
+    AudioObjectGetPropertyData(kAudioObjectSystemObject, &propertyAddress, 0, nullptr, &dataSize, &defaultInput);
+
+    for (AudioDeviceID deviceID : devices) {
+        // Check if device has input channels
+        propertyAddress.mSelector = kAudioDevicePropertyStreamConfiguration;
+        propertyAddress.mScope = kAudioDevicePropertyScopeInput;
+
+        dataSize = 0;
+        status = AudioObjectGetPropertyDataSize(deviceID, &propertyAddress, 0, nullptr, &dataSize);
+        if (status != noErr)
+            continue;
+
+        std::vector<UInt8> bufferListData(dataSize);
+        AudioBufferList* bufferList = reinterpret_cast<AudioBufferList*>(bufferListData.data());
+
+        status = AudioObjectGetPropertyData(deviceID, &propertyAddress, 0, nullptr, &dataSize, bufferList);
+        if (status != noErr)
+            continue;
+
+        UInt32 inputChannels = 0;
+        for (UInt32 i = 0; i < bufferList->mNumberBuffers; ++i) {
+            inputChannels += bufferList->mBuffers[i].mNumberChannels;
+        }
+
+        if (inputChannels > 0) {
+            AudioCapture::DeviceInfo info;
+            info.channels = static_cast<int>(inputChannels);
+            info.isInput = true;
+            info.isDefault = (deviceID == defaultInput);
+
+            // Get device name
+            CFStringRef deviceName = nullptr;
+            propertyAddress.mSelector = kAudioDevicePropertyDeviceNameCFString;
+            propertyAddress.mScope = kAudioObjectPropertyScopeGlobal;
+            dataSize = sizeof(deviceName);
+            if (AudioObjectGetPropertyData(deviceID, &propertyAddress, 0, nullptr, &dataSize, &deviceName) == noErr &&
+                deviceName) {
+                info.name = QString::fromCFString(deviceName);
+                CFRelease(deviceName);
+            } else {
+                info.name = "Unknown Device";
+            }
+
+            // Get device UID
+            CFStringRef deviceUID = nullptr;
+            propertyAddress.mSelector = kAudioDevicePropertyDeviceUID;
+            dataSize = sizeof(deviceUID);
+            if (AudioObjectGetPropertyData(deviceID, &propertyAddress, 0, nullptr, &dataSize, &deviceUID) == noErr &&
+                deviceUID) {
+                info.uid = QString::fromCFString(deviceUID);
+                CFRelease(deviceUID);
+            }
+
+            result.append(info);
+        }
+    }
+
+    return result;
+}
+
+DeviceRegistry::DeviceRegistry(QObject* parent) : QObject(parent), backend_(std::make_unique<Backend>()) {
+    backend_->queue = dispatch_queue_create("analogvu.device-registry", DISPATCH_QUEUE_SERIAL);
+}
+
+DeviceRegistry::~DeviceRegistry() {
+    stop();
+    dispatch_release(backend_->queue);
+}
+
+bool DeviceRegistry::start(QString* errorOut) {
+    if (backend_->listening.exchange(true)) {
+        return true;
+    }
+
+    for (const auto& address : kSystemListenerAddresses) {
+        const OSStatus status = AudioObjectAddPropertyListener(
+            kAudioObjectSystemObject, &address, &Backend::systemPropertyListener, this);
+        if (status != noErr) {
+            stop();
+            if (errorOut) {
+                *errorOut = QStringLiteral("Failed to watch CoreAudio devices: %1").arg(status);
+            }
+            return false;
+        }
+    }
+
+    backend_->queueScan(this);
+
+    if (errorOut) {
+        *errorOut = QString();
+    }
+    return true;
+}
+
+void DeviceRegistry::stop() {
+    if (!backend_->listening.exchange(false)) {
+        return;
+    }
+
+    for (const auto& address : kSystemListenerAddresses) {
+        AudioObjectRemovePropertyListener(kAudioObjectSystemObject, &address, &Backend::systemPropertyListener, this);
+    }
+
+    // Waits for a scan that is already running
+    dispatch_sync_f(backend_->queue, nullptr, [](void*) {});
+}
+
+void DeviceRegistry::refresh() {
+    if (backend_->listening.load()) {
+        backend_->queueScan(this);
+    }
+}
+
+void DeviceRegistry::Backend::queueScan(DeviceRegistry* registry) {
+    if (!scanQueued.exchange(true)) {
+        dispatch_async_f(queue, registry, &Backend::scan);
+    }
+}
+
+void DeviceRegistry::Backend::scan(void* context) {
+    auto* registry = static_cast<DeviceRegistry*>(context);
+    Backend& backend = *registry->backend_;
+
+    // Cleared first: a notification during the scan queues the next one
+    backend.scanQueued.store(false);
+    if (!backend.listening.load()) {
+        return;
+    }
+    registry->publish(scanInputDevices());
+}
+
+OSStatus DeviceRegistry::Backend::systemPropertyListener(AudioObjectID inObjectID,
+                                                         UInt32 inNumberAddresses,
+                                                         const AudioObjectPropertyAddress* inAddresses,
+                                                         void* inClientData) {
+    (void)inObjectID;
+    (void)inNumberAddresses;
+    (void)inAddresses;
+    auto* registry = static_cast<DeviceRegistry*>(inClientData);
+    registry->backend_->queueScan(registry);
+    return noErr;
+}
+
+#endif // __APPLE__
@@ -0,0 +1,294 @@
+#if defined(__linux__) && defined(ANALOGVU_HAS_PIPEWIRE) && (ANALOGVU_HAS_PIPEWIRE == 1)
+
+#include "DeviceRegistry.h"
+#include "PipeWireConnection.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+#include <QByteArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <pipewire/extensions/metadata.h>
+#include <pipewire/pipewire.h>
+
+// Same naming as the capture backend: a sink is metered through "<sink name>.monitor"
+static const QString kMonitorSuffix = QStringLiteral(".monitor");
+
+// Everything below runs on the PipeWire loop thread, or with its lock held. The
+// registry stays bound for the registry's lifetime, so node globals keep arriving
+// as devices come and go. Each change requests a core sync, and the list is only
+// published when it completes: the burst of globals at startup, or from a newly
+// plugged card, ends up as one update.
+struct DeviceRegistry::Backend {
+    struct Node {
+        QString name;
+        QString description;
+        int channels = 0;
+        bool isSink = false;
+    };
+
+    std::shared_ptr<PipeWireConnection> pipewire;
+
+    pw_registry* registry = nullptr;
+    spa_hook registryListener{};
+    spa_hook coreListener{};
+
+    pw_metadata* metadata = nullptr;
+    std::uint32_t metadataId = SPA_ID_INVALID;
+    spa_hook metadataListener{};
+
+    std::map<std::uint32_t, Node> nodes;
+    QString defaultSource;
+
+    int syncSeq = 0;
+    bool syncPending = false;
+
+    void scheduleUpdate();
+    QList<AudioCapture::DeviceInfo> deviceList() const;
+    void destroyMetadata();
+
+    static void on_core_done(void* userdata, std::uint32_t id, int seq);
+    static void on_global(void* userdata,
+                          std::uint32_t id,
+                          std::uint32_t permissions,
+                          const char* type,
+                          std::uint32_t version,
+                          const spa_dict* props);
+    static void on_global_remove(void* userdata, std::uint32_t id);
+    static int on_metadata_property(
+        void* userdata, std::uint32_t subject, const char* key, const char* type, const char* value);
+};
+
+// Metadata values look like {"name":"alsa_input.pci-0000_00_1b.0.analog-stereo"}
+static QString metadataNodeName(const char* value) {
+    if (!value) {
+        return QString();
+    }
+    return QJsonDocument::fromJson(QByteArray(value)).object().value(QStringLiteral("name")).toString();
+}
+
+DeviceRegistry::DeviceRegistry(QObject* parent) : QObject(parent), backend_(std::make_unique<Backend>()) {}
+
+DeviceRegistry::~DeviceRegistry() { stop(); }
+
+bool DeviceRegistry::start(QString* errorOut) {
+    if (backend_->pipewire) {
+        return true;
+    }
+
+    backend_->pipewire = PipeWireConnection::acquire(errorOut);
+    if (!backend_->pipewire) {
+        return false;
+    }
+
+    static const pw_core_events coreEvents = {
+        .version = PW_VERSION_CORE_EVENTS,
+        .done = &Backend::on_core_done,
+    };
+    static const pw_registry_events registryEvents = {
+        .version = PW_VERSION_REGISTRY_EVENTS,
+        .global = &Backend::on_global,
+        .global_remove = &Backend::on_global_remove,
+    };
+
+    PipeWireConnection::Lock lock(*backend_->pipewire);
+
+    backend_->registry = pw_core_get_registry(backend_->pipewire->core(), PW_VERSION_REGISTRY, 0);
+    if (!backend_->registry) {
+        if (errorOut) {
+            *errorOut = QStringLiteral("Failed to get the PipeWire registry");
+        }
+        backend_->pipewire.reset();
+        return false;
+    }
+
+    backend_->coreListener = spa_hook{};
+    pw_core_add_listener(backend_->pipewire->core(), &backend_->coreListener, &coreEvents, this);
+    backend_->registryListener = spa_hook{};
+    pw_registry_add_listener(backend_->registry, &backend_->registryListener, &registryEvents, this);
+
+    // Publishes even a system without any audio node
+    backend_->scheduleUpdate();
+
+    if (errorOut) {
+        *errorOut = QString();
+    }
+    return true;
+}
+
+void DeviceRegistry::stop() {
+    if (!backend_->pipewire) {
+        return;
+    }
+
+    {
+        PipeWireConnection::Lock lock(*backend_->pipewire);
+        backend_->destroyMetadata();
+        spa_hook_remove(&backend_->registryListener);
+        pw_proxy_destroy(reinterpret_cast<pw_proxy*>(backend_->registry));
+        backend_->registry = nullptr;
+        spa_hook_remove(&backend_->coreListener);
+
+        backend_->nodes.clear();
+        backend_->defaultSource.clear();
+        backend_->syncPending = false;
+    }
+
+    backend_->pipewire.reset();
+}
+
+void DeviceRegistry::refresh() {
+    // The registry pushes every change; republish what it holds
+    if (!backend_->pipewire) {
+        return;
+    }
+    PipeWireConnection::Lock lock(*backend_->pipewire);
+    backend_->scheduleUpdate();
+}
+
+void DeviceRegistry::Backend::scheduleUpdate() {
+    if (syncPending) {
+        return;
+    }
+    syncSeq = pw_core_sync(pipewire->core(), PW_ID_CORE, 0);
+    syncPending = true;
+}
+
+QList<AudioCapture::DeviceInfo> DeviceRegistry::Backend::deviceList() const {
+    QList<AudioCapture::DeviceInfo> result;
+
+    // Sources first, then sink monitors, as the libpulse backend lists them
+    for (const auto& [id, node] : nodes) {
+        if (node.isSink) {
+            continue;
+        }
+        AudioCapture::DeviceInfo device;
+        device.name = node.description;
+        device.uid = node.name;
+        device.channels = node.channels;
+        device.isInput = true;
+        device.isDefault = (node.name == defaultSource);
+        result.append(device);
+    }
+    for (const auto& [id, node] : nodes) {
+        if (!node.isSink) {
+            continue;
+        }
+        AudioCapture::DeviceInfo device;
+        device.name = QStringLiteral("Monitor of %1").arg(node.description);
+        device.uid = node.name + kMonitorSuffix;
+        device.channels = node.channels;
+        device.isInput = true;
+        result.append(device);
+    }
+
+    return result;
+}
+
+void DeviceRegistry::Backend::destroyMetadata() {
+    if (!metadata) {
+        return;
+    }
+    spa_hook_remove(&metadataListener);
+    pw_proxy_destroy(reinterpret_cast<pw_proxy*>(metadata));
+    metadata = nullptr;
+    metadataId = SPA_ID_INVALID;
+}
+
+void DeviceRegistry::Backend::on_core_done(void* userdata, std::uint32_t id, int seq) {
+    auto* registry = static_cast<DeviceRegistry*>(userdata);
+    Backend& backend = *registry->backend_;
+
+    if (id != PW_ID_CORE || !backend.syncPending || seq != backend.syncSeq) {
+        return;
+    }
+    backend.syncPending = false;
+    registry->publish(backend.deviceList());
+}
+
+void DeviceRegistry::Backend::on_global(void* userdata,
+                                        std::uint32_t id,
+                                        std::uint32_t permissions,
+                                        const char* type,
+                                        std::uint32_t version,
+                                        const spa_dict* props) {
+    (void)permissions;
+    (void)version;
+    auto* registry = static_cast<DeviceRegistry*>(userdata);
+    Backend& backend = *registry->backend_;
+    if (!type || !props) {
+        return;
+    }
+
+    if (std::strcmp(type, PW_TYPE_INTERFACE_Node) == 0) {
+        const char* mediaClass = spa_dict_lookup(props, PW_KEY_MEDIA_CLASS);
+        const char* name = spa_dict_lookup(props, PW_KEY_NODE_NAME);
+        if (!mediaClass || !name) {
+            return;
+        }
+
+        const bool isSink = std::strcmp(mediaClass, "Audio/Sink") == 0;
+        if (!isSink && std::strcmp(mediaClass, "Audio/Source") != 0) {
+            return;
+        }
+
+        Node node;
+        node.name = QString::fromUtf8(name);
+        const char* description = spa_dict_lookup(props, PW_KEY_NODE_DESCRIPTION);
+        node.description = description ? QString::fromUtf8(description) : node.name;
+        const char* channels = spa_dict_lookup(props, PW_KEY_AUDIO_CHANNELS);
+        node.channels = channels ? std::atoi(channels) : 0;
+        node.isSink = isSink;
+        backend.nodes[id] = node;
+        backend.scheduleUpdate();
+    } else if (std::strcmp(type, PW_TYPE_INTERFACE_Metadata) == 0 && !backend.metadata) {
+        static const pw_metadata_events metadataEvents = {
+            .version = PW_VERSION_METADATA_EVENTS,
+            .property = &Backend::on_metadata_property,
+        };
+
+        const char* metadataName = spa_dict_lookup(props, PW_KEY_METADATA_NAME);
+        if (metadataName && std::strcmp(metadataName, "default") == 0) {
+            backend.metadata =
+                static_cast<pw_metadata*>(pw_registry_bind(backend.registry, id, type, PW_VERSION_METADATA, 0));
+            if (backend.metadata) {
+                backend.metadataId = id;
+                backend.metadataListener = spa_hook{};
+                pw_metadata_add_listener(backend.metadata, &backend.metadataListener, &metadataEvents, registry);
+            }
+        }
+    }
+}
+
+void DeviceRegistry::Backend::on_global_remove(void* userdata, std::uint32_t id) {
+    auto* registry = static_cast<DeviceRegistry*>(userdata);
+    Backend& backend = *registry->backend_;
+
+    if (id == backend.metadataId) {
+        backend.destroyMetadata();
+        return;
+    }
+    if (backend.nodes.erase(id) > 0) {
+        backend.scheduleUpdate();
+    }
+}
+
+int DeviceRegistry::Backend::on_metadata_property(
+    void* userdata, std::uint32_t subject, const char* key, const char* type, const char* value) {
+    (void)subject;
+    (void)type;
+    auto* registry = static_cast<DeviceRegistry*>(userdata);
+    Backend& backend = *registry->backend_;
+
+    // Only the source default is marked; a null key clears all properties
+    if (!key || std::strcmp(key, "default.audio.source") == 0) {
+        backend.defaultSource = key ? metadataNodeName(value) : QString();
+        backend.scheduleUpdate();
+    }
+    return 0;
+}
+
+#endif // __linux__ && ANALOGVU_HAS_PIPEWIRE
@@ -0,0 +1,256 @@
+#include "FileAnalyzer.h"
+
+#include "WavReader.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QFileInfo>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+static constexpr float kAnalysisFloorVu = -96.0f;
+static constexpr float kAnalysisCeilingVu = 6.0f;
+static constexpr double kDefaultControlRateHz = 1000.0;
+
+// Audio converted or read ahead per pass (about 1 s at 48 kHz)
+static constexpr unsigned int kChunkFrames = 48'000;
+
+// Shorter segments would spend more time warming up than measuring
+static constexpr double kMinSegmentSeconds = 30.0;
+
+FileAnalyzer::FileAnalyzer(const Options& options) : options_(options) {
+    if (options_.controlRateHz <= 0.0) {
+        options_.controlRateHz = kDefaultControlRateHz;
+    }
+}
+
+bool FileAnalyzer::run(QString* errorOut) {
+    WavReader wav;
+    if (!wav.open(options_.inputPath, errorOut)) {
+        return false;
+    }
+    if (wav.frames() == 0) {
+        if (errorOut) {
+            *errorOut = QStringLiteral("%1 holds no audio").arg(options_.inputPath);
+        }
+        return false;
+    }
+
+    channels_ = wav.channels();
+    sampleRate_ = wav.sampleRate();
+
+    // The DSP rounds its sub-block the same way; whole sub-blocks per curve point keep
+    // every segment's sub-blocks on the grid of an unsplit run
+    const unsigned int subBlockFrames =
+        std::max(1u, static_cast<unsigned int>(std::lround(sampleRate_ / options_.controlRateHz)));
+    const double curveRate = std::clamp(options_.curveRateHz, 0.1, options_.controlRateHz);
+    stepFrames_ = subBlockFrames *
+                  std::max(1u, static_cast<unsigned int>(std::lround(sampleRate_ / curveRate / subBlockFrames)));
+    steps_ = (wav.frames() + stepFrames_ - 1) / stepFrames_;
+    curve_.assign(static_cast<size_t>(steps_) * channels_, kAnalysisFloorVu);
+
+    const unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned int threads = options_.threads > 0 ? static_cast<unsigned int>(options_.threads) : cores;
+    const std::uint64_t minSegmentSteps =
+        std::max<std::uint64_t>(1, static_cast<std::uint64_t>(kMinSegmentSeconds * sampleRate_ / stepFrames_));
+    const auto segments =
+        static_cast<unsigned int>(std::clamp<std::uint64_t>(steps_ / minSegmentSteps, 1, threads));
+
+    const auto started = std::chrono::steady_clock::now();
+
+    // Each segment writes its own range of curve_ and its own stats: nothing is shared
+    std::vector<SegmentStats> stats(segments);
+    std::vector<std::thread> workers;
+    workers.reserve(segments - 1);
+    for (unsigned int s = 1; s < segments; ++s) {
+        workers.emplace_back([this, &wav, &stats, s, segments] {
+            analyzeSegment(wav, steps_ * s / segments, steps_ * (s + 1) / segments, stats[s]);
+        });
+    }
+    analyzeSegment(wav, 0, steps_ / segments, stats[0]);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    summary_ = Summary();
+    summary_.channels = channels_;
+    summary_.sampleRate = sampleRate_;
+    summary_.durationSeconds = static_cast<double>(wav.frames()) / sampleRate_;
+    summary_.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    summary_.segments = static_cast<int>(segments);
+    summary_.perChannel.resize(channels_);
+
+    const double stepSeconds = static_cast<double>(stepFrames_) / sampleRate_;
+    for (unsigned int c = 0; c < channels_; ++c) {
+        ChannelSummary& channel = summary_.perChannel[c];
+        channel.maxVu = kAnalysisFloorVu;
+        double sumVu = 0.0;
+        std::uint64_t above = 0;
+        for (const SegmentStats& segment : stats) {
+            channel.maxVu = std::max(channel.maxVu, segment.maxVu[c]);
+            channel.peakDbfs = std::max(channel.peakDbfs, segment.peakDbfs[c]);
+            sumVu += segment.sumVu[c];
+            above += segment.stepsAboveZeroVu[c];
+        }
+        channel.averageVu = static_cast<float>(sumVu / static_cast<double>(steps_));
+        channel.secondsAboveZeroVu = static_cast<double>(above) * stepSeconds;
+    }
+
+    return writeCurve(errorOut);
+}
+
+void FileAnalyzer::analyzeSegment(const WavReader& wav,
+                                  std::uint64_t firstStep,
+                                  std::uint64_t endStep,
+                                  SegmentStats& stats) {
+    const unsigned int channels = channels_;
+    stats.maxVu.assign(channels, kAnalysisFloorVu);
+    stats.sumVu.assign(channels, 0.0);
+    stats.peakDbfs.assign(channels, kVuPeakFloorDbfs);
+    stats.stepsAboveZeroVu.assign(channels, 0);
+
+    // Warm-up in whole curve points, discarded: the fresh DSP state settles before firstStep
+    const auto warmupSteps = std::min<std::uint64_t>(
+        firstStep, static_cast<std::uint64_t>(std::ceil(options_.warmupSeconds * sampleRate_ / stepFrames_)));
+    std::uint64_t frame = (firstStep - warmupSteps) * stepFrames_;
+    const std::uint64_t endFrame = std::min<std::uint64_t>(endStep * stepFrames_, wav.frames());
+
+    const std::size_t chunkFrames = static_cast<std::size_t>(std::max(1u, kChunkFrames / stepFrames_)) * stepFrames_;
+
+    // 32-bit float files are metered straight from the mapping
+    std::vector<float> converted;
+    if (!wav.floatFrames(0)) {
+        converted.resize(chunkFrames * channels);
+    }
+
+    VuAudioDspState state(options_.jitter, options_.ballistics);
+    std::vector<float> vu(channels, kAnalysisFloorVu);
+    const auto sampleRate = sampleRate_;
+    const auto controlRate = static_cast<float>(options_.controlRateHz);
+
+    while (frame < endFrame) {
+        const auto frames = static_cast<std::size_t>(std::min<std::uint64_t>(chunkFrames, endFrame - frame));
+        wav.willNeed(frame + frames, chunkFrames);
+
+        const float* data = wav.floatFrames(frame);
+        if (!data) {
+            wav.readFrames(frame, frames, converted.data());
+            data = converted.data();
+        }
+
+        for (std::size_t offset = 0; offset < frames; offset += stepFrames_) {
+            const auto n = static_cast<unsigned int>(std::min<std::size_t>(stepFrames_, frames - offset));
+            processInterleavedFloatAudioToVuDbFixedRate(data + offset * channels,
+                                                        n,
+                                                        channels,
+                                                        sampleRate,
+                                                        controlRate,
+                                                        options_.reference,
+                                                        state,
+                                                        kAnalysisFloorVu,
+                                                        kAnalysisCeilingVu,
+                                                        vu.data());
+
+            const std::uint64_t step = (frame + offset) / stepFrames_;
+            if (step < firstStep) {
+                continue;
+            }
+
+            float* out = curve_.data() + static_cast<size_t>(step) * channels;
+            for (unsigned int c = 0; c < channels; ++c) {
+                out[c] = vu[c];
+                stats.maxVu[c] = std::max(stats.maxVu[c], vu[c]);
+                stats.sumVu[c] += vu[c];
+                stats.peakDbfs[c] = std::max(stats.peakDbfs[c], state.peakDbfs[c]);
+                if (vu[c] >= 0.0f) {
+                    ++stats.stepsAboveZeroVu[c];
+                }
+            }
+        }
+        frame += frames;
+    }
+}
+
+bool FileAnalyzer::writeCurve(QString* errorOut) const {
+    QFile file;
+    bool opened = false;
+    if (options_.outputPath.isEmpty() || options_.outputPath == QStringLiteral("-")) {
+        opened = file.open(stdout, QIODevice::WriteOnly);
+    } else {
+        file.setFileName(options_.outputPath);
+        opened = file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    }
+    if (!opened) {
+        if (errorOut) {
+            *errorOut = QStringLiteral("Cannot write %1: %2").arg(options_.outputPath, file.errorString());
+        }
+        return false;
+    }
+
+    // One point per row, at the end time of its step
+    QByteArray buffer;
+    buffer.reserve(1 << 16);
+    buffer.append("time_s");
+    for (unsigned int c = 0; c < channels_; ++c) {
+        buffer.append(",vu_").append(QByteArray::number(c + 1));
+    }
+    buffer.append('\n');
+
+    const double stepSeconds = static_cast<double>(stepFrames_) / sampleRate_;
+    for (std::uint64_t step = 0; step < steps_; ++step) {
+        buffer.append(QByteArray::number(static_cast<double>(step + 1) * stepSeconds, 'f', 3));
+        const float* values = curve_.data() + static_cast<size_t>(step) * channels_;
+        for (unsigned int c = 0; c < channels_; ++c) {
+            buffer.append(',').append(QByteArray::number(values[c], 'f', 2));
+        }
+        buffer.append('\n');
+
+        if (buffer.size() >= (1 << 16)) {
+            file.write(buffer);
+            buffer.clear();
+        }
+    }
+    file.write(buffer);
+    file.flush();
+
+    if (file.error() != QFileDevice::NoError) {
+        if (errorOut) {
+            *errorOut = QStringLiteral("Cannot write %1: %2").arg(options_.outputPath, file.errorString());
+        }
+        return false;
+    }
+    if (errorOut) {
+        *errorOut = QString();
+    }
+    return true;
+}
+
+QString FileAnalyzer::summaryString() const {
+    QString out;
+    out += QStringLiteral("%1: %2 ch, %3 Hz, %4 s\n")
+               .arg(QFileInfo(options_.inputPath).fileName())
+               .arg(summary_.channels)
+               .arg(summary_.sampleRate, 0, 'f', 0)
+               .arg(summary_.durationSeconds, 0, 'f', 1);
+
+    const double speed = summary_.elapsedSeconds > 0.0 ? summary_.durationSeconds / summary_.elapsedSeconds : 0.0;
+    out += QStringLiteral("Analyzed in %1 s (%2x realtime, %3 segments)\n")
+               .arg(summary_.elapsedSeconds, 0, 'f', 2)
+               .arg(speed, 0, 'f', 0)
+               .arg(summary_.segments);
+
+    for (size_t c = 0; c < summary_.perChannel.size(); ++c) {
+        const ChannelSummary& channel = summary_.perChannel[c];
+        out += QStringLiteral("  ch %1: max %2 VU, average %3 VU, peak %4 dBFS, %5 s at or above 0 VU\n")
+                   .arg(c + 1)
+                   .arg(channel.maxVu, 0, 'f', 2)
+                   .arg(channel.averageVu, 0, 'f', 2)
+                   .arg(channel.peakDbfs, 0, 'f', 2)
+                   .arg(channel.secondsAboveZeroVu, 0, 'f', 1);
+    }
+    return out;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QString>
+
+#include <cstdint>
+#include <vector>
+
+#include "VuAudioDsp.h"
+
+class WavReader;
+
+// Offline VU analysis of an audio file (--analyze), as fast as the CPU allows.
+//
+// The file is memory-mapped and pushed through the same DSP as live capture, in
+// fixed control-rate mode so that the result does not depend on how the audio is
+// chunked. Long files are split by time into one segment per thread; each segment
+// starts with a few seconds of warm-up audio before its boundary, so the RMS
+// integrator and ballistics have settled where its curve begins.
+class FileAnalyzer final {
+  public:
+    struct Options final {
+        QString inputPath;
+        QString outputPath = QStringLiteral("-"); // VU curve as CSV; "-" = stdout
+
+        double curveRateHz = 100.0;    // curve points per second
+        double controlRateHz = 1000.0; // meter DSP rate (0 = the default 1000 Hz)
+        double warmupSeconds = 3.0;
+        int threads = 0; // 0 = one per core
+
+        VuReferenceOptions reference;
+
+        // Off by default: a measurement should not depend on the seed or on how the
+        // file was split into segments
+        VuJitterOptions jitter{false};
+
+        VuBallisticsProfile ballistics;
+    };
+
+    struct ChannelSummary final {
+        float maxVu = 0.0f;
+        float averageVu = 0.0f;
+        float peakDbfs = kVuPeakFloorDbfs;
+        double secondsAboveZeroVu = 0.0;
+    };
+
+    struct Summary final {
+        unsigned int channels = 0;
+        float sampleRate = 0.0f;
+        double durationSeconds = 0.0;
+        double elapsedSeconds = 0.0;
+        int segments = 0;
+        std::vector<ChannelSummary> perChannel;
+    };
+
+    explicit FileAnalyzer(const Options& options);
+
+    // Analyzes the file and writes the curve; fills errorOut and returns false on failure
+    bool run(QString* errorOut = nullptr);
+
+    const Summary& summary() const { return summary_; }
+
+    // Human-readable report of summary()
+    QString summaryString() const;
+
+  private:
+    struct SegmentStats final {
+        std::vector<float> maxVu;
+        std::vector<double> sumVu;
+        std::vector<float> peakDbfs;
+        std::vector<std::uint64_t> stepsAboveZeroVu;
+    };
+
+    void analyzeSegment(const WavReader& wav, std::uint64_t firstStep, std::uint64_t endStep, SegmentStats& stats);
+    bool writeCurve(QString* errorOut) const;
+
+    Options options_;
+    Summary summary_;
+
+    unsigned int channels_ = 0;
+    float sampleRate_ = 0.0f;
+    unsigned int stepFrames_ = 0; // frames per curve point, a whole number of DSP sub-blocks
+    std::uint64_t steps_ = 0;
+
+    std::vector<float> curve_; // steps_ x channels_, step-major
+};
@@ -0,0 +1,179 @@
+#include "FrameScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include <QEvent>
+#include <QScreen>
+#include <QWidget>
+#include <QWindow>
+
+static constexpr qreal kFallbackRefreshHz = 60.0;
+
+static std::int64_t steadyNowNs() {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+FrameScheduler::FrameScheduler(QWidget* target, QObject* parent) : QObject(parent), target_(target) {
+    timer_.setTimerType(Qt::PreciseTimer);
+    timer_.setSingleShot(true);
+    connect(&timer_, &QTimer::timeout, this, &FrameScheduler::onTimeout);
+
+    // Show/hide/minimize arrive on the top-level widget; expose and screen
+    // changes on its native window, which only exists once it is shown.
+    target_->window()->installEventFilter(this);
+    attachWindow();
+    updateInterval();
+}
+
+void FrameScheduler::setMaxFps(int fps) {
+    maxFps_ = std::max(0, fps);
+    updateInterval();
+}
+
+void FrameScheduler::setIdle(bool idle) {
+    if (idle == idle_) {
+        return;
+    }
+    idle_ = idle;
+    updateInterval();
+}
+
+void FrameScheduler::start() {
+    started_ = true;
+    updateRunning();
+}
+
+void FrameScheduler::stop() {
+    started_ = false;
+    updateRunning();
+}
+
+bool FrameScheduler::eventFilter(QObject* watched, QEvent* event) {
+    switch (event->type()) {
+    case QEvent::Show:
+    case QEvent::Hide:
+    case QEvent::WindowStateChange:
+    case QEvent::Expose:
+    case QEvent::WinIdChange:
+        // Evaluate once the event has been processed and the window state is current
+        QMetaObject::invokeMethod(
+            this,
+            [this]() {
+                attachWindow();
+                updateRunning();
+            },
+            Qt::QueuedConnection);
+        break;
+    default:
+        break;
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void FrameScheduler::attachWindow() {
+    QWindow* window = target_->window()->windowHandle();
+    if (window == window_) {
+        return;
+    }
+
+    if (window_) {
+        window_->removeEventFilter(this);
+        disconnect(window_, nullptr, this, nullptr);
+    }
+
+    window_ = window;
+    if (!window_) {
+        return;
+    }
+
+    window_->installEventFilter(this);
+    connect(window_, &QWindow::screenChanged, this, &FrameScheduler::attachScreen);
+    connect(window_, &QWindow::visibilityChanged, this, &FrameScheduler::updateRunning);
+    attachScreen(window_->screen());
+}
+
+void FrameScheduler::attachScreen(QScreen* screen) {
+    disconnect(refreshRateConnection_);
+    screen_ = screen;
+    if (screen_) {
+        refreshRateConnection_ =
+            connect(screen_, &QScreen::refreshRateChanged, this, &FrameScheduler::updateInterval);
+    }
+    updateInterval();
+}
+
+void FrameScheduler::updateInterval() {
+    QScreen* screen = screen_ ? screen_.data() : target_->screen();
+    qreal refreshHz = screen ? screen->refreshRate() : kFallbackRefreshHz;
+    if (refreshHz < 1.0) {
+        refreshHz = kFallbackRefreshHz;
+    }
+
+    fps_ = (maxFps_ > 0) ? std::min<qreal>(refreshHz, maxFps_) : refreshHz;
+    const std::int64_t periodNs =
+        idle_ ? std::int64_t{kIdleIntervalMs} * 1'000'000 : static_cast<std::int64_t>(std::llround(1e9 / fps_));
+    if (periodNs == periodNs_) {
+        return;
+    }
+    periodNs_ = periodNs;
+
+    // The pending frame keeps its slot; the new period applies from the next one
+    // (leaving idle, reschedule right away rather than waiting out the poll)
+    if (running_ && !idle_) {
+        nextFrameNs_ = std::min(nextFrameNs_, steadyNowNs() + periodNs_);
+        scheduleNext();
+    }
+}
+
+void FrameScheduler::updateRunning() {
+    const QWidget* top = target_->window();
+    bool visible = started_ && top->isVisible() && !top->isMinimized();
+    if (visible && window_) {
+        visible = window_->isExposed() && window_->visibility() != QWindow::Hidden &&
+                  window_->visibility() != QWindow::Minimized;
+    }
+
+    if (visible && !running_) {
+        running_ = true;
+        const std::int64_t now = steadyNowNs();
+        nextFrameNs_ = now + periodNs_;
+        scheduleNext();
+        emit resumed();
+        emitFrame(now); // catch up immediately after being shown again
+    } else if (!visible && running_) {
+        running_ = false;
+        timer_.stop();
+    }
+}
+
+void FrameScheduler::onTimeout() {
+    if (!running_) {
+        return;
+    }
+
+    const std::int64_t deadline = nextFrameNs_;
+    const std::int64_t now = steadyNowNs();
+
+    // Keep the phase; frames missed while the GUI thread was busy are dropped, not bunched
+    nextFrameNs_ += periodNs_;
+    if (nextFrameNs_ <= now) {
+        nextFrameNs_ += ((now - nextFrameNs_) / periodNs_ + 1) * periodNs_;
+    }
+    scheduleNext();
+
+    emitFrame(deadline);
+}
+
+void FrameScheduler::scheduleNext() {
+    // Nearest whole millisecond: the error stays under a millisecond per frame and
+    // does not accumulate, because the deadline does
+    const std::int64_t waitNs = std::max<std::int64_t>(0, nextFrameNs_ - steadyNowNs());
+    timer_.start(static_cast<int>((waitNs + 500'000) / 1'000'000));
+}
+
+void FrameScheduler::emitFrame(std::int64_t timestampNs) {
+    emit frame(timestampNs);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <QMetaObject>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+#include <cstdint>
+
+class QScreen;
+class QWidget;
+class QWindow;
+
+// Drives meter frames at the refresh rate of the screen the target widget is on.
+//
+// The frame rate follows screen changes and refresh rate changes, can be capped
+// (e.g. 30 fps on battery or embedded boards), and no frames are scheduled at all
+// while the window is hidden, minimized or not exposed (occluded). While idle
+// (every capture silent) frames slow down to a poll that notices audio coming back.
+//
+// Each frame is a single-shot timer aimed at an accumulating nanosecond deadline
+// (next = previous + period), so rounding every wait to whole milliseconds only
+// jitters a frame by under a millisecond and never drifts against the display.
+class FrameScheduler final : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit FrameScheduler(QWidget* target, QObject* parent = nullptr);
+
+    // 0 = no cap, run at the display refresh rate
+    void setMaxFps(int fps);
+    int maxFps() const { return maxFps_; }
+
+    void start();
+    void stop();
+
+    // Idle: one frame every kIdleIntervalMs instead of one per display refresh
+    void setIdle(bool idle);
+    bool isIdle() const { return idle_; }
+
+    // Frames are currently being produced (started and window visible)
+    bool isRunning() const { return running_; }
+    qreal framesPerSecond() const { return fps_; }
+
+  signals:
+    // timestampNs is std::chrono::steady_clock time at which the frame was scheduled
+    void frame(qint64 timestampNs);
+
+    // Frames start again after a pause (hidden, minimized, stopped); emitted just
+    // before the first frame
+    void resumed();
+
+  protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+  private:
+    void attachWindow();
+    void attachScreen(QScreen* screen);
+    void updateInterval();
+    void updateRunning();
+    void onTimeout();
+    void scheduleNext();
+    void emitFrame(std::int64_t timestampNs);
+
+    // About one idle capture block (100 ms fragments with PulseAudio)
+    static constexpr int kIdleIntervalMs = 100;
+
+    QWidget* target_ = nullptr;
+    QPointer<QWindow> window_;
+    QPointer<QScreen> screen_;
+    QMetaObject::Connection refreshRateConnection_;
+
+    QTimer timer_;
+    int maxFps_ = 0;
+    qreal fps_ = 60.0;
+    std::int64_t periodNs_ = 0;
+    std::int64_t nextFrameNs_ = 0; // steady_clock deadline of the next frame
+    bool running_ = false;
+    bool started_ = false;
+    bool idle_ = false;
+};
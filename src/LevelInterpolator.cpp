@@ -0,0 +1,87 @@
+#include "LevelInterpolator.h"
+
+#include <algorithm>
+
+// Gaps longer than this (stream restarts, paused UI) do not feed the interval estimate
+static constexpr std::int64_t kMaxIntervalNs = 200'000'000;
+static constexpr std::int64_t kMaxDelayNs = 250'000'000;
+static constexpr double kAverageWeight = 0.05;
+
+void LevelInterpolator::reset() {
+    count_ = 0;
+    newest_ = -1;
+    avgIntervalNs_ = 0.0;
+    avgAgeNs_ = 0.0;
+}
+
+const LevelSample& LevelInterpolator::at(int age) const {
+    return history_[(newest_ - age + kHistory) % kHistory];
+}
+
+void LevelInterpolator::drain(LevelRingBuffer& ring, std::int64_t nowNs) {
+    bool received = false;
+
+    LevelSample s;
+    while (ring.pop(s)) {
+        if (count_ > 0) {
+            const std::int64_t interval = s.timeNs - at(0).timeNs;
+            if (interval <= 0) {
+                continue; // out of order or duplicate timestamp
+            }
+            if (interval < kMaxIntervalNs) {
+                avgIntervalNs_ = (avgIntervalNs_ == 0.0)
+                                     ? static_cast<double>(interval)
+                                     : avgIntervalNs_ + kAverageWeight * (interval - avgIntervalNs_);
+            }
+        }
+
+        newest_ = (newest_ + 1) % kHistory;
+        history_[newest_] = s;
+        count_ = std::min(count_ + 1, kHistory);
+        received = true;
+    }
+
+    if (received) {
+        const double age = static_cast<double>(std::max<std::int64_t>(0, nowNs - at(0).timeNs));
+        avgAgeNs_ = (avgAgeNs_ == 0.0) ? age : avgAgeNs_ + kAverageWeight * (age - avgAgeNs_);
+    }
+}
+
+std::int64_t LevelInterpolator::delayNs() const {
+    const double delay = avgAgeNs_ + 0.5 * avgIntervalNs_;
+    return std::clamp(static_cast<std::int64_t>(delay), std::int64_t{0}, kMaxDelayNs);
+}
+
+LevelSample LevelInterpolator::sampleAt(std::int64_t presentationNs) const {
+    if (count_ == 0) {
+        return {};
+    }
+
+    const std::int64_t target = presentationNs - delayNs();
+
+    if (target >= at(0).timeNs) {
+        return at(0);
+    }
+
+    for (int age = 1; age < count_; ++age) {
+        const LevelSample& older = at(age);
+        if (older.timeNs <= target) {
+            const LevelSample& newer = at(age - 1);
+            if (older.channels != newer.channels) {
+                return newer; // stream format changed in between
+            }
+
+            const float t = static_cast<float>(double(target - older.timeNs) / double(newer.timeNs - older.timeNs));
+
+            LevelSample out;
+            out.timeNs = target;
+            out.channels = newer.channels;
+            for (unsigned int c = 0; c < out.channels; ++c) {
+                out.vu[c] = older.vu[c] + t * (newer.vu[c] - older.vu[c]);
+            }
+            return out;
+        }
+    }
+
+    return at(count_ - 1);
+}
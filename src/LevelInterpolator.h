@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "LevelRingBuffer.h"
+
+// UI-side consumer of the audio thread's level ring.
+//
+// Keeps a short history of timestamped blocks and evaluates the needle levels at a
+// frame's presentation time by linear interpolation. The evaluation point trails
+// the presentation time by an adaptive delay (typical age of the newest block plus
+// half a block interval), so it normally falls between two captured blocks and the
+// needle moves smoothly instead of stepping at the capture block rate.
+class LevelInterpolator final {
+  public:
+    // Moves every pending sample from the ring into the history
+    void drain(LevelRingBuffer& ring, std::int64_t nowNs);
+
+    bool hasSamples() const { return count_ > 0; }
+    std::int64_t newestTimeNs() const { return count_ > 0 ? at(0).timeNs : 0; }
+    LevelSample sampleAt(std::int64_t presentationNs) const;
+    std::int64_t delayNs() const;
+
+    void reset();
+
+  private:
+    static constexpr int kHistory = 16;
+
+    const LevelSample& at(int age) const; // 0 = newest
+
+    std::array<LevelSample, kHistory> history_{};
+    int count_ = 0;
+    int newest_ = -1;
+
+    double avgIntervalNs_ = 0.0;
+    double avgAgeNs_ = 0.0;
+};
@@ -0,0 +1,365 @@
+#include "LevelOutput.h"
+
+#include "AudioCapture.h"
+#include "LevelRingBuffer.h"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static_assert(std::endian::native == std::endian::little, "the binary level format is written in host byte order");
+
+static constexpr std::uint32_t kBinaryMagic = 0x4C555641; // "AVUL" read as little-endian bytes
+static constexpr std::uint16_t kBinaryVersion = 1;
+
+// Largest UDP payload over IPv4; a batch that would not fit is sent early
+static constexpr qsizetype kMaxDatagramBytes = 65'507;
+
+template <typename T>
+static void appendRaw(QByteArray& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void appendJsonString(QByteArray& out, const QString& value) {
+    out.append('"');
+    for (const char ch : value.toUtf8()) {
+        const auto c = static_cast<unsigned char>(ch);
+        if (c == '"' || c == '\\') {
+            out.append('\\');
+            out.append(ch);
+        } else if (c < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out.append(escaped);
+        } else {
+            out.append(ch);
+        }
+    }
+    out.append('"');
+}
+
+static void appendJsonLevels(QByteArray& out, const std::array<float, kVuMaxChannels>& values, unsigned int count) {
+    out.append('[');
+    for (unsigned int c = 0; c < count; ++c) {
+        if (c > 0) {
+            out.append(',');
+        }
+        out.append(QByteArray::number(values[c], 'f', 2));
+    }
+    out.append(']');
+}
+
+static std::int64_t toUnixTimeUs(std::int64_t steadyNs, std::int64_t steadyNowNs) {
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    const std::int64_t nowUs = std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+    return nowUs - (steadyNowNs - steadyNs) / 1000;
+}
+
+LevelOutput::LevelOutput(const QList<AudioCapture*>& captures, const Options& options, QObject* parent)
+    : QObject(parent), captures_(captures), options_(options), levels_(static_cast<size_t>(captures.size())) {
+    options_.rateHz = std::clamp(options_.rateHz, 0.1, 1000.0);
+    options_.batchFrames = std::max(1, options_.batchFrames);
+
+    for (CaptureLevels& levels : levels_) {
+        levels.peakDbfs.fill(kVuPeakFloorDbfs);
+    }
+
+    timer_.setTimerType(Qt::PreciseTimer);
+    timer_.setInterval(std::max(1, static_cast<int>(std::lround(1000.0 / options_.rateHz))));
+    connect(&timer_, &QTimer::timeout, this, &LevelOutput::tick);
+}
+
+LevelOutput::~LevelOutput() { stop(); }
+
+bool LevelOutput::parseFormat(const QString& name, Format* format) {
+    const QString lower = name.toLower();
+    if (lower == QStringLiteral("json")) {
+        *format = Format::Json;
+        return true;
+    }
+    if (lower == QStringLiteral("binary")) {
+        *format = Format::Binary;
+        return true;
+    }
+    return false;
+}
+
+bool LevelOutput::open(QString* errorOut) {
+    const auto fail = [this, errorOut](const QString& message) {
+        if (errorOut) {
+            *errorOut = message;
+        }
+        closeTarget();
+        return false;
+    };
+
+    closeTarget();
+    const QString& target = options_.target;
+
+    if (target.isEmpty() || target == QStringLiteral("stdout") || target == QStringLiteral("-")) {
+        fd_ = STDOUT_FILENO;
+        ownsFd_ = false;
+        datagram_ = false;
+    } else if (target.startsWith(QStringLiteral("unix:"))) {
+        const QByteArray path = target.mid(5).toLocal8Bit();
+        sockaddr_un address{};
+        if (path.isEmpty() || static_cast<size_t>(path.size()) >= sizeof(address.sun_path)) {
+            return fail(QStringLiteral("Invalid UNIX socket path: %1").arg(target.mid(5)));
+        }
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, path.constData(), static_cast<size_t>(path.size()));
+
+        fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        ownsFd_ = true;
+        datagram_ = false;
+        if (fd_ < 0 || ::connect(fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            return fail(QStringLiteral("Failed to connect to %1: %2")
+                            .arg(target.mid(5), QString::fromLocal8Bit(std::strerror(errno))));
+        }
+    } else if (target.startsWith(QStringLiteral("udp:"))) {
+        // udp:host:port, with IPv6 hosts in brackets
+        const QString hostPort = target.mid(4);
+        const qsizetype colon = hostPort.lastIndexOf(QLatin1Char(':'));
+        QString host = hostPort.left(colon);
+        const QString port = hostPort.mid(colon + 1);
+        if (host.startsWith(QLatin1Char('[')) && host.endsWith(QLatin1Char(']'))) {
+            host = host.mid(1, host.size() - 2);
+        }
+        if (colon <= 0 || host.isEmpty() || port.isEmpty()) {
+            return fail(QStringLiteral("Invalid UDP target (expected udp:<host>:<port>): %1").arg(target));
+        }
+
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_DGRAM;
+        addrinfo* result = nullptr;
+        const int status = ::getaddrinfo(host.toUtf8().constData(), port.toUtf8().constData(), &hints, &result);
+        if (status != 0) {
+            return fail(
+                QStringLiteral("Failed to resolve %1: %2").arg(host, QString::fromLocal8Bit(gai_strerror(status))));
+        }
+
+        ownsFd_ = true;
+        datagram_ = true;
+        for (addrinfo* ai = result; ai; ai = ai->ai_next) {
+            fd_ = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd_ >= 0 && ::connect(fd_, ai->ai_addr, ai->ai_addrlen) == 0) {
+                break;
+            }
+            if (fd_ >= 0) {
+                ::close(fd_);
+                fd_ = -1;
+            }
+        }
+        ::freeaddrinfo(result);
+        if (fd_ < 0) {
+            return fail(QStringLiteral("Failed to open a UDP socket to %1").arg(hostPort));
+        }
+    } else {
+        return fail(QStringLiteral("Unknown level output target: %1 (use stdout, unix:<path> or udp:<host>:<port>)")
+                        .arg(target));
+    }
+
+    // Device names do not change while headless; escape them once
+    deviceJson_.clear();
+    for (AudioCapture* capture : captures_) {
+        QByteArray quoted;
+        appendJsonString(quoted, capture->currentDeviceUID());
+        deviceJson_.push_back(quoted);
+    }
+
+    if (errorOut) {
+        *errorOut = QString();
+    }
+    return true;
+}
+
+void LevelOutput::start() {
+    if (options_.perfIntervalSeconds > 0.0) {
+        PerfCounters::setEnabled(true);
+        perfBefore_ = PerfCounters::snapshot();
+        nextPerfDumpNs_ = perfBefore_.timeNs + static_cast<std::int64_t>(options_.perfIntervalSeconds * 1e9);
+    }
+    if (fd_ >= 0) {
+        timer_.start();
+    }
+}
+
+void LevelOutput::stop() {
+    timer_.stop();
+    if (fd_ >= 0) {
+        flush();
+    }
+    closeTarget();
+}
+
+void LevelOutput::closeTarget() {
+    if (ownsFd_ && fd_ >= 0) {
+        ::close(fd_);
+    }
+    fd_ = -1;
+    ownsFd_ = false;
+    batch_.clear();
+    batchedFrames_ = 0;
+}
+
+void LevelOutput::tick() {
+    const std::int64_t nowNs = levelClockNowNs();
+    std::int64_t newestNs = 0;
+
+    LevelSample sample;
+    for (qsizetype i = 0; i < captures_.size(); ++i) {
+        CaptureLevels& levels = levels_[static_cast<size_t>(i)];
+        while (captures_[i]->levelRing().pop(sample)) {
+            levels.channels = sample.channels;
+            levels.vu = sample.vu;
+            for (unsigned int c = 0; c < sample.channels; ++c) {
+                levels.peakDbfs[c] = levels.fresh ? std::max(levels.peakDbfs[c], sample.peakDbfs[c])
+                                                  : sample.peakDbfs[c];
+            }
+            levels.fresh = true;
+            newestNs = std::max(newestNs, sample.timeNs);
+        }
+    }
+
+    if (PerfCounters::enabled()) {
+        recordPerf(nowNs, newestNs);
+    }
+
+    // Without new audio (a stalled device) the frame repeats the last levels
+    const std::int64_t timeUs = toUnixTimeUs(newestNs > 0 ? newestNs : nowNs, nowNs);
+
+    frame_.clear();
+    if (options_.format == Format::Json) {
+        appendJsonFrame(timeUs);
+    } else {
+        appendBinaryFrame(timeUs);
+    }
+    for (CaptureLevels& levels : levels_) {
+        levels.fresh = false;
+    }
+
+    if (datagram_ && !batch_.isEmpty() && batch_.size() + frame_.size() > kMaxDatagramBytes) {
+        if (!flush()) {
+            return;
+        }
+    }
+    batch_.append(frame_);
+    if (++batchedFrames_ >= options_.batchFrames) {
+        flush();
+    }
+}
+
+void LevelOutput::recordPerf(std::int64_t nowNs, std::int64_t newestNs) {
+    PerfCounters::increment(PerfCounters::Counter::Frames);
+    if (lastTickNs_ > 0) {
+        const std::int64_t intervalNs = nowNs - lastTickNs_;
+        const auto nominalNs = static_cast<std::int64_t>(1e9 / options_.rateHz);
+        PerfCounters::record(PerfCounters::Histogram::FrameInterval, intervalNs);
+        PerfCounters::record(PerfCounters::Histogram::FrameJitter, std::abs(intervalNs - nominalNs));
+    }
+    lastTickNs_ = nowNs;
+
+    // Here the "photon" is the frame being handed to the target
+    if (newestNs > 0) {
+        PerfCounters::increment(PerfCounters::Counter::LevelUpdates);
+        PerfCounters::record(PerfCounters::Histogram::Latency, nowNs - newestNs);
+    }
+
+    if (nextPerfDumpNs_ <= 0 || nowNs < nextPerfDumpNs_) {
+        return;
+    }
+    const PerfCounters::Snapshot now = PerfCounters::snapshot();
+    const QByteArray line = PerfCounters::toJson(now, perfBefore_) + '\n';
+    perfBefore_ = now;
+    nextPerfDumpNs_ = nowNs + static_cast<std::int64_t>(options_.perfIntervalSeconds * 1e9);
+
+    if (options_.format == Format::Json) {
+        batch_.append(line);
+    } else {
+        std::fwrite(line.constData(), 1, static_cast<size_t>(line.size()), stderr);
+    }
+}
+
+void LevelOutput::appendJsonFrame(std::int64_t timeUs) {
+    frame_.append("{\"t\":");
+    frame_.append(QByteArray::number(static_cast<qint64>(timeUs)));
+    frame_.append(",\"levels\":[");
+    for (size_t i = 0; i < levels_.size(); ++i) {
+        const CaptureLevels& levels = levels_[i];
+        if (i > 0) {
+            frame_.append(',');
+        }
+        frame_.append("{\"device\":");
+        frame_.append(deviceJson_[i]);
+        frame_.append(",\"vu\":");
+        appendJsonLevels(frame_, levels.vu, levels.channels);
+        frame_.append(",\"peak\":");
+        appendJsonLevels(frame_, levels.peakDbfs, levels.channels);
+        frame_.append('}');
+    }
+    frame_.append("]}\n");
+}
+
+void LevelOutput::appendBinaryFrame(std::int64_t timeUs) {
+    appendRaw(frame_, kBinaryMagic);
+    appendRaw(frame_, kBinaryVersion);
+    appendRaw(frame_, static_cast<std::uint16_t>(levels_.size()));
+    appendRaw(frame_, static_cast<std::int64_t>(timeUs));
+    for (const CaptureLevels& levels : levels_) {
+        appendRaw(frame_, static_cast<std::uint16_t>(levels.channels));
+        appendRaw(frame_, static_cast<std::uint16_t>(0));
+        frame_.append(reinterpret_cast<const char*>(levels.vu.data()),
+                      static_cast<qsizetype>(levels.channels * sizeof(float)));
+        frame_.append(reinterpret_cast<const char*>(levels.peakDbfs.data()),
+                      static_cast<qsizetype>(levels.channels * sizeof(float)));
+    }
+}
+
+bool LevelOutput::flush() {
+    if (batch_.isEmpty() || fd_ < 0) {
+        return fd_ >= 0;
+    }
+
+    const char* data = batch_.constData();
+    size_t remaining = static_cast<size_t>(batch_.size());
+    while (remaining > 0) {
+        const ssize_t written = datagram_ ? ::send(fd_, data, remaining, 0) : ::write(fd_, data, remaining);
+        if (written >= 0) {
+            if (datagram_) {
+                break; // one datagram per batch
+            }
+            data += written;
+            remaining -= static_cast<size_t>(written);
+            continue;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (datagram_) {
+            // A collector that is down (ECONNREFUSED) or a full socket buffer only loses this batch
+            break;
+        }
+
+        const QString message =
+            QStringLiteral("Level output failed: %1").arg(QString::fromLocal8Bit(std::strerror(errno)));
+        timer_.stop();
+        closeTarget();
+        emit errorOccurred(message);
+        return false;
+    }
+
+    batch_.clear();
+    batchedFrames_ = 0;
+    return true;
+}
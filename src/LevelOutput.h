@@ -0,0 +1,107 @@
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "PerfCounters.h"
+#include "VuAudioDsp.h"
+
+class AudioCapture;
+
+// Headless consumer of the level rings (--headless): publishes the levels of every
+// capture as a machine-readable stream instead of drawing them.
+//
+// At a fixed rate one frame is taken from all captures: the newest VU of each
+// channel and the sample peak held since the previous frame. Frames are batched,
+// so one write (one datagram for UDP) carries `batchFrames` of them.
+//
+// Line-delimited JSON, one frame per line:
+//   {"t":<unix time in us>,"levels":[{"device":"<uid>","vu":[...],"peak":[...]},...]}
+//
+// Binary, little-endian, frames back to back:
+//   u32 magic 'AVUL' (0x4C555641), u16 version (1), u16 device count, i64 unix time in us,
+//   then per device: u16 channels, u16 reserved (0), f32 vu[channels], f32 peak[channels]
+//
+// VU is in the meter's VU scale, peak in dBFS. The time is the capture time of the
+// newest block in the frame.
+//
+// With perfIntervalSeconds set, PerfCounters are enabled and a windowed dump of
+// them follows every that many seconds: as a {"t":...,"perf":{...}} line in the
+// JSON stream, or on stderr next to the binary one.
+class LevelOutput final : public QObject {
+    Q_OBJECT
+
+  public:
+    enum class Format { Json, Binary };
+
+    struct Options final {
+        // "stdout", "unix:<path>" (a listening stream socket) or "udp:<host>:<port>"
+        QString target = QStringLiteral("stdout");
+        Format format = Format::Json;
+        double rateHz = 30.0;
+        int batchFrames = 10;
+        double perfIntervalSeconds = 0.0; // 0 = no timing dumps
+    };
+
+    LevelOutput(const QList<AudioCapture*>& captures, const Options& options, QObject* parent = nullptr);
+    ~LevelOutput() override;
+
+    LevelOutput(const LevelOutput&) = delete;
+    LevelOutput& operator=(const LevelOutput&) = delete;
+
+    // Opens the target; fills errorOut and returns false if it cannot be reached
+    bool open(QString* errorOut = nullptr);
+
+    void start();
+
+    // Writes the frames still batched and closes the target
+    void stop();
+
+    static bool parseFormat(const QString& name, Format* format);
+
+  signals:
+    // The target went away (stdout closed, collector disconnected); output has stopped
+    void errorOccurred(const QString& message);
+
+  private:
+    struct CaptureLevels final {
+        unsigned int channels = 0;
+        std::array<float, kVuMaxChannels> vu{};
+        std::array<float, kVuMaxChannels> peakDbfs{};
+        bool fresh = false; // a block arrived since the last frame
+    };
+
+    void tick();
+    void appendJsonFrame(std::int64_t timeUs);
+    void appendBinaryFrame(std::int64_t timeUs);
+    void recordPerf(std::int64_t nowNs, std::int64_t newestNs);
+    bool flush();
+    void closeTarget();
+
+    QList<AudioCapture*> captures_;
+    Options options_;
+
+    std::vector<CaptureLevels> levels_;
+    std::vector<QByteArray> deviceJson_; // quoted device UIDs, escaped once
+
+    QByteArray frame_;
+    QByteArray batch_;
+    int batchedFrames_ = 0;
+
+    int fd_ = -1;
+    bool ownsFd_ = false;
+    bool datagram_ = false;
+
+    QTimer timer_;
+
+    std::int64_t lastTickNs_ = 0;
+    std::int64_t nextPerfDumpNs_ = 0;
+    PerfCounters::Snapshot perfBefore_;
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "VuAudioDsp.h"
+
+// Timestamped meter levels published by the audio thread once per processed block.
+struct LevelSample {
+    std::int64_t timeNs = 0; // steady_clock time at which the block's last frame was captured
+    unsigned int channels = 0;
+    std::array<float, kVuMaxChannels> vu{};
+    std::array<float, kVuMaxChannels> peakDbfs{}; // sample peak of the block
+
+    // Stereo view; mono streams drive both sides
+    float left() const { return vu[0]; }
+    float right() const { return channels > 1 ? vu[1] : vu[0]; }
+};
+
+// Time base shared by the capture thread and FrameScheduler::frame()
+inline std::int64_t levelClockNowNs() {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+// Single-producer/single-consumer ring buffer that keeps the newest entries.
+//
+// The producer (audio callback) is wait-free and never blocks or allocates: when
+// the consumer has fallen behind by Capacity entries, the oldest entry is dropped
+// (and counted) to make room, so what the consumer reads after a stall is the
+// latest history rather than a stale one. Dropping moves the read index with a
+// compare-and-swap, which the consumer also uses to claim an entry; a copy that
+// raced with the producer overwriting its slot fails that claim and is retried.
+template <typename T, std::size_t Capacity>
+class SpscRingBuffer final {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+  public:
+    // Producer side; true if nothing had to be dropped
+    bool push(const T& value) noexcept {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        std::size_t tail = tail_.load(std::memory_order_acquire);
+        bool kept = true;
+        if (head - tail >= Capacity) {
+            // On failure the consumer has just taken the oldest entry, which makes room too
+            if (tail_.compare_exchange_strong(tail, tail + 1, std::memory_order_acq_rel)) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                kept = false;
+            }
+        }
+        slots_[head & (Capacity - 1)] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return kept;
+    }
+
+    // Consumer side
+    bool pop(T& out) noexcept {
+        std::size_t tail = tail_.load(std::memory_order_acquire);
+        for (;;) {
+            const std::size_t head = head_.load(std::memory_order_acquire);
+            if (tail == head) {
+                return false;
+            }
+            out = slots_[tail & (Capacity - 1)];
+            // Fails (and reloads tail) if the producer dropped this entry meanwhile
+            if (tail_.compare_exchange_weak(tail, tail + 1, std::memory_order_acq_rel)) {
+                return true;
+            }
+        }
+    }
+
+    // Consumer side: discards everything pending, e.g. history that piled up while
+    // the consumer was not running
+    void clear() noexcept {
+        std::size_t tail = tail_.load(std::memory_order_acquire);
+        while (!tail_.compare_exchange_weak(tail, head_.load(std::memory_order_acquire), std::memory_order_acq_rel)) {
+        }
+    }
+
+    std::uint64_t droppedCount() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+  private:
+    alignas(64) std::atomic<std::size_t> head_{0}; // written by the producer only
+    alignas(64) std::atomic<std::size_t> tail_{0}; // consumer; the producer only to drop the oldest
+    alignas(64) std::atomic<std::uint64_t> dropped_{0};
+    std::array<T, Capacity> slots_{};
+};
+
+// ~2.5 s of history at 10 ms capture fragments (about 135 KB)
+using LevelRingBuffer = SpscRingBuffer<LevelSample, 256>;
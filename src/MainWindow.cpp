@@ -2,22 +2,112 @@
 
 #include <QCloseEvent>
 #include <QFileDialog>
+#include <QFileInfo>
 #include <QMenu>
 #include <QMenuBar>
 #include <QMessageBox>
-#include <QTimer>
 
-#if defined(ANALOGVU_HAS_LIBZIP) && (ANALOGVU_HAS_LIBZIP == 1)
-#include "SkinImporter.h"
-#endif
+#include <algorithm>
+#include <cstdlib>
+
+#include "AllocationGuard.h"
+#include "DeviceRegistry.h"
+#include "FrameScheduler.h"
+#include "PerfCounters.h"
+#include "StartupTrace.h"
 #include "StereoVUMeterWidget.h"
 #include "version.h"
 
-MainWindow::MainWindow(const AudioCapture::Options& options, QWidget* parent) : QMainWindow(parent), audio_(options) {
+MainWindow::MainWindow(const QList<AudioCapture::Options>& captures, const DisplayOptions& display, QWidget* parent)
+    : QMainWindow(parent), meterAllChannels_(display.meterAllChannels) {
     setWindowTitle("Analog VU Meter");
 
+    for (const AudioCapture::Options& options : captures) {
+        captureManager_.addCapture(options);
+    }
+    if (captureManager_.count() == 0) {
+        captureManager_.addCapture(AudioCapture::Options());
+    }
+    audio_ = captureManager_.capture(0);
+    levelInterpolators_.resize(static_cast<size_t>(captureManager_.count()));
+    for (AudioCapture* capture : captureManager_.captures()) {
+        captureBallistics_.push_back(capture->ballisticsProfile());
+    }
+
+    // The device menu is rebuilt from the registry's cache whenever a device comes or goes
+    deviceRegistry_ = new DeviceRegistry(this);
+    connect(deviceRegistry_, &DeviceRegistry::devicesChanged, this, &MainWindow::populateDeviceMenu);
+
+    // Device switches finish on the audio side; the menu follows once the new device delivers
+    connect(audio_, &AudioCapture::deviceChanged, this, &MainWindow::populateDeviceMenu);
+    connect(audio_, &AudioCapture::errorOccurred, this, [this](const QString& message) {
+        qWarning("MainWindow: %s", qPrintable(message));
+        refreshDeviceMenu();
+    });
+
+    // Connecting to the audio server can take seconds on a slow machine. The device
+    // list and the captures come up on the startup pool while the window is built and
+    // shown; both share the one server connection, whichever asks first makes it.
+    startupPool_.setMaxThreadCount(2);
+    startupTasks_ = 2;
+    startupPool_.start([this] {
+        QString error;
+        bool ok = false;
+        {
+            StartupTrace::Phase phase("device list");
+            ok = deviceRegistry_->start(&error);
+        }
+        QMetaObject::invokeMethod(
+            this,
+            [this, ok, error] {
+                if (!ok) {
+                    qWarning("MainWindow: device list unavailable: %s", qPrintable(error));
+                }
+                finishStartupTask();
+            },
+            Qt::QueuedConnection);
+    });
+    startupPool_.start([this] {
+        QStringList errors;
+        {
+            StartupTrace::Phase phase("audio connect");
+            captureManager_.retainConnection();
+            for (AudioCapture* capture : captureManager_.captures()) {
+                QString err;
+                if (!capture->start(&err)) {
+                    const QString device = capture->currentDeviceUID().isEmpty() ? tr("default device")
+                                                                                 : capture->currentDeviceUID();
+                    errors.append(QString("%1: %2").arg(device, err));
+                }
+            }
+        }
+        QMetaObject::invokeMethod(
+            this,
+            [this, errors] {
+                finishStartupTask();
+                if (!errors.isEmpty()) {
+                    // Show warning but continue - widget should still appear
+                    QMessageBox::warning(this,
+                                         "Audio capture error",
+                                         QString("Audio initialization failed: %1\n\nThe VU meter will be "
+                                                 "displayed but won't show audio levels.")
+                                             .arg(errors.join(QStringLiteral("\n"))));
+                }
+            },
+            Qt::QueuedConnection);
+    });
+
     meter_ = new StereoVUMeterWidget(this);
+    meter_->setNeedleAtlasStep(display.needleAtlasStepDeg);
+    if (display.useOpenGL) {
+        meter_->setRenderBackend(VUMeterRenderBackend::OpenGL);
+    }
+    meter_->setThreadedRendering(display.renderThread);
     setCentralWidget(meter_);
+    if (display.perfHud) {
+        PerfCounters::setEnabled(true);
+        meter_->setPerfHudVisible(true);
+    }
 
     resize(820, 340);
     setMinimumSize(680, 280);
@@ -25,29 +115,99 @@ MainWindow::MainWindow(const AudioCapture::Options& options, QWidget* parent) :
     // Create the menu bar
     createMenuBar();
 
-    QString err;
-    if (!audio_.start(&err)) {
-        // Show warning but continue - widget should still appear
-        QMessageBox::warning(
-            this,
-            "Audio capture error",
-            QString("Audio initialization failed: %1\n\nThe VU meter will be displayed but won't show audio levels.")
-                .arg(err));
-    }
-    auto* timer = new QTimer(this);
-    timer->setTimerType(Qt::PreciseTimer);
-    timer->setInterval(16);
-    connect(timer, &QTimer::timeout, this, [this]() { meter_->setLevels(audio_.leftVuDb(), audio_.rightVuDb()); });
-    timer->start();
+    // Frames follow the display refresh and pause while the window is not visible
+    frameScheduler_ = new FrameScheduler(meter_, this);
+    frameScheduler_->setMaxFps(display.maxFps);
+    connect(frameScheduler_, &FrameScheduler::frame, this, &MainWindow::updateMeters);
+    connect(frameScheduler_, &FrameScheduler::resumed, this, &MainWindow::discardStaleLevels);
+    frameScheduler_->start();
+
+    StartupTrace::mark("main window");
 }
 
-MainWindow::~MainWindow() { audio_.stop(); }
+MainWindow::~MainWindow() {
+    // A capture still starting would otherwise start after stopAll()
+    startupPool_.waitForDone();
+    importPool_.waitForDone();
+    captureManager_.stopAll();
+}
 
 void MainWindow::closeEvent(QCloseEvent* event) {
-    audio_.stop();
+    startupPool_.waitForDone();
+    captureManager_.stopAll();
     QMainWindow::closeEvent(event);
 }
 
+void MainWindow::discardStaleLevels() {
+    // The needles pick up from the next captured block, not from seconds-old history
+    for (int i = 0; i < captureManager_.count(); ++i) {
+        captureManager_.capture(i)->levelRing().clear();
+        levelInterpolators_[static_cast<size_t>(i)].reset();
+    }
+}
+
+void MainWindow::updateMeters(qint64 timestampNs) {
+    const bool perf = PerfCounters::enabled();
+    if (perf) {
+        PerfCounters::increment(PerfCounters::Counter::Frames);
+        const qint64 intervalNs = timestampNs - lastFrameNs_;
+        if (lastFrameNs_ > 0 && intervalNs < 1'000'000'000 && !frameScheduler_->isIdle()) {
+            const qreal fps = std::max<qreal>(1.0, frameScheduler_->framesPerSecond());
+            const auto nominalNs = static_cast<qint64>(1e9 / fps);
+            PerfCounters::record(PerfCounters::Histogram::FrameInterval, intervalNs);
+            PerfCounters::record(PerfCounters::Histogram::FrameJitter, std::abs(intervalNs - nominalNs));
+        }
+        lastFrameNs_ = timestampNs;
+    }
+
+    float levels[StereoVUMeterWidget::kMaxMeters];
+    qint64 newestCaptureNs = 0;
+    int count = 0;
+    auto append = [&](float vu) {
+        if (count < StereoVUMeterWidget::kMaxMeters) {
+            levels[count++] = vu;
+        }
+    };
+
+    for (int i = 0; i < captureManager_.count(); ++i) {
+        AudioCapture* capture = captureManager_.capture(i);
+        LevelInterpolator& interpolator = levelInterpolators_[static_cast<size_t>(i)];
+
+        interpolator.drain(capture->levelRing(), timestampNs);
+        if (!interpolator.hasSamples()) {
+            append(capture->leftVuDb());
+            append(capture->rightVuDb());
+            continue;
+        }
+
+        newestCaptureNs = std::max<qint64>(newestCaptureNs, interpolator.newestTimeNs());
+        const LevelSample sample = interpolator.sampleAt(timestampNs);
+        if (meterAllChannels_ && sample.channels > 0) {
+            for (unsigned int c = 0; c < sample.channels; ++c) {
+                append(sample.vu[c]);
+            }
+        } else {
+            append(sample.left());
+            append(sample.right());
+        }
+    }
+
+    if (perf && newestCaptureNs > 0) {
+        PerfCounters::markLevels(newestCaptureNs);
+    }
+
+    meter_->setMeterCount(count);
+    meter_->setLevels(levels, count);
+
+    // Resting needles are not repainted; once every capture has gone idle the frames
+    // slow down too, until one of them hears signal again
+    bool idle = true;
+    for (const AudioCapture* capture : captureManager_.captures()) {
+        idle = idle && capture->isIdle();
+    }
+    frameScheduler_->setIdle(idle);
+}
+
 void MainWindow::createMenuBar() {
     QMenuBar* menuBar = this->menuBar();
 
@@ -76,10 +236,21 @@ void MainWindow::createMenuBar() {
     // Populate the reference menu
     populateReferenceMenu();
 
+    // Both menus change the captures, so they wait until start() has finished with them
+    deviceMenu_->setEnabled(false);
+    referenceMenu_->setEnabled(false);
+
     // Add separator and refresh action
     audioMenu_->addSeparator();
-    QAction* refreshAction = audioMenu_->addAction(tr("&Refresh Devices"));
-    connect(refreshAction, &QAction::triggered, this, &MainWindow::refreshDeviceMenu);
+    refreshDevicesAction_ = audioMenu_->addAction(tr("&Refresh Devices"));
+    refreshDevicesAction_->setEnabled(false);
+    connect(refreshDevicesAction_, &QAction::triggered, this, &MainWindow::refreshDeviceMenu);
+    QAction* statsAction = audioMenu_->addAction(tr("Capture &Statistics..."));
+    connect(statsAction, &QAction::triggered, this, &MainWindow::showCaptureStats);
+    perfHudAction_ = audioMenu_->addAction(tr("&Performance Overlay"));
+    perfHudAction_->setCheckable(true);
+    perfHudAction_->setChecked(meter_->perfHudVisible());
+    connect(perfHudAction_, &QAction::toggled, this, &MainWindow::onPerfHudToggled);
 
     // Style menu
     styleMenu_ = menuBar->addMenu(tr("&Style"));
@@ -95,8 +266,26 @@ void MainWindow::createMenuBar() {
     skinStyleActionGroup_->setExclusive(true);
     connect(skinStyleActionGroup_, &QActionGroup::triggered, this, &MainWindow::onSkinSelected);
 
-    skinManager_.scan();
+    // Skins decode in the background; start on the one under the mouse before it is clicked
+    connect(&skinManager_, &SkinManager::skinLoaded, this, &MainWindow::onSkinLoaded);
+    connect(skinStyleMenu_, &QMenu::hovered, this, [this](QAction* action) {
+        const QString skinId = action->data().toString();
+        if (!skinId.isEmpty() && skinId != QStringLiteral("__default__"))
+            skinManager_.prefetch(skinId);
+    });
+
+    // Only the default skin is listed until the scan is back
+    connect(&skinManager_, &SkinManager::skinsScanned, this, &MainWindow::populateStyleMenu);
     populateStyleMenu();
+    skinManager_.scanAsync();
+
+    // Renderer toggle (applies to skins; vector styles always use QPainter)
+    styleMenu_->addSeparator();
+    gpuRenderingAction_ = styleMenu_->addAction(tr("Use &GPU Rendering"));
+    gpuRenderingAction_->setCheckable(true);
+    gpuRenderingAction_->setChecked(meter_->renderBackend() == VUMeterRenderBackend::OpenGL);
+    gpuRenderingAction_->setEnabled(StereoVUMeterWidget::isRenderBackendAvailable(VUMeterRenderBackend::OpenGL));
+    connect(gpuRenderingAction_, &QAction::toggled, this, &MainWindow::onGpuRenderingToggled);
 
     // About action - Qt automatically moves this to the app menu on macOS
     QAction* aboutAction = new QAction(tr("About Analog VU Meter"), this);
@@ -105,6 +294,36 @@ void MainWindow::createMenuBar() {
     audioMenu_->addAction(aboutAction);
 }
 
+void MainWindow::showCaptureStats() {
+    QString text;
+    for (AudioCapture* capture : captureManager_.captures()) {
+        const AudioCapture::CaptureStats stats = capture->stats();
+        const QString device =
+            capture->currentDeviceUID().isEmpty() ? tr("Default device") : capture->currentDeviceUID();
+
+        text += tr("<p><b>%1</b><br>"
+                   "Callbacks: %2<br>"
+                   "Worst callback: %3 ms<br>"
+                   "Deadline misses: %4<br>"
+                   "Realtime priority: %5<br>"
+                   "Overruns: %6, holes: %7, dropped levels: %8</p>")
+                    .arg(device.toHtmlEscaped())
+                    .arg(stats.callbacks)
+                    .arg(static_cast<double>(stats.worstCallbackNs) / 1e6, 0, 'f', 3)
+                    .arg(stats.deadlineMisses)
+                    .arg(stats.realtime ? tr("yes") : tr("no"))
+                    .arg(stats.overflows)
+                    .arg(stats.holes)
+                    .arg(stats.droppedLevels);
+    }
+
+    if (AllocationGuard::enabled()) {
+        text += tr("<p>Allocations on the audio path: %1</p>").arg(AllocationGuard::violations());
+    }
+
+    QMessageBox::information(this, tr("Capture Statistics"), text);
+}
+
 void MainWindow::showAbout() {
     QMessageBox::about(this,
                        tr("About Analog VU Meter"),
@@ -126,10 +345,11 @@ void MainWindow::populateDeviceMenu() {
         deviceActionGroup_->removeAction(action);
     }
 
-    // Get list of input devices
-    QList<AudioCapture::DeviceInfo> devices = AudioCapture::enumerateInputDevices();
+    // Cached by the registry; reading it never waits on the audio server
+    const QList<AudioCapture::DeviceInfo> devices = deviceRegistry_->devices();
 
-    QString currentUID = audio_.currentDeviceUID();
+    // Written by start() on the startup pool until the captures are up
+    QString currentUID = startupTasks_ > 0 ? QString() : audio_->currentDeviceUID();
 
     for (const AudioCapture::DeviceInfo& device : devices) {
         QString displayName = device.name;
@@ -166,7 +386,7 @@ void MainWindow::populateReferenceMenu() {
     // dBFS reference values: +6 to -20 in 2 dB steps
     const int referenceValues[] = {6, 4, 2, 0, -2, -4, -6, -8, -10, -12, -14, -16, -18, -20};
 
-    double currentRef = audio_.referenceDbfs();
+    double currentRef = audio_->referenceDbfs();
 
     for (int value : referenceValues) {
         QString displayName = QString("%1 dB").arg(value);
@@ -202,12 +422,13 @@ void MainWindow::onDeviceSelected(QAction* action) {
     }
 
     // Don't switch if it's already the current device
-    if (deviceUID == audio_.currentDeviceUID()) {
+    if (deviceUID == audio_->currentDeviceUID()) {
         return;
     }
 
+    // The current device keeps metering until the new one delivers audio
     QString err;
-    if (!audio_.switchDevice(deviceUID, &err)) {
+    if (!audio_->switchDeviceAsync(deviceUID, &err)) {
         QMessageBox::warning(this,
                              tr("Device Switch Failed"),
                              tr("Failed to switch to device: %1\n\nError: %2").arg(action->text()).arg(err));
@@ -219,10 +440,30 @@ void MainWindow::onDeviceSelected(QAction* action) {
 
 void MainWindow::onReferenceSelected(QAction* action) {
     int referenceDb = action->data().toInt();
-    audio_.setReferenceDbfs(static_cast<double>(referenceDb));
+    for (AudioCapture* capture : captureManager_.captures()) {
+        capture->setReferenceDbfs(static_cast<double>(referenceDb));
+    }
 }
 
-void MainWindow::refreshDeviceMenu() { populateDeviceMenu(); }
+void MainWindow::refreshDeviceMenu() {
+    // The rescan completes in the background and arrives as devicesChanged().
+    // During startup the registry is still connecting and scans on its own.
+    if (startupTasks_ == 0) {
+        deviceRegistry_->refresh();
+    }
+    populateDeviceMenu();
+}
+
+void MainWindow::finishStartupTask() {
+    if (--startupTasks_ > 0) {
+        return;
+    }
+    deviceMenu_->setEnabled(true);
+    referenceMenu_->setEnabled(true);
+    refreshDevicesAction_->setEnabled(true);
+    populateDeviceMenu();
+    StartupTrace::mark("audio ready");
+}
 
 void MainWindow::populateStyleMenu() {
     if (!styleMenu_ || !vectorStyleMenu_ || !skinStyleMenu_)
@@ -292,6 +533,8 @@ void MainWindow::populateStyleMenu() {
     connect(importSkinAction, &QAction::triggered, this, &MainWindow::importSkin);
 #if !defined(ANALOGVU_HAS_LIBZIP) || (ANALOGVU_HAS_LIBZIP == 0)
     importSkinAction->setEnabled(false);
+#else
+    importSkinAction->setEnabled(!importingSkins_);
 #endif
 }
 
@@ -306,9 +549,11 @@ void MainWindow::onVectorStyleSelected(QAction* action) {
         skinStyleActionGroup_->checkedAction()->setChecked(false);
     }
 
+    pendingSkinId_.clear();
     skinManager_.clearActiveSkin();
     meter_->clearSkin();
     meter_->setStyle(style);
+    applySkinBallistics(nullptr);
 }
 
 void MainWindow::onSkinSelected(QAction* action) {
@@ -320,17 +565,29 @@ void MainWindow::onSkinSelected(QAction* action) {
     }
 
     const QString skinId = action->data().toString();
+    pendingSkinId_.clear();
     if (skinId == QStringLiteral("__default__")) {
         skinManager_.clearActiveSkin();
         meter_->clearSkin();
         meter_->setStyle(VUMeterStyle::Skin);
+        applySkinBallistics(nullptr);
         return;
     }
 
     if (skinId.isEmpty())
         return;
 
-    const SkinManager::LoadedSkin loaded = skinManager_.loadSkin(skinId);
+    // The current face stays up until the new one is decoded
+    pendingSkinId_ = skinId;
+    skinManager_.loadSkinAsync(skinId);
+}
+
+void MainWindow::onSkinLoaded(const QString& skinId, const SkinManager::LoadedSkin& loaded) {
+    // Prefetched skins, and skins that were picked and then replaced by another choice
+    if (skinId != pendingSkinId_)
+        return;
+    pendingSkinId_.clear();
+
     if (!loaded.ok) {
         QMessageBox::warning(this, tr("Skin Load Failed"), loaded.error);
         populateStyleMenu();
@@ -340,11 +597,35 @@ void MainWindow::onSkinSelected(QAction* action) {
     skinManager_.setActiveSkinId(skinId);
     meter_->setSkinPackage(loaded.package, loaded.singleScale, loaded.leftScale, loaded.rightScale);
     meter_->setStyle(VUMeterStyle::Skin);
+    applySkinBallistics(&loaded.package);
+
+    // An imported skin was not picked in the menu, so the checked entry follows here
+    populateStyleMenu();
+}
+
+void MainWindow::applySkinBallistics(const VUSkinPackage* package) {
+    const QList<AudioCapture*> captures = captureManager_.captures();
+    for (int i = 0; i < captures.size(); ++i) {
+        const bool fromSkin = package && package->hasBallistics;
+        captures[i]->setBallisticsProfile(fromSkin ? package->ballistics : captureBallistics_[static_cast<size_t>(i)]);
+    }
+}
+
+void MainWindow::onGpuRenderingToggled(bool enabled) {
+    meter_->setRenderBackend(enabled ? VUMeterRenderBackend::OpenGL : VUMeterRenderBackend::Raster);
+}
+
+void MainWindow::onPerfHudToggled(bool enabled) {
+    // The counters only run while someone looks at them
+    PerfCounters::setEnabled(enabled);
+    lastFrameNs_ = 0;
+    meter_->setPerfHudVisible(enabled);
 }
 
 void MainWindow::importSkin() {
-    const QString filePath = QFileDialog::getOpenFileName(this, tr("Import AIMP Skin"), QString(), tr("ZIP files (*.zip)"));
-    if (filePath.isEmpty())
+    const QStringList filePaths =
+        QFileDialog::getOpenFileNames(this, tr("Import AIMP Skins"), QString(), tr("ZIP files (*.zip)"));
+    if (filePaths.isEmpty())
         return;
 
 #if !defined(ANALOGVU_HAS_LIBZIP) || (ANALOGVU_HAS_LIBZIP == 0)
@@ -353,25 +634,43 @@ void MainWindow::importSkin() {
                          tr("Skin import is disabled because libzip was not found at build time."));
     return;
 #else
-    SkinImporter importer;
-    const SkinImporter::ImportResult r = importer.importAimpZip(filePath);
-    if (!r.ok) {
-        QMessageBox::warning(this, tr("Import Failed"), r.error);
-        return;
+    // Inflating and validating a large collection takes a while; the window keeps
+    // running meanwhile and Import Skin stays disabled until the batch is back
+    importingSkins_ = true;
+    populateStyleMenu();
+    importPool_.start([this, filePaths] {
+        const QList<SkinImporter::ImportResult> results = SkinImporter().importAimpZips(filePaths);
+        QMetaObject::invokeMethod(
+            this, [this, filePaths, results] { onSkinsImported(filePaths, results); }, Qt::QueuedConnection);
+    });
+#endif
+}
+
+#if defined(ANALOGVU_HAS_LIBZIP) && (ANALOGVU_HAS_LIBZIP == 1)
+void MainWindow::onSkinsImported(const QStringList& filePaths, const QList<SkinImporter::ImportResult>& results) {
+    importingSkins_ = false;
+
+    QStringList failures;
+    QString importedSkin; // the last one imported is shown
+    for (qsizetype i = 0; i < results.size(); ++i) {
+        if (results[i].ok) {
+            importedSkin = results[i].skinName;
+        } else {
+            failures.append(QStringLiteral("%1: %2").arg(QFileInfo(filePaths[i]).fileName(), results[i].error));
+        }
+    }
+    if (!failures.isEmpty()) {
+        QMessageBox::warning(this, tr("Import Failed"), failures.join(QStringLiteral("\n")));
     }
 
     skinManager_.scan();
-
-    const SkinManager::LoadedSkin loaded = skinManager_.loadSkin(r.skinName);
-    if (!loaded.ok) {
-        QMessageBox::warning(this, tr("Skin Load Failed"), loaded.error);
-        populateStyleMenu();
+    populateStyleMenu();
+    if (importedSkin.isEmpty())
         return;
-    }
 
-    skinManager_.setActiveSkinId(r.skinName);
-    meter_->setSkinPackage(loaded.package, loaded.singleScale, loaded.leftScale, loaded.rightScale);
-    meter_->setStyle(VUMeterStyle::Skin);
-    populateStyleMenu();
-#endif
+    // Decoded in the background like a skin picked in the menu (onSkinLoaded());
+    // loading it also compiles the skin into the skin cache
+    pendingSkinId_ = importedSkin;
+    skinManager_.loadSkinAsync(importedSkin);
 }
+#endif
@@ -3,9 +3,21 @@
 #include <QActionGroup>
 #include <QMainWindow>
 
+#include <QList>
+#include <QThreadPool>
+
+#include <vector>
+
 #include "AudioCapture.h"
+#include "CaptureManager.h"
+#include "LevelInterpolator.h"
 #include "SkinManager.h"
+#if defined(ANALOGVU_HAS_LIBZIP) && (ANALOGVU_HAS_LIBZIP == 1)
+#include "SkinImporter.h"
+#endif
 
+class DeviceRegistry;
+class FrameScheduler;
 class StereoVUMeterWidget;
 class QCloseEvent;
 class QMenu;
@@ -15,7 +27,31 @@ class MainWindow final : public QMainWindow {
     Q_OBJECT
 
   public:
-    explicit MainWindow(const AudioCapture::Options& options, QWidget* parent = nullptr);
+    // Rendering settings that come from the command line
+    struct DisplayOptions final {
+        // Angular step of the pre-rotated skin needle sprites in degrees (0 = rotate every frame)
+        float needleAtlasStepDeg = 0.0f;
+
+        // Draw skins through the OpenGL renderer instead of QPainter
+        bool useOpenGL = false;
+
+        // Compose raster frames on a render thread; the GUI thread only presents them
+        bool renderThread = false;
+
+        // Upper bound for the meter frame rate (0 = follow the display refresh rate)
+        int maxFps = 0;
+
+        // One meter per captured channel instead of a stereo pair
+        bool meterAllChannels = false;
+
+        // Start with the performance overlay shown (and the counters running)
+        bool perfHud = false;
+    };
+
+    // The first capture is the main one (Audio menu); the others are metered next to it
+    explicit MainWindow(const QList<AudioCapture::Options>& captures,
+                        const DisplayOptions& display = DisplayOptions(),
+                        QWidget* parent = nullptr);
     ~MainWindow() override;
 
   protected:
@@ -26,8 +62,12 @@ class MainWindow final : public QMainWindow {
     void onReferenceSelected(QAction* action);
     void onVectorStyleSelected(QAction* action);
     void onSkinSelected(QAction* action);
+    void onSkinLoaded(const QString& skinId, const SkinManager::LoadedSkin& loaded);
+    void onGpuRenderingToggled(bool enabled);
+    void onPerfHudToggled(bool enabled);
     void importSkin();
     void refreshDeviceMenu();
+    void showCaptureStats();
     void showAbout();
 
   private:
@@ -36,10 +76,41 @@ class MainWindow final : public QMainWindow {
     void populateReferenceMenu();
     void populateStyleMenu();
 
-    AudioCapture audio_;
+    // Feeds the meters of every capture, in capture order, for one display frame
+    void updateMeters(qint64 timestampNs);
+
+    // Drops the levels that piled up while no frames were drawn
+    void discardStaleLevels();
+
+    // The skin's ballistics if it has any, otherwise each capture's own (nullptr = no skin)
+    void applySkinBallistics(const VUSkinPackage* package);
+
+    // GUI thread, as each startup connection (device list, captures) is made or has failed;
+    // the device menu is enabled after the last one
+    void finishStartupTask();
+
+    CaptureManager captureManager_;
+    AudioCapture* audio_ = nullptr; // main capture, owned by captureManager_
+    DeviceRegistry* deviceRegistry_ = nullptr;
     StereoVUMeterWidget* meter_ = nullptr;
+    FrameScheduler* frameScheduler_ = nullptr;
+    std::vector<LevelInterpolator> levelInterpolators_; // one per capture
+    std::vector<VuBallisticsProfile> captureBallistics_; // from the command line, one per capture
+    bool meterAllChannels_ = false;
+    qint64 lastFrameNs_ = 0; // frame interval statistics, only kept while PerfCounters are enabled
 
     SkinManager skinManager_;
+    QString pendingSkinId_; // picked in the menu, still decoding
+
+    // Skin imports run on importPool_; the results are handled on the GUI thread
+#if defined(ANALOGVU_HAS_LIBZIP) && (ANALOGVU_HAS_LIBZIP == 1)
+    void onSkinsImported(const QStringList& filePaths, const QList<SkinImporter::ImportResult>& results);
+#endif
+    QThreadPool importPool_;
+    bool importingSkins_ = false;
+
+    QThreadPool startupPool_;
+    int startupTasks_ = 0; // still running on startupPool_
 
     // Menu components
     QMenu* audioMenu_ = nullptr;
@@ -52,4 +123,7 @@ class MainWindow final : public QMainWindow {
     QActionGroup* referenceActionGroup_ = nullptr;
     QActionGroup* vectorStyleActionGroup_ = nullptr;
     QActionGroup* skinStyleActionGroup_ = nullptr;
+    QAction* refreshDevicesAction_ = nullptr;
+    QAction* gpuRenderingAction_ = nullptr;
+    QAction* perfHudAction_ = nullptr;
 };
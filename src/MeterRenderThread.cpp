@@ -0,0 +1,175 @@
+#include "MeterRenderThread.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QMutexLocker>
+#include <QPainter>
+#include <QPainterPath>
+
+#include "PerfCounters.h"
+
+static constexpr float kPi = 3.14159265358979323846f;
+
+// -------- MeterRenderScene --------
+
+void MeterRenderScene::drawNeedle(QPainter& p, const VectorNeedle& needle, float angleDeg) {
+    // Same float math as the widget's own needle, so both paths draw identical frames
+    const float theta = angleDeg * (kPi / 180.0f);
+    const auto length = static_cast<float>(needle.length);
+    const QPointF tip(needle.pivot.x() + length * std::sin(theta), needle.pivot.y() - length * std::cos(theta));
+
+    // The needle is only visible within the face, which hides the pivot area
+    p.save();
+    QPainterPath clipPath;
+    clipPath.addRoundedRect(needle.face, needle.faceRadius, needle.faceRadius);
+    p.setClipPath(clipPath, Qt::IntersectClip);
+
+    const QPointF shadowOffset(2.0, 2.0);
+    p.setPen(QPen(needle.shadowColor, needle.width, Qt::SolidLine, Qt::RoundCap));
+    p.drawLine(needle.pivot + shadowOffset, tip + shadowOffset);
+
+    p.setPen(QPen(needle.color, needle.width, Qt::SolidLine, Qt::RoundCap));
+    p.drawLine(needle.pivot, tip);
+
+    p.restore();
+}
+
+void MeterRenderScene::drawNeedle(QPainter& p, const SkinNeedle& needle, float angleDeg) {
+    if (const NeedleSpriteAtlas::Sprite* sprite = needle.atlas.spriteFor(angleDeg)) {
+        p.drawImage(sprite->position, sprite->image);
+        return;
+    }
+
+    p.save();
+    p.translate(needle.pivot);
+    p.rotate(angleDeg);
+    p.translate(-needle.pivot);
+    p.drawImage(needle.target, needle.image);
+    p.restore();
+}
+
+// -------- MeterRenderThread --------
+
+MeterRenderThread::MeterRenderThread(QObject* parent) : QThread(parent) {}
+
+MeterRenderThread::~MeterRenderThread() {
+    {
+        QMutexLocker lock(&mutex_);
+        quit_ = true;
+        wake_.wakeOne();
+    }
+    wait();
+}
+
+std::uint64_t
+MeterRenderThread::setScene(std::shared_ptr<const MeterRenderScene> scene, const float* anglesDeg, int count) {
+    QMutexLocker lock(&mutex_);
+    scene_ = std::move(scene);
+    return queueFrame(anglesDeg, count);
+}
+
+std::uint64_t MeterRenderThread::submit(const float* anglesDeg, int count) {
+    QMutexLocker lock(&mutex_);
+    return queueFrame(anglesDeg, count);
+}
+
+std::uint64_t MeterRenderThread::queueFrame(const float* anglesDeg, int count) {
+    angleCount_ = std::clamp(count, 0, kMaxMeters);
+    std::copy(anglesDeg, anglesDeg + angleCount_, angles_.begin());
+    pending_ = true;
+    wake_.wakeOne();
+    return ++submittedSerial_;
+}
+
+bool MeterRenderThread::present(QPainter& p) {
+    QMutexLocker lock(&mutex_);
+    presentPending_ = false;
+    if (front_ < 0 || !scene_ || frontScene_ != scene_) {
+        return false;
+    }
+
+    // The worker only ever draws into the other buffer
+    p.drawImage(QPointF(0, 0), buffers_[front_]);
+    return true;
+}
+
+std::uint64_t MeterRenderThread::completedSerial() const {
+    QMutexLocker lock(&mutex_);
+    return frontSerial_;
+}
+
+void MeterRenderThread::run() {
+    std::array<float, kMaxMeters> angles{};
+
+    for (;;) {
+        std::shared_ptr<const MeterRenderScene> scene;
+        int count = 0;
+        std::uint64_t serial = 0;
+        int back = 0;
+        {
+            QMutexLocker lock(&mutex_);
+            while (!quit_ && !pending_) {
+                wake_.wait(&mutex_);
+            }
+            if (quit_) {
+                return;
+            }
+            pending_ = false;
+            scene = scene_;
+            count = angleCount_;
+            std::copy(angles_.begin(), angles_.begin() + count, angles.begin());
+            serial = submittedSerial_;
+            back = (front_ == 0) ? 1 : 0;
+        }
+        if (!scene || scene->pixelSize.isEmpty()) {
+            continue;
+        }
+
+        const std::int64_t startNs = PerfCounters::enabled() ? PerfCounters::nowNs() : 0;
+        compose(*scene, angles.data(), count, buffers_[back]);
+        if (startNs > 0) {
+            PerfCounters::record(PerfCounters::Histogram::Compose, PerfCounters::nowNs() - startNs);
+        }
+
+        bool notify = false;
+        {
+            QMutexLocker lock(&mutex_);
+            front_ = back;
+            frontScene_ = scene;
+            frontSerial_ = serial;
+            notify = !presentPending_;
+            presentPending_ = true;
+        }
+        if (notify) {
+            emit frameReady();
+        }
+    }
+}
+
+void MeterRenderThread::compose(const MeterRenderScene& scene, const float* anglesDeg, int count, QImage& target) {
+    if (target.size() != scene.pixelSize) {
+        target = QImage(scene.pixelSize, QImage::Format_ARGB32_Premultiplied);
+    }
+    target.setDevicePixelRatio(scene.dpr);
+
+    QPainter p(&target);
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.drawImage(QPointF(0, 0), scene.background);
+
+    if (!scene.skinNeedles.isEmpty()) {
+        const int n = std::min(count, static_cast<int>(scene.skinNeedles.size()));
+        for (int i = 0; i < n; ++i) {
+            MeterRenderScene::drawNeedle(p, scene.skinNeedles[i], anglesDeg[i]);
+        }
+    } else {
+        const int n = std::min(count, static_cast<int>(scene.vectorNeedles.size()));
+        for (int i = 0; i < n; ++i) {
+            MeterRenderScene::drawNeedle(p, scene.vectorNeedles[i], anglesDeg[i]);
+        }
+    }
+
+    if (!scene.foreground.isNull()) {
+        p.drawImage(QPointF(0, 0), scene.foreground);
+    }
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <QColor>
+#include <QImage>
+#include <QMutex>
+#include <QPointF>
+#include <QRectF>
+#include <QSize>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include "NeedleSpriteAtlas.h"
+
+class QPainter;
+
+// Everything a meter frame is composed from, prepared by the widget on the GUI
+// thread whenever the size, DPR, style, skin or meter count changes. The images
+// are implicitly shared copies of the widget's cached layers and are only read
+// once the scene is published, so the render thread needs no lock for them.
+struct MeterRenderScene final {
+    // Vector styles: a line from the pivot with a drop shadow, clipped to the face
+    struct VectorNeedle {
+        QRectF face;
+        qreal faceRadius = 0.0;
+        QPointF pivot;
+        qreal length = 0.0;
+        qreal width = 0.0;
+        QColor color;
+        QColor shadowColor;
+    };
+
+    // Skin mode: the needle layer rotated about the pivot, or a pre-rotated sprite
+    struct SkinNeedle {
+        QImage image;
+        QRectF target; // where the unrotated image is drawn
+        QPointF pivot;
+        NeedleSpriteAtlas atlas; // empty unless built for this meter's rect and DPR
+    };
+
+    static void drawNeedle(QPainter& p, const VectorNeedle& needle, float angleDeg);
+    static void drawNeedle(QPainter& p, const SkinNeedle& needle, float angleDeg);
+
+    QSize pixelSize;
+    qreal dpr = 1.0;
+    QImage background; // opaque, everything below the needles
+    QImage foreground; // transparent, everything above them
+    QVector<VectorNeedle> vectorNeedles;
+    QVector<SkinNeedle> skinNeedles; // used instead of vectorNeedles in Skin mode
+};
+
+// Composes meter frames off the GUI thread.
+//
+// The GUI thread publishes a scene and, per frame, the needle angles; the worker
+// draws the scene's layers and needles into the back one of two QImages and then
+// swaps it to the front. The GUI thread only blits the front image in its paint
+// event, so composition runs on a second core and a slow GUI frame does not hold
+// up the next one. A newer submission replaces one the worker has not started.
+class MeterRenderThread final : public QThread {
+    Q_OBJECT
+
+  public:
+    static constexpr int kMaxMeters = 64;
+
+    explicit MeterRenderThread(QObject* parent = nullptr);
+    ~MeterRenderThread() override; // stops and joins the worker
+
+    // Replaces the scene, together with the angles of its first frame; frames of
+    // the old scene are no longer presented. Returns the frame's serial.
+    std::uint64_t setScene(std::shared_ptr<const MeterRenderScene> scene, const float* anglesDeg, int count);
+
+    // Angles of the first `count` meters for the next frame; returns the frame's serial
+    std::uint64_t submit(const float* anglesDeg, int count);
+
+    // GUI thread: draws the newest completed frame of the current scene at (0, 0).
+    // Returns false if there is none yet, e.g. right after setScene().
+    bool present(QPainter& p);
+
+    // Serial of the newest completed frame
+    std::uint64_t completedSerial() const;
+
+  signals:
+    // A frame was completed; not emitted again until the next present()
+    void frameReady();
+
+  protected:
+    void run() override;
+
+  private:
+    // With the lock held
+    std::uint64_t queueFrame(const float* anglesDeg, int count);
+
+    static void compose(const MeterRenderScene& scene, const float* anglesDeg, int count, QImage& target);
+
+    mutable QMutex mutex_;
+    QWaitCondition wake_;
+    bool quit_ = false;
+    bool pending_ = false;
+    bool presentPending_ = false;
+
+    std::shared_ptr<const MeterRenderScene> scene_;
+    std::array<float, kMaxMeters> angles_{};
+    int angleCount_ = 0;
+    std::uint64_t submittedSerial_ = 0;
+
+    // Two frame buffers: the worker draws into back, present() blits front
+    std::array<QImage, 2> buffers_;
+    int front_ = -1;
+    std::shared_ptr<const MeterRenderScene> frontScene_;
+    std::uint64_t frontSerial_ = 0;
+};
@@ -0,0 +1,118 @@
+#include "NeedleSpriteAtlas.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QPainter>
+#include <QTransform>
+
+void NeedleSpriteAtlas::clear() {
+    sprites_.clear();
+    meterRect_ = QRectF();
+    dpr_ = 0.0;
+}
+
+void NeedleSpriteAtlas::build(const QPixmap& needle,
+                              const QRect& opaqueRect,
+                              const QRectF& meterRect,
+                              const QPointF& pivot,
+                              qreal dpr,
+                              float minDeg,
+                              float maxDeg,
+                              float stepDeg) {
+    clear();
+
+    if (needle.isNull() || opaqueRect.isNull() || meterRect.isEmpty() || stepDeg <= 0.0f || dpr <= 0.0) {
+        return;
+    }
+    if (maxDeg < minDeg) {
+        std::swap(minDeg, maxDeg);
+    }
+    stepDeg = std::max({stepDeg, kMinStepDeg, (maxDeg - minDeg) / static_cast<float>(kMaxSprites - 1)});
+
+    const qreal scaleX = meterRect.width() / needle.width();
+    const qreal scaleY = meterRect.height() / needle.height();
+
+    // Opaque needle area in widget coordinates (unrotated)
+    const QRectF opaque(meterRect.left() + opaqueRect.left() * scaleX,
+                        meterRect.top() + opaqueRect.top() * scaleY,
+                        opaqueRect.width() * scaleX,
+                        opaqueRect.height() * scaleY);
+
+    const int count = std::min(kMaxSprites, static_cast<int>(std::ceil((maxDeg - minDeg) / stepDeg)) + 1);
+    sprites_.reserve(count);
+
+    for (int i = 0; i < count; ++i) {
+        const float angleDeg = std::min(maxDeg, minDeg + i * stepDeg);
+
+        QTransform rotation;
+        rotation.translate(pivot.x(), pivot.y());
+        rotation.rotate(angleDeg);
+        rotation.translate(-pivot.x(), -pivot.y());
+
+        // Device-pixel bounds of the rotated needle, padded for smooth-transform bleed
+        const QRectF logicalBounds = rotation.mapRect(opaque).adjusted(-1.0, -1.0, 1.0, 1.0);
+        const QRect deviceBounds(QPoint(static_cast<int>(std::floor(logicalBounds.left() * dpr)),
+                                        static_cast<int>(std::floor(logicalBounds.top() * dpr))),
+                                 QPoint(static_cast<int>(std::ceil(logicalBounds.right() * dpr)),
+                                        static_cast<int>(std::ceil(logicalBounds.bottom() * dpr))));
+
+        Sprite sprite;
+        sprite.position = QPointF(deviceBounds.left() / dpr, deviceBounds.top() / dpr);
+        sprite.image = QImage(deviceBounds.size(), QImage::Format_ARGB32_Premultiplied);
+        sprite.image.setDevicePixelRatio(dpr);
+        sprite.image.fill(Qt::transparent);
+
+        {
+            QPainter p(&sprite.image);
+            p.setRenderHint(QPainter::Antialiasing, true);
+            p.setRenderHint(QPainter::SmoothPixmapTransform, true);
+
+            // Same transform the direct path uses, shifted into sprite space
+            p.translate(-sprite.position);
+            p.setTransform(rotation, true);
+            p.drawPixmap(meterRect, needle, needle.rect());
+        }
+
+        sprites_.push_back(sprite);
+    }
+
+    meterRect_ = meterRect;
+    dpr_ = dpr;
+    minDeg_ = minDeg;
+    stepDeg_ = stepDeg;
+}
+
+bool NeedleSpriteAtlas::matches(const QRectF& meterRect, qreal dpr) const {
+    return !sprites_.isEmpty() && meterRect_ == meterRect && qFuzzyCompare(dpr_, dpr);
+}
+
+const NeedleSpriteAtlas::Sprite* NeedleSpriteAtlas::spriteFor(float angleDeg) const {
+    const int index = spriteIndex(angleDeg);
+    return index < 0 ? nullptr : &sprites_[index];
+}
+
+int NeedleSpriteAtlas::spriteIndex(float angleDeg) const {
+    if (sprites_.isEmpty()) {
+        return -1;
+    }
+
+    const int index = static_cast<int>(std::lround((angleDeg - minDeg_) / stepDeg_));
+    return std::clamp(index, 0, static_cast<int>(sprites_.size()) - 1);
+}
+
+QRectF NeedleSpriteAtlas::spriteBounds(int index) const {
+    if (index < 0 || index >= sprites_.size()) {
+        return {};
+    }
+    const Sprite& s = sprites_[index];
+    return QRectF(s.position, s.image.deviceIndependentSize());
+}
+
+qsizetype NeedleSpriteAtlas::byteSize() const {
+    qsizetype bytes = 0;
+    for (const Sprite& s : sprites_) {
+        bytes += s.image.sizeInBytes();
+    }
+    return bytes;
+}
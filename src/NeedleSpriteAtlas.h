@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QImage>
+#include <QList>
+#include <QPixmap>
+#include <QPointF>
+#include <QRect>
+#include <QRectF>
+
+// Pre-rotated needle sprites for Skin mode.
+//
+// The needle image is rendered once per quantized angle at the exact size and
+// device pixel ratio it is displayed at, cropped to the rotated needle bounds and
+// stored as premultiplied ARGB. Drawing a frame is then a plain, untransformed blit.
+// Sprites are positioned on the device pixel grid, so the atlas is tied to the
+// meter rectangle it was built for.
+class NeedleSpriteAtlas final {
+  public:
+    // Finer steps are not visible, and each sprite is a full rotated needle image
+    static constexpr float kMinStepDeg = 0.1f;
+    // At most this many sprites per atlas; a finer step is coarsened to fit
+    static constexpr int kMaxSprites = 1024;
+
+    struct Sprite {
+        QImage image;     // premultiplied ARGB, devicePixelRatio set
+        QPointF position; // widget-space top-left, aligned to device pixels
+    };
+
+    void clear();
+    bool isEmpty() const { return sprites_.isEmpty(); }
+
+    // needle:       full-size needle image (same size as the face)
+    // opaqueRect:   non-transparent part of the needle image, in image pixels
+    // meterRect:    widget-space rectangle the face/needle is drawn into
+    // pivot:        widget-space rotation center
+    // minDeg/maxDeg: angular range to cover; stepDeg: angular resolution
+    //                (at least kMinStepDeg, and coarse enough for kMaxSprites)
+    void build(const QPixmap& needle,
+               const QRect& opaqueRect,
+               const QRectF& meterRect,
+               const QPointF& pivot,
+               qreal dpr,
+               float minDeg,
+               float maxDeg,
+               float stepDeg);
+
+    bool matches(const QRectF& meterRect, qreal dpr) const;
+    const Sprite* spriteFor(float angleDeg) const;
+
+    // Index of the sprite spriteFor() returns for angleDeg (-1 if the atlas is empty),
+    // and the widget-space area that sprite covers
+    int spriteIndex(float angleDeg) const;
+    QRectF spriteBounds(int index) const;
+
+    // Total pixel memory held by the sprites
+    qsizetype byteSize() const;
+
+  private:
+    QList<Sprite> sprites_;
+    QRectF meterRect_;
+    qreal dpr_ = 0.0;
+    float minDeg_ = 0.0f;
+    float stepDeg_ = 1.0f;
+};
@@ -0,0 +1,211 @@
+#include "PerfCounters.h"
+
+#include <QString>
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+
+// -------- PerfHistogram --------
+
+int PerfHistogram::bucketFor(std::int64_t value) noexcept {
+    if (value < 4) {
+        return static_cast<int>(std::max<std::int64_t>(0, value));
+    }
+    const auto v = static_cast<std::uint64_t>(value);
+    const int octave = std::bit_width(v) - 1; // >= 2
+    const int sub = static_cast<int>((v >> (octave - 2)) & 3u);
+    return std::min(4 + (octave - 2) * 4 + sub, kBuckets - 1);
+}
+
+std::int64_t PerfHistogram::bucketLow(int bucket) noexcept {
+    if (bucket < 4) {
+        return bucket;
+    }
+    const int octave = (bucket - 4) / 4 + 2;
+    const int sub = (bucket - 4) % 4;
+    return static_cast<std::int64_t>(4 + sub) << (octave - 2);
+}
+
+std::int64_t PerfHistogram::bucketHigh(int bucket) noexcept {
+    if (bucket < 4) {
+        return bucket + 1;
+    }
+    const int octave = (bucket - 4) / 4 + 2;
+    const int sub = (bucket - 4) % 4;
+    return static_cast<std::int64_t>(5 + sub) << (octave - 2);
+}
+
+PerfHistogram::Snapshot PerfHistogram::snapshot() const noexcept {
+    Snapshot s;
+    for (int b = 0; b < kBuckets; ++b) {
+        s.buckets[b] = buckets_[b].load(std::memory_order_relaxed);
+    }
+    s.count = count_.load(std::memory_order_relaxed);
+    s.sum = sum_.load(std::memory_order_relaxed);
+    s.max = max_.load(std::memory_order_relaxed);
+    return s;
+}
+
+void PerfHistogram::reset() noexcept {
+    for (std::atomic<std::uint64_t>& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+PerfHistogram::Snapshot PerfHistogram::Snapshot::since(const Snapshot& before) const {
+    // The fields are read one by one while writers run, so clamp instead of trusting the order
+    Snapshot s;
+    for (int b = 0; b < kBuckets; ++b) {
+        s.buckets[b] = buckets[b] >= before.buckets[b] ? buckets[b] - before.buckets[b] : 0;
+    }
+    s.count = count >= before.count ? count - before.count : 0;
+    s.sum = std::max<std::int64_t>(0, sum - before.sum);
+    s.max = max;
+    return s;
+}
+
+std::int64_t PerfHistogram::Snapshot::percentile(double q) const {
+    std::uint64_t total = 0;
+    for (const std::uint64_t n : buckets) {
+        total += n;
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    const auto rank = static_cast<std::uint64_t>(std::clamp(q, 0.0, 1.0) * static_cast<double>(total - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (int b = 0; b < kBuckets; ++b) {
+        seen += buckets[b];
+        if (seen >= rank) {
+            return std::min((bucketLow(b) + bucketHigh(b)) / 2, max);
+        }
+    }
+    return max;
+}
+
+std::int64_t PerfHistogram::Snapshot::highest() const {
+    for (int b = kBuckets - 1; b >= 0; --b) {
+        if (buckets[b] > 0) {
+            return std::min(bucketHigh(b) - 1, max);
+        }
+    }
+    return 0;
+}
+
+// -------- PerfCounters --------
+
+static constexpr const char* kHistogramKeys[] = {
+    "audioCallback", "audioBlock", "paint", "compose", "frameInterval", "frameJitter", "latency"};
+static constexpr const char* kCounterKeys[] = {"frames", "levelUpdates", "paints"};
+
+static_assert(std::size(kHistogramKeys) == static_cast<size_t>(PerfCounters::Histogram::Count));
+static_assert(std::size(kCounterKeys) == static_cast<size_t>(PerfCounters::Counter::Count));
+
+void PerfCounters::setEnabled(bool enabled) {
+    if (enabled && !enabled_.load(std::memory_order_relaxed)) {
+        for (PerfHistogram& h : histograms_) {
+            h.reset();
+        }
+        for (std::atomic<std::uint64_t>& c : counters_) {
+            c.store(0, std::memory_order_relaxed);
+        }
+        pendingCaptureNs_.store(0, std::memory_order_relaxed);
+    }
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+PerfCounters::Snapshot PerfCounters::snapshot() {
+    Snapshot s;
+    s.timeNs = nowNs();
+    for (int h = 0; h < static_cast<int>(Histogram::Count); ++h) {
+        s.histograms[h] = histograms_[h].snapshot();
+    }
+    for (int c = 0; c < static_cast<int>(Counter::Count); ++c) {
+        s.counters[c] = counters_[c].load(std::memory_order_relaxed);
+    }
+    return s;
+}
+
+static double perSecond(const PerfCounters::Snapshot& now,
+                        const PerfCounters::Snapshot& before,
+                        PerfCounters::Counter counter) {
+    const double seconds = static_cast<double>(now.timeNs - before.timeNs) / 1e9;
+    const std::uint64_t n = now[counter] >= before[counter] ? now[counter] - before[counter] : 0;
+    return seconds > 0.0 ? static_cast<double>(n) / seconds : 0.0;
+}
+
+static QString ms(std::int64_t ns) { return QString::number(static_cast<double>(ns) / 1e6, 'f', 2); }
+
+QStringList PerfCounters::summaryLines(const Snapshot& now, const Snapshot& before) {
+    const auto line = [&](const char* label, Histogram h) {
+        const PerfHistogram::Snapshot w = now[h].since(before[h]);
+        if (w.count == 0) {
+            return QStringLiteral("%1 -").arg(QLatin1String(label), -9);
+        }
+        return QStringLiteral("%1 p50 %2  p99 %3  max %4 ms")
+            .arg(QLatin1String(label), -9)
+            .arg(ms(w.percentile(0.5)), ms(w.percentile(0.99)), ms(w.highest()));
+    };
+
+    QStringList lines;
+    lines << QStringLiteral("frames %1/s  levels %2/s  paints %3/s")
+                 .arg(perSecond(now, before, Counter::Frames), 0, 'f', 1)
+                 .arg(perSecond(now, before, Counter::LevelUpdates), 0, 'f', 1)
+                 .arg(perSecond(now, before, Counter::Paints), 0, 'f', 1);
+    lines << line("callback", Histogram::AudioCallback);
+    lines << line("block", Histogram::AudioBlock);
+    lines << line("paint", Histogram::Paint);
+    if (now[Histogram::Compose].count > 0) {
+        lines << line("compose", Histogram::Compose);
+    }
+    lines << line("interval", Histogram::FrameInterval);
+    lines << line("jitter", Histogram::FrameJitter);
+    lines << line("latency", Histogram::Latency);
+    return lines;
+}
+
+QByteArray PerfCounters::toJson(const Snapshot& now, const Snapshot& before) {
+    const auto us = [](std::int64_t ns) { return QByteArray::number(static_cast<double>(ns) / 1e3, 'f', 1); };
+
+    const auto systemNow = std::chrono::system_clock::now().time_since_epoch();
+    const auto unixUs = std::chrono::duration_cast<std::chrono::microseconds>(systemNow).count();
+
+    QByteArray out;
+    out.append("{\"t\":");
+    out.append(QByteArray::number(static_cast<qint64>(unixUs)));
+    out.append(",\"perf\":{\"window\":");
+    out.append(QByteArray::number(static_cast<double>(now.timeNs - before.timeNs) / 1e9, 'f', 3));
+
+    for (int c = 0; c < static_cast<int>(Counter::Count); ++c) {
+        out.append(",\"");
+        out.append(kCounterKeys[c]);
+        out.append("\":");
+        out.append(QByteArray::number(static_cast<qulonglong>(
+            now.counters[c] >= before.counters[c] ? now.counters[c] - before.counters[c] : 0)));
+    }
+
+    // Durations in microseconds
+    for (int h = 0; h < static_cast<int>(Histogram::Count); ++h) {
+        const PerfHistogram::Snapshot w = now.histograms[h].since(before.histograms[h]);
+        out.append(",\"");
+        out.append(kHistogramKeys[h]);
+        out.append("\":{\"n\":");
+        out.append(QByteArray::number(static_cast<qulonglong>(w.count)));
+        out.append(",\"mean\":");
+        out.append(us(static_cast<std::int64_t>(w.mean())));
+        out.append(",\"p50\":");
+        out.append(us(w.percentile(0.5)));
+        out.append(",\"p99\":");
+        out.append(us(w.percentile(0.99)));
+        out.append(",\"max\":");
+        out.append(us(w.highest()));
+        out.append('}');
+    }
+    out.append("}}");
+    return out;
+}
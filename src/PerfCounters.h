@@ -0,0 +1,133 @@
+#pragma once
+
+#include <QByteArray>
+#include <QStringList>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Histogram of non-negative values (durations in ns, mostly) with four buckets per
+// power of two, so percentiles are good to about 12%. record() is lock-free and
+// may be called from any number of threads; readers take relaxed snapshots.
+class PerfHistogram final {
+  public:
+    static constexpr int kBuckets = 4 + 36 * 4; // up to 2^38 ns (~4.5 min)
+
+    struct Snapshot final {
+        std::uint64_t count = 0;
+        std::int64_t sum = 0;
+        std::int64_t max = 0; // since the counters were enabled, not per window
+        std::array<std::uint64_t, kBuckets> buckets{};
+
+        // What was recorded after `before` (an earlier snapshot of the same histogram)
+        Snapshot since(const Snapshot& before) const;
+
+        double mean() const { return count > 0 ? static_cast<double>(sum) / static_cast<double>(count) : 0.0; }
+        std::int64_t percentile(double q) const; // middle of the bucket holding the q-quantile
+        std::int64_t highest() const;            // top of the highest non-empty bucket, at most max
+    };
+
+    void record(std::int64_t value) noexcept {
+        value = value < 0 ? 0 : value;
+        buckets_[bucketFor(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+        std::int64_t max = max_.load(std::memory_order_relaxed);
+        while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    Snapshot snapshot() const noexcept;
+    void reset() noexcept;
+
+    static int bucketFor(std::int64_t value) noexcept;
+    static std::int64_t bucketLow(int bucket) noexcept;
+    static std::int64_t bucketHigh(int bucket) noexcept; // exclusive
+
+  private:
+    std::array<std::atomic<std::uint64_t>, kBuckets> buckets_{};
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::int64_t> sum_{0};
+    std::atomic<std::int64_t> max_{0};
+};
+
+// Process-wide timing instrumentation for production triage: audio callback time
+// and block length, paint time, frame interval and jitter, and the end-to-end
+// latency from capture to the painted (or streamed) level.
+//
+// Off by default. While off every probe is a single relaxed load of a flag and
+// nothing reads the clock, so the probes stay compiled into release builds. Shown
+// by the widget's performance overlay, or dumped periodically by LevelOutput.
+class PerfCounters final {
+  public:
+    enum class Histogram {
+        AudioCallback, // ns spent in an audio callback
+        AudioBlock,    // ns of audio an audio callback handled
+        Paint,         // ns spent in one meter paintEvent()
+        Compose,       // ns the render thread spent composing one frame (--render-thread)
+        FrameInterval, // ns between two display (or headless output) frames
+        FrameJitter,   // ns a frame interval was off the nominal one
+        Latency,       // ns from the capture of the newest block to its frame being painted or written
+        Count
+    };
+
+    enum class Counter {
+        Frames,       // display (or headless output) frames
+        LevelUpdates, // frames whose levels moved a needle
+        Paints,       // meter paintEvent() calls
+        Count
+    };
+
+    struct Snapshot final {
+        std::int64_t timeNs = 0;
+        std::array<PerfHistogram::Snapshot, static_cast<int>(Histogram::Count)> histograms{};
+        std::array<std::uint64_t, static_cast<int>(Counter::Count)> counters{};
+
+        const PerfHistogram::Snapshot& operator[](Histogram h) const { return histograms[static_cast<int>(h)]; }
+        std::uint64_t operator[](Counter c) const { return counters[static_cast<int>(c)]; }
+    };
+
+    static bool enabled() noexcept { return enabled_.load(std::memory_order_relaxed); }
+    // Enabling starts from zero
+    static void setEnabled(bool enabled);
+
+    // steady_clock, the same time base as levelClockNowNs()
+    static std::int64_t nowNs() noexcept {
+        const auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+    }
+
+    static void record(Histogram h, std::int64_t value) noexcept {
+        histograms_[static_cast<int>(h)].record(value);
+    }
+    static void increment(Counter c) noexcept {
+        counters_[static_cast<int>(c)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // The levels handed to the meter come from audio captured at captureNs;
+    // the next framePresented() records the latency from there
+    static void markLevels(std::int64_t captureNs) noexcept {
+        pendingCaptureNs_.store(captureNs, std::memory_order_relaxed);
+    }
+    static void framePresented(std::int64_t nowNs) noexcept {
+        const std::int64_t captureNs = pendingCaptureNs_.exchange(0, std::memory_order_relaxed);
+        if (captureNs > 0 && nowNs > captureNs) {
+            record(Histogram::Latency, nowNs - captureNs);
+        }
+    }
+
+    static Snapshot snapshot();
+
+    // Windowed statistics over what happened between `before` and `now`
+    static QStringList summaryLines(const Snapshot& now, const Snapshot& before);
+    // {"t":<unix time in us>,"perf":{...}} without a trailing newline
+    static QByteArray toJson(const Snapshot& now, const Snapshot& before);
+
+  private:
+    static inline std::atomic<bool> enabled_{false};
+    static inline std::array<PerfHistogram, static_cast<int>(Histogram::Count)> histograms_{};
+    static inline std::array<std::atomic<std::uint64_t>, static_cast<int>(Counter::Count)> counters_{};
+    static inline std::atomic<std::int64_t> pendingCaptureNs_{0};
+};
@@ -0,0 +1,149 @@
+#if defined(__linux__) && defined(ANALOGVU_HAS_PIPEWIRE) && (ANALOGVU_HAS_PIPEWIRE == 1)
+
+#include "PipeWireConnection.h"
+
+#include <mutex>
+
+#include <pipewire/pipewire.h>
+
+std::shared_ptr<PipeWireConnection> PipeWireConnection::acquire(QString* errorOut) {
+    static std::mutex mutex;
+    static std::weak_ptr<PipeWireConnection> shared;
+    static std::once_flag initialized;
+
+    std::call_once(initialized, []() { pw_init(nullptr, nullptr); });
+
+    std::lock_guard<std::mutex> guard(mutex);
+
+    if (auto existing = shared.lock()) {
+        return existing;
+    }
+
+    std::shared_ptr<PipeWireConnection> connection(new PipeWireConnection());
+    if (!connection->connect(errorOut)) {
+        return nullptr;
+    }
+
+    shared = connection;
+    return connection;
+}
+
+PipeWireConnection::PipeWireConnection() : coreListener_(std::make_unique<spa_hook>()) {}
+
+PipeWireConnection::~PipeWireConnection() {
+    if (!loop_) {
+        return;
+    }
+
+    // No loop callbacks run once the thread has stopped
+    pw_thread_loop_stop(loop_);
+
+    if (core_) {
+        spa_hook_remove(coreListener_.get());
+        pw_core_disconnect(core_);
+        core_ = nullptr;
+    }
+    if (context_) {
+        pw_context_destroy(context_);
+        context_ = nullptr;
+    }
+    pw_thread_loop_destroy(loop_);
+    loop_ = nullptr;
+}
+
+bool PipeWireConnection::connect(QString* errorOut) {
+    loop_ = pw_thread_loop_new("analog-vu-meter", nullptr);
+    if (!loop_) {
+        if (errorOut) {
+            *errorOut = QStringLiteral("Failed to create PipeWire thread loop");
+        }
+        return false;
+    }
+
+    context_ = pw_context_new(pw_thread_loop_get_loop(loop_), nullptr, 0);
+    if (!context_) {
+        if (errorOut) {
+            *errorOut = QStringLiteral("Failed to create PipeWire context");
+        }
+        return false;
+    }
+
+    if (pw_thread_loop_start(loop_) < 0) {
+        if (errorOut) {
+            *errorOut = QStringLiteral("Failed to start PipeWire thread loop");
+        }
+        return false;
+    }
+
+    Lock lock(*this);
+
+    core_ = pw_context_connect(context_, nullptr, 0);
+    if (!core_) {
+        if (errorOut) {
+            *errorOut = QStringLiteral("Failed to connect to PipeWire");
+        }
+        return false;
+    }
+
+    static const pw_core_events coreEvents = {
+        .version = PW_VERSION_CORE_EVENTS,
+        .done = &PipeWireConnection::on_core_done,
+        .error = &PipeWireConnection::on_core_error,
+    };
+    pw_core_add_listener(core_, coreListener_.get(), &coreEvents, this);
+
+    // The connection is only usable once the server has answered
+    if (!roundtrip()) {
+        if (errorOut) {
+            *errorOut = QStringLiteral("PipeWire connection failed");
+        }
+        return false;
+    }
+
+    if (errorOut) {
+        *errorOut = QString();
+    }
+    return true;
+}
+
+bool PipeWireConnection::roundtrip() {
+    syncDone_ = false;
+    pendingSeq_ = pw_core_sync(core_, PW_ID_CORE, pendingSeq_);
+
+    while (!syncDone_ && !failed_) {
+        pw_thread_loop_wait(loop_);
+    }
+    return !failed_;
+}
+
+void PipeWireConnection::on_core_done(void* userdata, std::uint32_t id, int seq) {
+    auto* self = static_cast<PipeWireConnection*>(userdata);
+    if (id == PW_ID_CORE && seq == self->pendingSeq_) {
+        self->syncDone_ = true;
+        pw_thread_loop_signal(self->loop_, false);
+    }
+}
+
+void PipeWireConnection::on_core_error(void* userdata, std::uint32_t id, int seq, int res, const char* message) {
+    (void)seq;
+    (void)res;
+    (void)message;
+    auto* self = static_cast<PipeWireConnection*>(userdata);
+
+    // Errors on the core itself (e.g. the server went away) end the connection;
+    // errors on other proxies are reported by their own listeners
+    if (id == PW_ID_CORE) {
+        self->failed_ = true;
+        pw_thread_loop_signal(self->loop_, false);
+    }
+}
+
+// -------- Lock --------
+
+PipeWireConnection::Lock::Lock(const PipeWireConnection& connection) : loop_(connection.loop_) {
+    pw_thread_loop_lock(loop_);
+}
+
+PipeWireConnection::Lock::~Lock() { pw_thread_loop_unlock(loop_); }
+
+#endif // __linux__ && ANALOGVU_HAS_PIPEWIRE
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QString>
+
+#include <cstdint>
+#include <memory>
+
+struct pw_thread_loop;
+struct pw_context;
+struct pw_core;
+struct spa_hook;
+
+// One PipeWire connection shared by the whole process (native PipeWire backend).
+//
+// The PipeWire counterpart of PulseConnection: a pw_thread_loop with one context
+// and core proxy, used by every AudioCapture stream. Stream processing itself runs
+// on PipeWire's realtime data thread; this loop only carries control events.
+// acquire() hands out shared references; the connection is torn down when the
+// last one is released.
+class PipeWireConnection final {
+  public:
+    // Returns the live connection, connecting first if there is none; nullptr (and
+    // errorOut) on failure
+    static std::shared_ptr<PipeWireConnection> acquire(QString* errorOut = nullptr);
+
+    ~PipeWireConnection();
+
+    PipeWireConnection(const PipeWireConnection&) = delete;
+    PipeWireConnection& operator=(const PipeWireConnection&) = delete;
+
+    pw_thread_loop* loop() const { return loop_; }
+    pw_core* core() const { return core_; }
+
+    // Waits until the server has handled every request sent so far, so that all
+    // their events have been delivered. Call with the lock held.
+    bool roundtrip();
+
+    // Holds the thread loop lock. Required around every PipeWire call made outside
+    // the loop's own callbacks (those already run with the lock held).
+    class Lock final {
+      public:
+        explicit Lock(const PipeWireConnection& connection);
+        ~Lock();
+
+        Lock(const Lock&) = delete;
+        Lock& operator=(const Lock&) = delete;
+
+      private:
+        pw_thread_loop* loop_;
+    };
+
+  private:
+    PipeWireConnection();
+
+    bool connect(QString* errorOut);
+
+    static void on_core_done(void* userdata, std::uint32_t id, int seq);
+    static void on_core_error(void* userdata, std::uint32_t id, int seq, int res, const char* message);
+
+    pw_thread_loop* loop_ = nullptr;
+    pw_context* context_ = nullptr;
+    pw_core* core_ = nullptr;
+    std::unique_ptr<spa_hook> coreListener_;
+
+    int pendingSeq_ = -1;
+    bool syncDone_ = false;
+    bool failed_ = false;
+};
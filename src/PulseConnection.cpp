@@ -0,0 +1,169 @@
+#if defined(__linux__)
+
+#include "PulseConnection.h"
+#include "RealtimeThread.h"
+
+#include <mutex>
+
+#include <pthread.h>
+#include <pulse/pulseaudio.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+std::shared_ptr<PulseConnection> PulseConnection::acquire(QString* errorOut) {
+    static std::mutex mutex;
+    static std::weak_ptr<PulseConnection> shared;
+
+    std::lock_guard<std::mutex> guard(mutex);
+
+    if (auto existing = shared.lock()) {
+        if (!existing->isFailed()) {
+            return existing;
+        }
+        shared.reset();
+    }
+
+    std::shared_ptr<PulseConnection> connection(new PulseConnection());
+    if (!connection->connect(errorOut)) {
+        return nullptr;
+    }
+
+    shared = connection;
+    return connection;
+}
+
+PulseConnection::~PulseConnection() {
+    if (!mainloop_) {
+        return;
+    }
+
+    if (context_) {
+        pa_threaded_mainloop_lock(mainloop_);
+        pa_context_set_state_callback(context_, nullptr, nullptr);
+        pa_context_disconnect(context_);
+        pa_threaded_mainloop_unlock(mainloop_);
+    }
+
+    pa_threaded_mainloop_stop(mainloop_);
+
+    if (context_) {
+        pa_context_unref(context_);
+        context_ = nullptr;
+    }
+    pa_threaded_mainloop_free(mainloop_);
+    mainloop_ = nullptr;
+}
+
+bool PulseConnection::connect(QString* errorOut) {
+    mainloop_ = pa_threaded_mainloop_new();
+    if (!mainloop_) {
+        if (errorOut) {
+            *errorOut = QStringLiteral("Failed to create PulseAudio mainloop");
+        }
+        return false;
+    }
+
+    context_ = pa_context_new(pa_threaded_mainloop_get_api(mainloop_), "Analog VU Meter");
+    if (!context_) {
+        if (errorOut) {
+            *errorOut = QStringLiteral("Failed to create PulseAudio context");
+        }
+        return false;
+    }
+
+    pa_context_set_state_callback(context_, &PulseConnection::context_state_callback, this);
+
+    const int connectResult = pa_context_connect(context_, nullptr, PA_CONTEXT_NOFLAGS, nullptr);
+    if (connectResult < 0) {
+        if (errorOut) {
+            *errorOut = QStringLiteral("Failed to connect to PulseAudio: %1").arg(pa_strerror(connectResult));
+        }
+        return false;
+    }
+
+    if (pa_threaded_mainloop_start(mainloop_) < 0) {
+        if (errorOut) {
+            *errorOut = QStringLiteral("Failed to start PulseAudio mainloop");
+        }
+        return false;
+    }
+
+    // Wait for the context to settle; the state callback signals every change
+    Lock lock(*this);
+    for (;;) {
+        const pa_context_state_t state = pa_context_get_state(context_);
+        if (state == PA_CONTEXT_READY) {
+            break;
+        }
+        if (!PA_CONTEXT_IS_GOOD(state)) {
+            if (errorOut) {
+                *errorOut = QStringLiteral("PulseAudio context failed: %1")
+                                .arg(pa_strerror(pa_context_errno(context_)));
+            }
+            return false;
+        }
+        pa_threaded_mainloop_wait(mainloop_);
+    }
+
+    if (errorOut) {
+        *errorOut = QString();
+    }
+    return true;
+}
+
+bool PulseConnection::makeRealtime(QString* errorOut) {
+    // A concurrent caller waits here until the first one has the result
+    std::call_once(realtimeTried_, [this] {
+        // Both ids of the loop thread are only known on the thread itself
+        struct LoopThread {
+            pa_threaded_mainloop* mainloop = nullptr;
+            pthread_t thread{};
+            pid_t tid = 0;
+            bool done = false;
+        } loopThread;
+        loopThread.mainloop = mainloop_;
+
+        {
+            Lock lock(*this);
+            pa_mainloop_api_once(
+                pa_threaded_mainloop_get_api(mainloop_),
+                [](pa_mainloop_api*, void* userdata) {
+                    auto* t = static_cast<LoopThread*>(userdata);
+                    t->thread = pthread_self();
+                    t->tid = static_cast<pid_t>(syscall(SYS_gettid));
+                    t->done = true;
+                    pa_threaded_mainloop_signal(t->mainloop, 0);
+                },
+                &loopThread);
+            while (!loopThread.done) {
+                pa_threaded_mainloop_wait(mainloop_);
+            }
+        }
+
+        realtime_ = makeThreadRealtime(loopThread.thread, loopThread.tid, kCaptureRealtimePriority, &realtimeError_);
+    });
+
+    if (errorOut) {
+        *errorOut = realtime_ ? QString() : realtimeError_;
+    }
+    return realtime_;
+}
+
+void PulseConnection::context_state_callback(pa_context* c, void* userdata) {
+    auto* self = static_cast<PulseConnection*>(userdata);
+    const pa_context_state_t state = pa_context_get_state(c);
+    if (state == PA_CONTEXT_FAILED || state == PA_CONTEXT_TERMINATED) {
+        self->failed_.store(true, std::memory_order_release);
+    }
+    pa_threaded_mainloop_signal(self->mainloop_, 0);
+}
+
+// -------- Lock --------
+
+PulseConnection::Lock::Lock(const PulseConnection& connection) : mainloop_(connection.mainloop_) {
+    pa_threaded_mainloop_lock(mainloop_);
+}
+
+PulseConnection::Lock::~Lock() { pa_threaded_mainloop_unlock(mainloop_); }
+
+#endif // __linux__
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QString>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+struct pa_threaded_mainloop;
+struct pa_context;
+
+// One PulseAudio connection shared by the whole process.
+//
+// Owns a pa_threaded_mainloop (a single event thread) and one context on it. Every
+// AudioCapture stream, however many devices are metered, is created on this
+// context and has its callbacks dispatched on that thread. acquire() hands out
+// shared references; the connection is torn down when the last one is released.
+// A connection whose context has failed (e.g. the server restarted) is never handed
+// out again: the next acquire() connects afresh, while existing holders keep the
+// dead one until they let go.
+class PulseConnection final {
+  public:
+    // Returns the live connection, connecting first if there is none or it has
+    // failed. Blocks until
+    // the context is ready; returns nullptr (and fills errorOut) on failure.
+    static std::shared_ptr<PulseConnection> acquire(QString* errorOut = nullptr);
+
+    ~PulseConnection();
+
+    PulseConnection(const PulseConnection&) = delete;
+    PulseConnection& operator=(const PulseConnection&) = delete;
+
+    pa_threaded_mainloop* mainloop() const { return mainloop_; }
+    pa_context* context() const { return context_; }
+
+    // The context has gone to FAILED or TERMINATED; streams on it are dead
+    bool isFailed() const { return failed_.load(std::memory_order_acquire); }
+
+    // Moves the mainloop thread, which runs every capture callback, to realtime
+    // scheduling. Tried once per connection; later calls, and calls made meanwhile
+    // from other threads, return the first result. Any thread except the mainloop's
+    // own; must not be called with the lock held.
+    bool makeRealtime(QString* errorOut = nullptr);
+
+    // Holds the mainloop lock. Required around every libpulse call made outside
+    // the mainloop's own callbacks (those already run with the lock held).
+    class Lock final {
+      public:
+        explicit Lock(const PulseConnection& connection);
+        ~Lock();
+
+        Lock(const Lock&) = delete;
+        Lock& operator=(const Lock&) = delete;
+
+      private:
+        pa_threaded_mainloop* mainloop_;
+    };
+
+  private:
+    PulseConnection() = default;
+
+    bool connect(QString* errorOut);
+
+    static void context_state_callback(pa_context* c, void* userdata);
+
+    pa_threaded_mainloop* mainloop_ = nullptr;
+    pa_context* context_ = nullptr;
+    std::atomic<bool> failed_{false}; // set on the mainloop thread
+
+    // Written once, under realtimeTried_
+    std::once_flag realtimeTried_;
+    bool realtime_ = false;
+    QString realtimeError_;
+};
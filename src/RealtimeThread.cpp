@@ -0,0 +1,87 @@
+#include "RealtimeThread.h"
+
+#if defined(__APPLE__)
+
+#include <mach/mach.h>
+#include <mach/thread_policy.h>
+#include <pthread.h>
+
+bool currentThreadIsRealtime() noexcept {
+    // get_default comes back set when the thread never received a time-constraint policy
+    thread_time_constraint_policy_data_t policy{};
+    mach_msg_type_number_t count = THREAD_TIME_CONSTRAINT_POLICY_COUNT;
+    boolean_t getDefault = FALSE;
+    const kern_return_t result = thread_policy_get(pthread_mach_thread_np(pthread_self()),
+                                                   THREAD_TIME_CONSTRAINT_POLICY,
+                                                   reinterpret_cast<thread_policy_t>(&policy),
+                                                   &count,
+                                                   &getDefault);
+    return result == KERN_SUCCESS && !getDefault;
+}
+
+#else
+
+#include <cstring>
+#include <sched.h>
+#include <sys/resource.h>
+
+#if defined(ANALOGVU_HAS_DBUS) && (ANALOGVU_HAS_DBUS == 1)
+#include <QDBusConnection>
+#include <QDBusMessage>
+
+// rtkit only serves processes whose realtime threads cannot run unbounded
+static constexpr rlim_t kRtkitRtTimeUs = 200'000;
+
+static bool requestRealtimeFromRtkit(pid_t tid, int priority, QString* errorOut) {
+    rlimit limit{};
+    if (getrlimit(RLIMIT_RTTIME, &limit) == 0 && (limit.rlim_max == RLIM_INFINITY || limit.rlim_max > kRtkitRtTimeUs)) {
+        limit.rlim_cur = kRtkitRtTimeUs;
+        limit.rlim_max = kRtkitRtTimeUs;
+        setrlimit(RLIMIT_RTTIME, &limit);
+    }
+
+    QDBusMessage call = QDBusMessage::createMethodCall(QStringLiteral("org.freedesktop.RealtimeKit1"),
+                                                       QStringLiteral("/org/freedesktop/RealtimeKit1"),
+                                                       QStringLiteral("org.freedesktop.RealtimeKit1"),
+                                                       QStringLiteral("MakeThreadRealtime"));
+    call << static_cast<quint64>(tid) << static_cast<quint32>(priority);
+
+    const QDBusMessage reply = QDBusConnection::systemBus().call(call);
+    if (reply.type() == QDBusMessage::ErrorMessage) {
+        if (errorOut) {
+            *errorOut = QStringLiteral("rtkit: %1").arg(reply.errorMessage());
+        }
+        return false;
+    }
+    return true;
+}
+#endif
+
+bool makeThreadRealtime(pthread_t thread, pid_t tid, int priority, QString* errorOut) {
+    sched_param param{};
+    param.sched_priority = priority;
+
+    const int result = pthread_setschedparam(thread, SCHED_FIFO, &param);
+    if (result == 0) {
+        return true;
+    }
+
+#if defined(ANALOGVU_HAS_DBUS) && (ANALOGVU_HAS_DBUS == 1)
+    // Unprivileged desktop sessions normally end up here
+    return requestRealtimeFromRtkit(tid, priority, errorOut);
+#else
+    (void)tid;
+    if (errorOut) {
+        *errorOut = QStringLiteral("SCHED_FIFO: %1").arg(QString::fromLocal8Bit(std::strerror(result)));
+    }
+    return false;
+#endif
+}
+
+bool currentThreadIsRealtime() noexcept {
+    // Asks the kernel: glibc may cache a policy that rtkit changed behind its back
+    const int policy = sched_getscheduler(0) & ~SCHED_RESET_ON_FORK;
+    return policy == SCHED_FIFO || policy == SCHED_RR;
+}
+
+#endif
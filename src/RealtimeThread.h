@@ -0,0 +1,23 @@
+#pragma once
+
+// Whether the calling thread runs under a realtime scheduling policy (no allocation).
+// On macOS this is the HAL's time-constraint policy on its IO threads.
+bool currentThreadIsRealtime() noexcept;
+
+#if !defined(__APPLE__)
+
+#include <QString>
+
+#include <pthread.h>
+#include <sys/types.h>
+
+// Priority used for capture threads; low, so the meter never competes with the
+// audio server or DAW threads that run above it
+static constexpr int kCaptureRealtimePriority = 5;
+
+// Moves a thread to SCHED_FIFO at `priority`. When the process may not do that
+// itself, asks rtkit over D-Bus instead (if built with Qt DBus), which needs the
+// kernel thread id. Call from a normal thread; the D-Bus round trip blocks.
+bool makeThreadRealtime(pthread_t thread, pid_t tid, int priority, QString* errorOut = nullptr);
+
+#endif
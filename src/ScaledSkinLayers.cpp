@@ -0,0 +1,125 @@
+#include "ScaledSkinLayers.h"
+
+#include <cmath>
+
+// -------- SkinMipChain --------
+
+void SkinMipChain::build(const QPixmap& source) {
+    if (!levels_.isEmpty() && sourceKey_ == source.cacheKey()) {
+        return;
+    }
+
+    clear();
+    if (source.isNull()) {
+        return;
+    }
+
+    QImage level = source.toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    level.setDevicePixelRatio(1.0);
+    levels_.push_back(level);
+
+    while (level.width() / 2 >= kMinLevelSize && level.height() / 2 >= kMinLevelSize) {
+        level = level.scaled(level.width() / 2, level.height() / 2, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        levels_.push_back(level);
+    }
+
+    sourceKey_ = source.cacheKey();
+}
+
+void SkinMipChain::clear() {
+    levels_.clear();
+    sourceKey_ = 0;
+}
+
+QImage SkinMipChain::scaled(const QSize& size) const {
+    if (levels_.isEmpty() || size.isEmpty()) {
+        return {};
+    }
+
+    // Smallest level that is still at least as large as the target (the source when upscaling)
+    const QImage* base = &levels_.first();
+    for (const QImage& level : levels_) {
+        if (level.width() < size.width() || level.height() < size.height()) {
+            break;
+        }
+        base = &level;
+    }
+
+    if (base->size() == size) {
+        return *base;
+    }
+    return base->scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation)
+        .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+
+qsizetype SkinMipChain::byteSize() const {
+    qsizetype bytes = 0;
+    // Level 0 shares its pixels with the skin pixmap
+    for (int i = 1; i < levels_.size(); ++i) {
+        bytes += levels_[i].sizeInBytes();
+    }
+    return bytes;
+}
+
+// -------- ScaledSkinLayers --------
+
+void ScaledSkinLayers::clear() {
+    faceMips_.clear();
+    needleMips_.clear();
+    capMips_.clear();
+    face_ = QPixmap();
+    needle_ = QPixmap();
+    cap_ = QPixmap();
+    deviceSize_ = QSize();
+    dpr_ = 0.0;
+}
+
+QSize ScaledSkinLayers::deviceSize(const QSizeF& meterSize, qreal dpr) {
+    return QSize(static_cast<int>(std::lround(meterSize.width() * dpr)),
+                 static_cast<int>(std::lround(meterSize.height() * dpr)));
+}
+
+QPixmap ScaledSkinLayers::layer(const SkinMipChain& mips, const QSize& size, qreal dpr) {
+    QPixmap pixmap = QPixmap::fromImage(mips.scaled(size));
+    pixmap.setDevicePixelRatio(dpr);
+    return pixmap;
+}
+
+void ScaledSkinLayers::build(const VUMeterSkin& skin, const QSizeF& meterSize, qreal dpr) {
+    const QSize size = deviceSize(meterSize, dpr);
+    if (skin.face.isNull() || size.isEmpty() || dpr <= 0.0) {
+        clear();
+        return;
+    }
+
+    faceMips_.build(skin.face);
+    needleMips_.build(skin.needle);
+    capMips_.build(skin.cap);
+
+    face_ = layer(faceMips_, size, dpr);
+    needle_ = layer(needleMips_, size, dpr);
+    cap_ = layer(capMips_, size, dpr);
+    deviceSize_ = size;
+    dpr_ = dpr;
+}
+
+bool ScaledSkinLayers::matches(const QSizeF& meterSize, qreal dpr) const {
+    return !face_.isNull() && qFuzzyCompare(dpr_, dpr) && deviceSize_ == deviceSize(meterSize, dpr);
+}
+
+QRectF ScaledSkinLayers::targetRect(const QRectF& meterRect) const {
+    if (dpr_ <= 0.0) {
+        return meterRect;
+    }
+    const QPointF topLeft(std::round(meterRect.left() * dpr_) / dpr_, std::round(meterRect.top() * dpr_) / dpr_);
+    return QRectF(topLeft, QSizeF(deviceSize_) / dpr_);
+}
+
+qsizetype ScaledSkinLayers::byteSize() const {
+    qsizetype bytes = faceMips_.byteSize() + needleMips_.byteSize() + capMips_.byteSize();
+    for (const QPixmap* pixmap : {&face_, &needle_, &cap_}) {
+        const qsizetype depth = pixmap->depth() / 8;
+        bytes += qsizetype(pixmap->width()) * pixmap->height() * depth;
+    }
+    return bytes;
+}
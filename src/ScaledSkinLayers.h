@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QImage>
+#include <QList>
+#include <QPixmap>
+#include <QPointF>
+#include <QRectF>
+#include <QSize>
+#include <QSizeF>
+
+#include "VUMeterSkin.h"
+
+// Successive 2x reductions of a skin image. Any display size is then one smooth
+// scale of less than 2x away from a level, so large downscales keep their detail
+// instead of aliasing, and a resize never resamples the full-size source again.
+class SkinMipChain final {
+  public:
+    // Levels down to about kMinLevelSize; kept if `source` is the image already built
+    void build(const QPixmap& source);
+    void clear();
+    bool isEmpty() const { return levels_.isEmpty(); }
+
+    // Premultiplied ARGB of exactly `size` device pixels
+    QImage scaled(const QSize& size) const;
+
+    qsizetype byteSize() const;
+
+  private:
+    static constexpr int kMinLevelSize = 16;
+
+    QList<QImage> levels_; // [0] = the source, each next one half the size
+    qint64 sourceKey_ = 0;
+};
+
+// The face, needle and cap of one skin meter at the size and device pixel ratio
+// it is displayed at, so that painting a frame blits them 1:1 (the needle is only
+// rotated). Layers are sized in whole device pixels and drawn at a device-aligned
+// position; a different size or DPR needs a rebuild, see matches().
+class ScaledSkinLayers final {
+  public:
+    void clear();
+    bool isEmpty() const { return face_.isNull(); }
+
+    // Reuses the mip chains when the skin images are the same as last time
+    void build(const VUMeterSkin& skin, const QSizeF& meterSize, qreal dpr);
+
+    bool matches(const QSizeF& meterSize, qreal dpr) const;
+
+    // Widget-space rectangle the layers cover for a meter drawn at meterRect
+    QRectF targetRect(const QRectF& meterRect) const;
+
+    const QPixmap& face() const { return face_; }
+    const QPixmap& needle() const { return needle_; }
+    const QPixmap& cap() const { return cap_; }
+
+    // Pixel memory of the scaled layers and their mip chains
+    qsizetype byteSize() const;
+
+  private:
+    static QSize deviceSize(const QSizeF& meterSize, qreal dpr);
+    static QPixmap layer(const SkinMipChain& mips, const QSize& size, qreal dpr);
+
+    SkinMipChain faceMips_;
+    SkinMipChain needleMips_;
+    SkinMipChain capMips_;
+
+    QPixmap face_;
+    QPixmap needle_;
+    QPixmap cap_;
+    QSize deviceSize_;
+    qreal dpr_ = 0.0;
+};
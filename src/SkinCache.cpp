@@ -0,0 +1,374 @@
+#include "SkinCache.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// -------- File layout --------
+// Header, then the scale tables, then the pixel data; every offset is from the
+// start of the file. Written in host byte order (the cache never leaves the machine),
+// with a marker to reject a file from a host of the other order.
+
+static constexpr char kMagic[4] = {'A', 'V', 'S', 'K'};
+// 2: PPM presets retimed for the quasi-peak detector (the ballistics are stored resolved)
+static constexpr std::uint32_t kFormatVersion = 2;
+static constexpr std::uint32_t kByteOrderMark = 0x01020304u;
+
+// Rows start on a cache line; QImage wants 32-bit aligned scanlines at the least
+static constexpr std::size_t kPixelAlignment = 64;
+
+static constexpr std::uint32_t kFlagStereo = 1u << 0;
+static constexpr std::uint32_t kFlagBallistics = 1u << 1;
+
+namespace {
+
+struct ImageRecord {
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    std::uint32_t bytesPerLine = 0;
+    std::uint32_t reserved = 0;
+    std::uint64_t offset = 0; // 0 = no image
+};
+
+struct MeterRecord {
+    std::int32_t calib[8] = {}; // min/zero/max angle and level, pivot x/y
+    double mobilityNeg = 0.0;
+    double mobilityPos = 0.0;
+    std::uint64_t scaleOffset = 0;
+    std::uint32_t scaleCount = 0; // (level, angle) float pairs
+    std::uint32_t reserved = 0;
+    ImageRecord face;
+    ImageRecord needle;
+    ImageRecord cap;
+};
+
+struct BallisticsRecord {
+    std::uint32_t kind = 0;
+    std::uint32_t detector = 0;
+    float attackTau = 0.0f;
+    float releaseTau = 0.0f;
+    float fallDbPerSecond = 0.0f;
+    float overshootMix = 0.0f;
+    float peakAttackTau = 0.0f;
+    float peakReleaseTau = 0.0f;
+};
+
+struct FileHeader {
+    char magic[4] = {};
+    std::uint32_t version = 0;
+    std::uint32_t byteOrder = 0;
+    std::uint32_t flags = 0;
+    std::uint64_t fileSize = 0;
+    unsigned char contentHash[32] = {};
+    BallisticsRecord ballistics;
+    MeterRecord meters[3]; // single, left, right
+};
+
+static_assert(std::is_trivially_copyable_v<FileHeader>);
+static_assert(sizeof(ImageRecord) == 24);
+static_assert(sizeof(FileHeader) % 8 == 0);
+
+std::size_t alignUp(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Keeps the mapping alive for as long as an image points into it
+struct Mapping final {
+    void* data = nullptr;
+    std::size_t size = 0;
+
+    ~Mapping() {
+        if (data) {
+            ::munmap(data, size);
+        }
+    }
+};
+
+void releaseMapping(void* info) { delete static_cast<std::shared_ptr<Mapping>*>(info); }
+
+void packCalibration(const VUMeterCalibration& c, MeterRecord* r) {
+    const std::int32_t values[8] = {
+        c.minAngle, c.minLevel, c.zeroAngle, c.zeroLevel, c.maxAngle, c.maxLevel, c.pivotX, c.pivotY};
+    std::memcpy(r->calib, values, sizeof(values));
+    r->mobilityNeg = c.mobilityNeg;
+    r->mobilityPos = c.mobilityPos;
+}
+
+VUMeterCalibration unpackCalibration(const MeterRecord& r) {
+    VUMeterCalibration c;
+    c.minAngle = r.calib[0];
+    c.minLevel = r.calib[1];
+    c.zeroAngle = r.calib[2];
+    c.zeroLevel = r.calib[3];
+    c.maxAngle = r.calib[4];
+    c.maxLevel = r.calib[5];
+    c.pivotX = r.calib[6];
+    c.pivotY = r.calib[7];
+    c.mobilityNeg = r.mobilityNeg;
+    c.mobilityPos = r.mobilityPos;
+    return c;
+}
+
+} // namespace
+
+QString CompiledSkinCache::pathFor(const QString& skinId) {
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/skins/") + skinId +
+           QStringLiteral(".avskin");
+}
+
+QByteArray CompiledSkinCache::contentHash(const QString& skinDir) {
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(QByteArrayView(reinterpret_cast<const char*>(&kFormatVersion), sizeof(kFormatVersion)));
+
+    const QDir dir(skinDir);
+    QStringList files;
+    QDirIterator it(skinDir, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        files.push_back(dir.relativeFilePath(it.next()));
+    }
+    files.sort();
+
+    for (const QString& name : files) {
+        QFile f(dir.filePath(name));
+        if (!f.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        const QByteArray nameBytes = name.toUtf8();
+        hash.addData(nameBytes);
+        hash.addData(QByteArrayView("\0", 1));
+        hash.addData(&f);
+    }
+    return hash.result();
+}
+
+bool CompiledSkinCache::read(const QString& path, const QByteArray& hash, CompiledSkin* out) {
+    if (!out || hash.size() > static_cast<qsizetype>(sizeof(FileHeader::contentHash))) {
+        return false;
+    }
+
+    const int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(FileHeader)) {
+        ::close(fd);
+        return false;
+    }
+
+    auto mapping = std::make_shared<Mapping>();
+    mapping->size = static_cast<std::size_t>(info.st_size);
+    void* data = ::mmap(nullptr, mapping->size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // the mapping keeps the file
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    mapping->data = data;
+
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    FileHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+
+    unsigned char expected[sizeof(header.contentHash)] = {};
+    std::memcpy(expected, hash.constData(), static_cast<std::size_t>(hash.size()));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kFormatVersion ||
+        header.byteOrder != kByteOrderMark || header.fileSize != mapping->size ||
+        std::memcmp(header.contentHash, expected, sizeof(expected)) != 0) {
+        return false;
+    }
+
+    // Images shared between meters (mono skins) come back as the same QImage
+    QHash<std::uint64_t, QImage> images;
+    const auto image = [&](const ImageRecord& r, QImage* outImage) {
+        if (r.offset == 0) {
+            *outImage = QImage();
+            return true;
+        }
+        const std::uint64_t needed = static_cast<std::uint64_t>(r.bytesPerLine) * r.height;
+        if (r.offset % kPixelAlignment != 0 || r.bytesPerLine < r.width * 4u || r.offset > mapping->size ||
+            needed > mapping->size - r.offset) {
+            return false;
+        }
+        const auto found = images.constFind(r.offset);
+        if (found != images.constEnd()) {
+            *outImage = *found;
+            return true;
+        }
+        *outImage = QImage(bytes + r.offset,
+                           static_cast<int>(r.width),
+                           static_cast<int>(r.height),
+                           static_cast<qsizetype>(r.bytesPerLine),
+                           QImage::Format_ARGB32_Premultiplied,
+                           releaseMapping,
+                           new std::shared_ptr<Mapping>(mapping));
+        images.insert(r.offset, *outImage);
+        return true;
+    };
+
+    CompiledSkin skin;
+    skin.isStereo = (header.flags & kFlagStereo) != 0;
+    skin.hasBallistics = (header.flags & kFlagBallistics) != 0;
+    skin.ballistics.kind = static_cast<VuBallisticsProfile::Kind>(header.ballistics.kind);
+    skin.ballistics.detector = static_cast<VuBallisticsProfile::Detector>(header.ballistics.detector);
+    skin.ballistics.attackTau = header.ballistics.attackTau;
+    skin.ballistics.releaseTau = header.ballistics.releaseTau;
+    skin.ballistics.fallDbPerSecond = header.ballistics.fallDbPerSecond;
+    skin.ballistics.overshootMix = header.ballistics.overshootMix;
+    skin.ballistics.peakAttackTau = header.ballistics.peakAttackTau;
+    skin.ballistics.peakReleaseTau = header.ballistics.peakReleaseTau;
+
+    CompiledSkin::Meter* meters[3] = {&skin.single, &skin.left, &skin.right};
+    for (int m = 0; m < 3; ++m) {
+        const MeterRecord& r = header.meters[m];
+        CompiledSkin::Meter& meter = *meters[m];
+        meter.calib = unpackCalibration(r);
+
+        const std::uint64_t scaleBytes = static_cast<std::uint64_t>(r.scaleCount) * 2 * sizeof(float);
+        if (r.scaleOffset > mapping->size || scaleBytes > mapping->size - r.scaleOffset) {
+            return false;
+        }
+        meter.scale.resize(static_cast<qsizetype>(r.scaleCount));
+        for (std::uint32_t i = 0; i < r.scaleCount; ++i) {
+            float pair[2];
+            std::memcpy(pair, bytes + r.scaleOffset + i * sizeof(pair), sizeof(pair));
+            meter.scale[static_cast<qsizetype>(i)] = qMakePair(pair[0], pair[1]);
+        }
+
+        if (!image(r.face, &meter.face) || !image(r.needle, &meter.needle) || !image(r.cap, &meter.cap)) {
+            return false;
+        }
+    }
+
+    *out = std::move(skin);
+    return true;
+}
+
+bool CompiledSkinCache::write(const QString& path,
+                              const QByteArray& hash,
+                              const CompiledSkin& skin,
+                              QString* errorOut) {
+    const auto fail = [&](const QString& message) {
+        if (errorOut) {
+            *errorOut = message;
+        }
+        return false;
+    };
+    if (hash.size() > static_cast<qsizetype>(sizeof(FileHeader::contentHash))) {
+        return fail(QStringLiteral("Content hash too long"));
+    }
+
+    FileHeader header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kFormatVersion;
+    header.byteOrder = kByteOrderMark;
+    header.flags = (skin.isStereo ? kFlagStereo : 0u) | (skin.hasBallistics ? kFlagBallistics : 0u);
+    std::memcpy(header.contentHash, hash.constData(), static_cast<std::size_t>(hash.size()));
+
+    header.ballistics.kind = static_cast<std::uint32_t>(skin.ballistics.kind);
+    header.ballistics.detector = static_cast<std::uint32_t>(skin.ballistics.detector);
+    header.ballistics.attackTau = skin.ballistics.attackTau;
+    header.ballistics.releaseTau = skin.ballistics.releaseTau;
+    header.ballistics.fallDbPerSecond = skin.ballistics.fallDbPerSecond;
+    header.ballistics.overshootMix = skin.ballistics.overshootMix;
+    header.ballistics.peakAttackTau = skin.ballistics.peakAttackTau;
+    header.ballistics.peakReleaseTau = skin.ballistics.peakReleaseTau;
+
+    // --- Lay out scale tables, then pixels; an image shared by meters is stored once ---
+    const CompiledSkin::Meter* meters[3] = {&skin.single, &skin.left, &skin.right};
+    std::size_t offset = sizeof(FileHeader);
+    for (int m = 0; m < 3; ++m) {
+        header.meters[m].scaleOffset = offset;
+        header.meters[m].scaleCount = static_cast<std::uint32_t>(meters[m]->scale.size());
+        offset += static_cast<std::size_t>(meters[m]->scale.size()) * 2 * sizeof(float);
+    }
+
+    struct Pixels {
+        QImage image;
+        std::uint64_t offset = 0;
+    };
+    std::vector<Pixels> pixels;
+    QHash<qint64, ImageRecord> placed;
+    const auto place = [&](const QImage& source, ImageRecord* r) {
+        if (source.isNull()) {
+            return;
+        }
+        const auto found = placed.constFind(source.cacheKey());
+        if (found != placed.constEnd()) {
+            *r = *found;
+            return;
+        }
+        const QImage image = source.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        offset = alignUp(offset, kPixelAlignment);
+        r->width = static_cast<std::uint32_t>(image.width());
+        r->height = static_cast<std::uint32_t>(image.height());
+        r->bytesPerLine = static_cast<std::uint32_t>(image.bytesPerLine());
+        r->offset = offset;
+        pixels.push_back({image, offset});
+        placed.insert(source.cacheKey(), *r);
+        offset += static_cast<std::size_t>(image.sizeInBytes());
+    };
+    for (int m = 0; m < 3; ++m) {
+        packCalibration(meters[m]->calib, &header.meters[m]);
+        place(meters[m]->face, &header.meters[m].face);
+        place(meters[m]->needle, &header.meters[m].needle);
+        place(meters[m]->cap, &header.meters[m].cap);
+    }
+    header.fileSize = offset;
+
+    // --- Write ---
+    if (!QDir().mkpath(QFileInfo(path).absolutePath())) {
+        return fail(QStringLiteral("Cannot create %1").arg(QFileInfo(path).absolutePath()));
+    }
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return fail(QStringLiteral("Cannot write %1: %2").arg(path, file.errorString()));
+    }
+
+    std::size_t written = 0;
+    const auto put = [&](const void* data, std::size_t size) {
+        file.write(static_cast<const char*>(data), static_cast<qint64>(size));
+        written += size;
+    };
+    const auto padTo = [&](std::size_t target) {
+        static constexpr char kZeros[kPixelAlignment] = {};
+        put(kZeros, target - written);
+    };
+
+    put(&header, sizeof(header));
+    for (const CompiledSkin::Meter* meter : meters) {
+        for (const auto& entry : meter->scale) {
+            const float pair[2] = {entry.first, entry.second};
+            put(pair, sizeof(pair));
+        }
+    }
+    for (const Pixels& p : pixels) {
+        padTo(static_cast<std::size_t>(p.offset));
+        put(p.image.constBits(), static_cast<std::size_t>(p.image.sizeInBytes()));
+    }
+
+    if (!file.commit()) {
+        return fail(QStringLiteral("Cannot write %1: %2").arg(path, file.errorString()));
+    }
+    if (errorOut) {
+        *errorOut = QString();
+    }
+    return true;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+#include <QString>
+
+#include "VUBallistics.h"
+#include "VUMeterScale.h"
+#include "VUMeterSkin.h"
+
+// Everything a skin needs at runtime, already parsed and decoded
+struct CompiledSkin final {
+    struct Meter final {
+        VUMeterCalibration calib{};
+        VUMeterScaleTable scale;
+        QImage face;
+        QImage needle;
+        QImage cap;
+    };
+
+    bool isStereo = false;
+    bool hasBallistics = false;
+    VuBallisticsProfile ballistics;
+
+    Meter single;
+    Meter left;
+    Meter right;
+};
+
+// Compiled skin cache: one file per skin holding the calibration, the scale
+// tables and the images as premultiplied ARGB32 pixels, ready to be mapped.
+//
+// Loading a compiled skin is an mmap and a few bounds checks instead of JSON
+// parsing and PNG inflate; the QImages it returns are read-only views of the
+// mapping, so every instance on the machine shares the same page-cache pages. A
+// file is only used when its content hash matches the skin directory it was
+// built from.
+class CompiledSkinCache final {
+  public:
+    // <cache location>/skins/<skinId>.avskin
+    static QString pathFor(const QString& skinId);
+
+    // Hash over the names and bytes of every file in the skin directory, and the format version
+    static QByteArray contentHash(const QString& skinDir);
+
+    // False if the file is missing, damaged, of another format version or built from other content.
+    // The mapping lives as long as any of the returned images.
+    static bool read(const QString& path, const QByteArray& hash, CompiledSkin* out);
+
+    // Atomic (written aside, then renamed), so another instance never maps half a file
+    static bool write(const QString& path,
+                      const QByteArray& hash,
+                      const CompiledSkin& skin,
+                      QString* errorOut = nullptr);
+};
@@ -6,13 +6,20 @@
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QImage>
 #include <QMap>
-#include <QSettings>
+#include <QSet>
 #include <QStandardPaths>
-#include <QTemporaryDir>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #if defined(ANALOGVU_HAS_LIBZIP) && (ANALOGVU_HAS_LIBZIP == 1)
 #include <zip.h>
@@ -36,59 +43,65 @@ QString sanitizedDirName(const QString& in) {
     return out;
 }
 
-QDir findAimpRootDir(const QDir& extractedRoot) {
-    const QFileInfoList entries = extractedRoot.entryInfoList(QDir::NoDotAndDotDot | QDir::AllEntries);
-    if (entries.size() == 1 && entries[0].isDir()) {
-        return QDir(entries[0].absoluteFilePath());
-    }
-    return extractedRoot;
-}
+// Just enough INI for skin.ini: [groups], key=value and ;/# comments. Group and key
+// names are case-insensitive, values may be quoted.
+class IniDocument {
+  public:
+    explicit IniDocument(const QByteArray& data) {
+        QString group;
+        QString text = QString::fromUtf8(data);
+        if (text.startsWith(QChar(0xFEFF)))
+            text.remove(0, 1);
+
+        const QStringList lines = text.split(QLatin1Char('\n'));
+        for (QString line : lines) {
+            line = line.trimmed();
+            if (line.isEmpty() || line.startsWith(QLatin1Char(';')) || line.startsWith(QLatin1Char('#')))
+                continue;
+            if (line.startsWith(QLatin1Char('[')) && line.endsWith(QLatin1Char(']'))) {
+                group = line.mid(1, line.size() - 2).trimmed().toLower();
+                continue;
+            }
+            const qsizetype eq = line.indexOf(QLatin1Char('='));
+            if (eq <= 0)
+                continue;
 
-QMap<QString, QString> lowerNameToActualFile(const QDir& dir) {
-    QMap<QString, QString> map;
-    const QFileInfoList files = dir.entryInfoList(QDir::Files);
-    for (const QFileInfo& fi : files) {
-        map.insert(fi.fileName().toLower(), fi.fileName());
+            QString value = line.mid(eq + 1).trimmed();
+            if (value.size() >= 2 && value.startsWith(QLatin1Char('"')) && value.endsWith(QLatin1Char('"')))
+                value = value.mid(1, value.size() - 2);
+            values_.insert(group + QLatin1Char('/') + line.left(eq).trimmed().toLower(), value);
+        }
     }
-    return map;
-}
-
-#if defined(ANALOGVU_HAS_LIBZIP) && (ANALOGVU_HAS_LIBZIP == 1)
-bool isSafeZipEntryPath(const QString& entryName) {
-    if (entryName.isEmpty())
-        return false;
-    if (entryName.startsWith('/') || entryName.startsWith('\\'))
-        return false;
 
-    const QString cleaned = QDir::cleanPath(entryName);
-    if (cleaned == QStringLiteral(".") || cleaned.isEmpty())
-        return false;
-    if (cleaned.startsWith(QStringLiteral("../")) || cleaned == QStringLiteral(".."))
-        return false;
-    if (cleaned.contains(QStringLiteral("/../")))
-        return false;
+    // Null if the key is not there
+    QString value(const QString& group, const QString& key) const {
+        return values_.value(group.toLower() + QLatin1Char('/') + key.toLower());
+    }
 
-    // Avoid Windows drive paths like C:\...
-    if (cleaned.size() >= 2 && cleaned[1] == ':')
-        return false;
+  private:
+    QHash<QString, QString> values_;
+};
 
-    return true;
-}
+#if defined(ANALOGVU_HAS_LIBZIP) && (ANALOGVU_HAS_LIBZIP == 1)
+// Larger entries are not skin assets (or are a ZIP bomb)
+constexpr zip_uint64_t kMaxEntryBytes = 64ull * 1024 * 1024;
 
-class ZipReader {
+// Read-only archive; entries are read straight into memory, nothing touches the disk
+class ZipArchive {
   public:
-    static bool extractAll(const QString& zipFilePath, const QDir& destDir, QString* errorOut) {
-        if (!destDir.exists()) {
-            if (!QDir().mkpath(destDir.absolutePath())) {
-                if (errorOut)
-                    *errorOut = QStringLiteral("Failed to create destination directory: %1").arg(destDir.absolutePath());
-                return false;
-            }
-        }
+    ZipArchive() = default;
+    ~ZipArchive() {
+        if (za_)
+            zip_discard(za_);
+    }
+
+    ZipArchive(const ZipArchive&) = delete;
+    ZipArchive& operator=(const ZipArchive&) = delete;
 
+    bool open(const QString& zipFilePath, QString* errorOut) {
         int err = 0;
-        zip_t* za = zip_open(zipFilePath.toUtf8().constData(), ZIP_RDONLY, &err);
-        if (!za) {
+        za_ = zip_open(QFile::encodeName(zipFilePath).constData(), ZIP_RDONLY, &err);
+        if (!za_) {
             if (errorOut) {
                 zip_error_t ze;
                 zip_error_init_with_code(&ze, err);
@@ -98,110 +111,119 @@ class ZipReader {
             }
             return false;
         }
+        return true;
+    }
 
-        const zip_int64_t n = zip_get_num_entries(za, 0);
-        for (zip_uint64_t i = 0; i < static_cast<zip_uint64_t>(n); ++i) {
-            zip_stat_t st;
-            if (zip_stat_index(za, i, 0, &st) != 0)
-                continue;
-
-            const QString entryName = QString::fromUtf8(st.name ? st.name : "");
-            if (entryName.isEmpty())
-                continue;
-
-            if (!isSafeZipEntryPath(entryName)) {
-                if (errorOut)
-                    *errorOut = QStringLiteral("Unsafe ZIP entry path: %1").arg(entryName);
-                zip_close(za);
-                return false;
-            }
-
-            const QString outPath = destDir.filePath(entryName);
-            if (entryName.endsWith('/')) {
-                if (!QDir().mkpath(outPath)) {
-                    if (errorOut)
-                        *errorOut = QStringLiteral("Failed to create directory: %1").arg(outPath);
-                    zip_close(za);
-                    return false;
-                }
-                continue;
-            }
-
-            const QFileInfo outFi(outPath);
-            QDir parentDir = outFi.dir();
-            if (!parentDir.exists()) {
-                if (!QDir().mkpath(parentDir.absolutePath())) {
-                    if (errorOut)
-                        *errorOut = QStringLiteral("Failed to create directory: %1").arg(parentDir.absolutePath());
-                    zip_close(za);
-                    return false;
-                }
-            }
-
-            zip_file_t* zf = zip_fopen_index(za, i, 0);
-            if (!zf) {
-                if (errorOut)
-                    *errorOut = QStringLiteral("Failed to open ZIP entry: %1").arg(entryName);
-                zip_close(za);
-                return false;
-            }
-
-            QFile out(outPath);
-            if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-                zip_fclose(zf);
-                if (errorOut)
-                    *errorOut = QStringLiteral("Failed to write file: %1").arg(outPath);
-                zip_close(za);
-                return false;
-            }
-
-            char buf[64 * 1024];
-            while (true) {
-                const zip_int64_t bytes = zip_fread(zf, buf, sizeof(buf));
-                if (bytes < 0) {
-                    zip_fclose(zf);
-                    if (errorOut)
-                        *errorOut = QStringLiteral("Failed reading ZIP entry: %1").arg(entryName);
-                    zip_close(za);
-                    return false;
-                }
-                if (bytes == 0)
-                    break;
-
-                if (out.write(buf, bytes) != bytes) {
-                    zip_fclose(zf);
-                    if (errorOut)
-                        *errorOut = QStringLiteral("Short write: %1").arg(outPath);
-                    zip_close(za);
-                    return false;
-                }
-            }
+    // Entry names by index; directories end in '/'
+    QStringList names() const {
+        QStringList out;
+        const zip_int64_t n = zip_get_num_entries(za_, 0);
+        for (zip_int64_t i = 0; i < n; ++i) {
+            const char* name = zip_get_name(za_, static_cast<zip_uint64_t>(i), 0);
+            out.push_back(QString::fromUtf8(name ? name : ""));
+        }
+        return out;
+    }
 
-            zip_fclose(zf);
+    bool read(zip_uint64_t index, QByteArray* out, QString* errorOut) const {
+        const auto fail = [&](const QString& message) {
+            if (errorOut)
+                *errorOut = message;
+            return false;
+        };
+        const char* name = zip_get_name(za_, index, 0);
+        const QString entryName = QString::fromUtf8(name ? name : "");
+
+        zip_stat_t st;
+        zip_stat_init(&st);
+        if (zip_stat_index(za_, index, 0, &st) != 0 || !(st.valid & ZIP_STAT_SIZE))
+            return fail(QStringLiteral("Failed to stat ZIP entry: %1").arg(entryName));
+        if (st.size > kMaxEntryBytes)
+            return fail(QStringLiteral("ZIP entry too large: %1").arg(entryName));
+
+        zip_file_t* zf = zip_fopen_index(za_, index, 0);
+        if (!zf)
+            return fail(QStringLiteral("Failed to open ZIP entry: %1").arg(entryName));
+
+        out->resize(static_cast<qsizetype>(st.size));
+        zip_uint64_t done = 0;
+        while (done < st.size) {
+            const zip_int64_t bytes = zip_fread(zf, out->data() + done, st.size - done);
+            if (bytes <= 0)
+                break;
+            done += static_cast<zip_uint64_t>(bytes);
         }
+        zip_fclose(zf);
 
-        zip_close(za);
+        if (done != st.size)
+            return fail(QStringLiteral("Failed reading ZIP entry: %1").arg(entryName));
         return true;
     }
+
+  private:
+    zip_t* za_ = nullptr;
 };
+
+// Lower-case file name -> entry index, for the files of the AIMP skin's own directory:
+// the archive root, or its only top-level directory (macOS resource forks aside)
+QMap<QString, zip_uint64_t> aimpRootEntries(const QStringList& names) {
+    QSet<QString> topLevel;
+    for (const QString& name : names) {
+        if (name.isEmpty() || name.startsWith(QStringLiteral("__MACOSX/")))
+            continue;
+        QString top = name.section(QLatin1Char('/'), 0, 0);
+        if (name.contains(QLatin1Char('/')))
+            top += QLatin1Char('/');
+        topLevel.insert(top);
+    }
+    QString prefix;
+    if (topLevel.size() == 1 && topLevel.begin()->endsWith(QLatin1Char('/')))
+        prefix = *topLevel.begin();
+
+    QMap<QString, zip_uint64_t> map;
+    for (qsizetype i = 0; i < names.size(); ++i) {
+        const QString& name = names[i];
+        if (!name.startsWith(prefix))
+            continue;
+        const QString rest = name.mid(prefix.size());
+        if (rest.isEmpty() || rest.contains(QLatin1Char('/')))
+            continue;
+        map.insert(rest.toLower(), static_cast<zip_uint64_t>(i));
+    }
+    return map;
+}
 #endif
 
-bool tryCopyFile(const QString& srcPath, const QString& dstPath, QString* errorOut) {
-    if (QFileInfo(dstPath).exists()) {
-        QFile::remove(dstPath);
+// Unique skin directory names, also when several imports run at once: the directory
+// is created while the name is reserved
+QString reserveSkinDir(const QDir& skinsRoot, const QString& baseName) {
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    QString finalDirName = baseName;
+    for (int i = 2; skinsRoot.exists(finalDirName); ++i) {
+        finalDirName = QStringLiteral("%1-%2").arg(baseName).arg(i);
     }
-    if (!QFile::copy(srcPath, dstPath)) {
+    if (!skinsRoot.mkpath(finalDirName))
+        return QString();
+    return finalDirName;
+}
+
+bool writeFile(const QString& path, const QByteArray& data, QString* errorOut) {
+    QFile out(path);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate) || out.write(data) != data.size()) {
         if (errorOut)
-            *errorOut = QStringLiteral("Failed to copy %1 -> %2").arg(srcPath, dstPath);
+            *errorOut = QStringLiteral("Failed to write file: %1").arg(path);
         return false;
     }
     return true;
 }
 
-int readIntAny(const QSettings& ini, const QStringList& keys, int fallback, QStringList* warnings) {
+int readIntAny(const IniDocument& ini, const QString& group, const QStringList& keys, int fallback,
+               QStringList* warnings) {
     for (const QString& k : keys) {
-        const QVariant v = ini.value(k);
-        if (!v.isValid())
+        const QString v = ini.value(group, k);
+        if (v.isNull())
             continue;
         bool ok = false;
         const int out = v.toInt(&ok);
@@ -213,10 +235,11 @@ int readIntAny(const QSettings& ini, const QStringList& keys, int fallback, QStr
     return fallback;
 }
 
-qreal readRealAny(const QSettings& ini, const QStringList& keys, qreal fallback, QStringList* warnings) {
+qreal readRealAny(const IniDocument& ini, const QString& group, const QStringList& keys, qreal fallback,
+                  QStringList* warnings) {
     for (const QString& k : keys) {
-        const QVariant v = ini.value(k);
-        if (!v.isValid())
+        const QString v = ini.value(group, k);
+        if (v.isNull())
             continue;
         bool ok = false;
         const qreal out = v.toDouble(&ok);
@@ -243,26 +266,25 @@ VUMeterCalibration defaultCalibration() {
     return c;
 }
 
-VUMeterCalibration parseCalibrationGroup(QSettings& ini, const QString& groupName, QStringList* warnings) {
+VUMeterCalibration parseCalibrationGroup(const IniDocument& ini, const QString& groupName, QStringList* warnings) {
     VUMeterCalibration c = defaultCalibration();
 
-    ini.beginGroup(groupName);
-    c.minAngle = readIntAny(ini, {"MinAngle"}, c.minAngle, warnings);
-    c.minLevel = readIntAny(ini, {"MinLevel"}, c.minLevel, warnings);
-    c.zeroAngle = readIntAny(ini, {"ZeroAngle"}, c.zeroAngle, warnings);
-    c.zeroLevel = readIntAny(ini, {"ZeroLevel"}, c.zeroLevel, warnings);
-    c.maxAngle = readIntAny(ini, {"MaxAngle"}, c.maxAngle, warnings);
-    c.maxLevel = readIntAny(ini, {"MaxLevel"}, c.maxLevel, warnings);
-    c.pivotX = readIntAny(ini, {"PivotPointX"}, c.pivotX, warnings);
-    c.pivotY = readIntAny(ini, {"PivotPointY"}, c.pivotY, warnings);
-    c.mobilityNeg = readRealAny(ini, {"MobilityNegative"}, c.mobilityNeg, warnings);
-    c.mobilityPos = readRealAny(ini, {"MobilityPositive"}, c.mobilityPos, warnings);
-    ini.endGroup();
+    c.minAngle = readIntAny(ini, groupName, {"MinAngle"}, c.minAngle, warnings);
+    c.minLevel = readIntAny(ini, groupName, {"MinLevel"}, c.minLevel, warnings);
+    c.zeroAngle = readIntAny(ini, groupName, {"ZeroAngle"}, c.zeroAngle, warnings);
+    c.zeroLevel = readIntAny(ini, groupName, {"ZeroLevel"}, c.zeroLevel, warnings);
+    c.maxAngle = readIntAny(ini, groupName, {"MaxAngle"}, c.maxAngle, warnings);
+    c.maxLevel = readIntAny(ini, groupName, {"MaxLevel"}, c.maxLevel, warnings);
+    c.pivotX = readIntAny(ini, groupName, {"PivotPointX"}, c.pivotX, warnings);
+    c.pivotY = readIntAny(ini, groupName, {"PivotPointY"}, c.pivotY, warnings);
+    c.mobilityNeg = readRealAny(ini, groupName, {"MobilityNegative"}, c.mobilityNeg, warnings);
+    c.mobilityPos = readRealAny(ini, groupName, {"MobilityPositive"}, c.mobilityPos, warnings);
 
     return c;
 }
 
-VUMeterScaleTable buildScaleTableFromIni(QSettings& ini, const QString& groupName, const VUMeterCalibration& calib) {
+VUMeterScaleTable buildScaleTableFromIni(const IniDocument& ini, const QString& groupName,
+                                         const VUMeterCalibration& calib) {
     (void)ini;
     (void)groupName;
     return {{static_cast<float>(calib.minLevel), static_cast<float>(calib.minAngle)},
@@ -321,46 +343,35 @@ SkinImporter::ImportResult SkinImporter::importAimpZip(const QString& zipFilePat
         return result;
     }
 
-    QTemporaryDir tmp;
-    if (!tmp.isValid()) {
-        result.error = QStringLiteral("Failed to create temp directory");
-        return result;
-    }
-
 #if !defined(ANALOGVU_HAS_LIBZIP) || (ANALOGVU_HAS_LIBZIP == 0)
     result.error = QStringLiteral("Skin import is disabled because libzip was not found at build time.");
     return result;
 #else
-    QString zipError;
-    if (!ZipReader::extractAll(zipFilePath, QDir(tmp.path()), &zipError)) {
-        result.error = zipError;
+    ZipArchive zip;
+    if (!zip.open(zipFilePath, &result.error))
         return result;
-    }
-#endif
 
-    const QDir extractedRoot(tmp.path());
-    const QDir aimpRoot = findAimpRootDir(extractedRoot);
-    const QMap<QString, QString> fileMap = lowerNameToActualFile(aimpRoot);
+    const QMap<QString, zip_uint64_t> entries = aimpRootEntries(zip.names());
 
-    auto requireFile = [&](const QString& nameLower, QString* actualOut) -> bool {
-        const auto it = fileMap.constFind(nameLower);
-        if (it == fileMap.constEnd())
+    auto requireFile = [&](const QString& nameLower, zip_uint64_t* indexOut) -> bool {
+        const auto it = entries.constFind(nameLower);
+        if (it == entries.constEnd())
             return false;
-        if (actualOut)
-            *actualOut = it.value();
+        if (indexOut)
+            *indexOut = it.value();
         return true;
     };
 
-    QString iniActual;
-    if (!requireFile(QStringLiteral("skin.ini"), &iniActual)) {
+    zip_uint64_t iniIndex = 0;
+    if (!requireFile(QStringLiteral("skin.ini"), &iniIndex)) {
         result.error = QStringLiteral("skin.ini not found in ZIP");
         return result;
     }
 
     bool isStereo = false;
-    QString s0, s1, s2;
-    QString l0, l1, l2;
-    QString r0, r1, r2;
+    zip_uint64_t s0 = 0, s1 = 0, s2 = 0;
+    zip_uint64_t l0 = 0, l1 = 0, l2 = 0;
+    zip_uint64_t r0 = 0, r1 = 0, r2 = 0;
 
     const bool hasSingle = requireFile(QStringLiteral("0.png"), &s0) &&
                            requireFile(QStringLiteral("1.png"), &s1) &&
@@ -382,8 +393,38 @@ SkinImporter::ImportResult SkinImporter::importAimpZip(const QString& zipFilePat
         return result;
     }
 
-    const QString iniPath = aimpRoot.filePath(iniActual);
-    QSettings ini(iniPath, QSettings::IniFormat);
+    QByteArray iniData;
+    if (!zip.read(iniIndex, &iniData, &result.error))
+        return result;
+    const IniDocument ini(iniData);
+
+    // --- Read and check the images; they are stored as they came, without re-encoding ---
+    struct Asset {
+        zip_uint64_t index;
+        QString path; // relative to the skin directory
+        QByteArray data;
+    };
+    std::vector<Asset> assets;
+    if (isStereo) {
+        assets = {{l0, QStringLiteral("stereo/left/face.png"), {}},
+                  {l1, QStringLiteral("stereo/left/needle.png"), {}},
+                  {l2, QStringLiteral("stereo/left/cap.png"), {}},
+                  {r0, QStringLiteral("stereo/right/face.png"), {}},
+                  {r1, QStringLiteral("stereo/right/needle.png"), {}},
+                  {r2, QStringLiteral("stereo/right/cap.png"), {}}};
+    } else {
+        assets = {{s0, QStringLiteral("single/face.png"), {}},
+                  {s1, QStringLiteral("single/needle.png"), {}},
+                  {s2, QStringLiteral("single/cap.png"), {}}};
+    }
+    for (Asset& asset : assets) {
+        if (!zip.read(asset.index, &asset.data, &result.error))
+            return result;
+        if (QImage::fromData(asset.data).isNull()) {
+            result.error = QStringLiteral("Not a valid image in ZIP: %1").arg(zip.names().value(static_cast<qsizetype>(asset.index)));
+            return result;
+        }
+    }
 
     VUMeterCalibration singleCalib;
     VUMeterCalibration leftCalib;
@@ -413,6 +454,7 @@ SkinImporter::ImportResult SkinImporter::importAimpZip(const QString& zipFilePat
         rightTable = singleTable;
     }
 
+    // --- Write the normalized skin: skin.json and the images, nothing else ---
     const QString baseName = sanitizedDirName(zipInfo.completeBaseName());
     const QString skinsRootPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/skins");
 
@@ -424,82 +466,47 @@ SkinImporter::ImportResult SkinImporter::importAimpZip(const QString& zipFilePat
         }
     }
 
-    QString finalDirName = baseName;
-    for (int i = 2; skinsRoot.exists(finalDirName); ++i) {
-        finalDirName = QStringLiteral("%1-%2").arg(baseName).arg(i);
+    const QString finalDirName = reserveSkinDir(skinsRoot, baseName);
+    if (finalDirName.isEmpty()) {
+        result.error = QStringLiteral("Failed to create skin directory for %1").arg(baseName);
+        return result;
     }
-
     const QString skinDirPath = skinsRoot.filePath(finalDirName);
     QDir skinDir(skinDirPath);
-    if (!QDir().mkpath(skinDirPath)) {
-        result.error = QStringLiteral("Failed to create skin directory: %1").arg(skinDirPath);
-        return result;
-    }
-
-    const QString singleDir = skinDir.filePath(QStringLiteral("single"));
-    const QString stereoLeftDir = skinDir.filePath(QStringLiteral("stereo/left"));
-    const QString stereoRightDir = skinDir.filePath(QStringLiteral("stereo/right"));
 
-    if (!QDir().mkpath(singleDir) || !QDir().mkpath(stereoLeftDir) || !QDir().mkpath(stereoRightDir)) {
-        result.error = QStringLiteral("Failed to create skin subdirectories");
+    // A failed import leaves nothing behind
+    const auto abandon = [&](const QString& error) {
+        skinDir.removeRecursively();
+        result.error = error;
         return result;
-    }
-
-    QString copyError;
-
-    auto copySingleFrom = [&](const QString& faceName, const QString& needleName, const QString& capName) -> bool {
-        if (!tryCopyFile(aimpRoot.filePath(faceName), QDir(singleDir).filePath(QStringLiteral("face.png")), &copyError))
-            return false;
-        if (!tryCopyFile(aimpRoot.filePath(needleName), QDir(singleDir).filePath(QStringLiteral("needle.png")), &copyError))
-            return false;
-        if (!tryCopyFile(aimpRoot.filePath(capName), QDir(singleDir).filePath(QStringLiteral("cap.png")), &copyError))
-            return false;
-        return true;
     };
 
-    auto copyStereoSide = [&](const QString& faceName, const QString& needleName, const QString& capName, const QString& sideDir) -> bool {
-        if (!tryCopyFile(aimpRoot.filePath(faceName), QDir(sideDir).filePath(QStringLiteral("face.png")), &copyError))
-            return false;
-        if (!tryCopyFile(aimpRoot.filePath(needleName), QDir(sideDir).filePath(QStringLiteral("needle.png")), &copyError))
-            return false;
-        if (!tryCopyFile(aimpRoot.filePath(capName), QDir(sideDir).filePath(QStringLiteral("cap.png")), &copyError))
-            return false;
-        return true;
-    };
-
-    if (isStereo) {
-        if (!copyStereoSide(l0, l1, l2, stereoLeftDir) || !copyStereoSide(r0, r1, r2, stereoRightDir)) {
-            result.error = copyError;
-            return result;
-        }
-        if (!copySingleFrom(l0, l1, l2)) {
-            result.error = copyError;
-            return result;
-        }
-    } else {
-        if (!copySingleFrom(s0, s1, s2)) {
-            result.error = copyError;
-            return result;
-        }
-        if (!copyStereoSide(s0, s1, s2, stereoLeftDir) || !copyStereoSide(s0, s1, s2, stereoRightDir)) {
-            result.error = copyError;
-            return result;
-        }
+    QString writeError;
+    for (const Asset& asset : assets) {
+        const QString path = skinDir.filePath(asset.path);
+        if (!QDir().mkpath(QFileInfo(path).absolutePath()) || !writeFile(path, asset.data, &writeError))
+            return abandon(writeError.isEmpty() ? QStringLiteral("Failed to create skin subdirectories") : writeError);
     }
 
-    QJsonObject meters;
+    // Mono skins point every meter at the one set of images; stereo skins use the left
+    // meter as their single meter
+    const QString singleBase = isStereo ? QStringLiteral("stereo/left/") : QStringLiteral("single/");
+    const QString leftBase = isStereo ? QStringLiteral("stereo/left/") : QStringLiteral("single/");
+    const QString rightBase = isStereo ? QStringLiteral("stereo/right/") : QStringLiteral("single/");
+    const auto meterAt = [](const QString& base, const VUMeterCalibration& calib, const VUMeterScaleTable& table) {
+        return meterJson(base + QStringLiteral("face.png"),
+                         base + QStringLiteral("needle.png"),
+                         base + QStringLiteral("cap.png"),
+                         calib,
+                         table);
+    };
 
-    meters.insert(QStringLiteral("single"),
-                  meterJson(QStringLiteral("single/face.png"), QStringLiteral("single/needle.png"), QStringLiteral("single/cap.png"),
-                           singleCalib, singleTable));
+    QJsonObject meters;
+    meters.insert(QStringLiteral("single"), meterAt(singleBase, singleCalib, singleTable));
 
     QJsonObject stereo;
-    stereo.insert(QStringLiteral("left"),
-                  meterJson(QStringLiteral("stereo/left/face.png"), QStringLiteral("stereo/left/needle.png"), QStringLiteral("stereo/left/cap.png"),
-                           leftCalib, leftTable));
-    stereo.insert(QStringLiteral("right"),
-                  meterJson(QStringLiteral("stereo/right/face.png"), QStringLiteral("stereo/right/needle.png"), QStringLiteral("stereo/right/cap.png"),
-                           rightCalib, rightTable));
+    stereo.insert(QStringLiteral("left"), meterAt(leftBase, leftCalib, leftTable));
+    stereo.insert(QStringLiteral("right"), meterAt(rightBase, rightCalib, rightTable));
     meters.insert(QStringLiteral("stereo"), stereo);
 
     QJsonObject root;
@@ -509,19 +516,37 @@ SkinImporter::ImportResult SkinImporter::importAimpZip(const QString& zipFilePat
     root.insert(QStringLiteral("meters"), meters);
     root.insert(QStringLiteral("importedFrom"), zipInfo.fileName());
 
-    const QString jsonPath = skinDir.filePath(QStringLiteral("skin.json"));
-    QFile jsonFile(jsonPath);
-    if (!jsonFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-        result.error = QStringLiteral("Failed to write skin.json");
-        return result;
-    }
-
     const QJsonDocument doc(root);
-    jsonFile.write(doc.toJson(QJsonDocument::Indented));
-    jsonFile.close();
+    if (!writeFile(skinDir.filePath(QStringLiteral("skin.json")), doc.toJson(QJsonDocument::Indented), &writeError))
+        return abandon(QStringLiteral("Failed to write skin.json"));
 
     result.ok = true;
     result.skinName = finalDirName;
     result.skinDir = skinDirPath;
     return result;
+#endif
+}
+
+QList<SkinImporter::ImportResult> SkinImporter::importAimpZips(const QStringList& zipFilePaths) const {
+    QList<ImportResult> results(zipFilePaths.size());
+
+    // Each archive is independent; zip inflate and PNG checks keep a core busy each
+    const auto count = static_cast<unsigned int>(zipFilePaths.size());
+    const unsigned int threads = std::min(count, std::max(1u, std::thread::hardware_concurrency()));
+    std::atomic<unsigned int> next{0};
+    const auto work = [&] {
+        for (unsigned int i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            results[static_cast<qsizetype>(i)] = importAimpZip(zipFilePaths[static_cast<qsizetype>(i)]);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned int t = 1; t < threads; ++t) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    return results;
 }
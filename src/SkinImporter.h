@@ -1,8 +1,12 @@
 #pragma once
 
+#include <QList>
 #include <QString>
 #include <QStringList>
 
+// Converts AIMP VU skins (a ZIP with skin.ini and PNGs) into skin packages.
+// Only the entries a skin needs are read, straight into memory; the skin
+// directory receives skin.json and the images, and nothing is extracted aside.
 class SkinImporter {
   public:
     struct ImportResult {
@@ -14,4 +18,7 @@ class SkinImporter {
     };
 
     ImportResult importAimpZip(const QString& zipFilePath) const;
+
+    // Imports several archives in parallel; the results are in the order of the paths
+    QList<ImportResult> importAimpZips(const QStringList& zipFilePaths) const;
 };
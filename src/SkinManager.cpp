@@ -1,16 +1,23 @@
 #include "SkinManager.h"
 
+#include "SkinCache.h"
+#include "StartupTrace.h"
 #include "VUMeterScale.h"
 
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
+#include <QImage>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QSaveFile>
 #include <QStandardPaths>
+#include <QThread>
 
 #include <algorithm>
+#include <memory>
 
 namespace {
 
@@ -56,6 +63,65 @@ QString jsonString(const QJsonObject& o, const QString& key, const QString& fall
     return fallback;
 }
 
+// "ballistics": either a preset name, or an object that adjusts one:
+//   { "preset": "ppm2", "attackMs": 5, "fallDbPerSecond": 8.6, ... }
+bool parseBallistics(const QJsonValue& v, VuBallisticsProfile* out, QStringList* warnings) {
+    const auto preset = [&](const QString& name) {
+        if (vuBallisticsPresetByName(name.toStdString(), out))
+            return true;
+        if (warnings)
+            warnings->push_back(QStringLiteral("Unknown ballistics preset: %1").arg(name));
+        return false;
+    };
+
+    if (v.isString())
+        return preset(v.toString());
+    if (!v.isObject()) {
+        if (warnings)
+            warnings->push_back(QStringLiteral("Invalid ballistics field"));
+        return false;
+    }
+
+    const QJsonObject o = v.toObject();
+    *out = VuBallisticsProfile();
+    if (o.contains(QStringLiteral("preset")) &&
+        !preset(jsonString(o, QStringLiteral("preset"), QStringLiteral("pioneer"), warnings)))
+        return false;
+
+    const QString kind = jsonString(o, QStringLiteral("kind"), QString(), warnings);
+    if (kind == QStringLiteral("vu"))
+        out->kind = VuBallisticsProfile::Kind::Vu;
+    else if (kind == QStringLiteral("ppm"))
+        out->kind = VuBallisticsProfile::Kind::Ppm;
+    else if (!kind.isEmpty() && warnings)
+        warnings->push_back(QStringLiteral("Unknown ballistics kind: %1").arg(kind));
+
+    const QString detector = jsonString(o, QStringLiteral("detector"), QString(), warnings);
+    if (detector == QStringLiteral("rms"))
+        out->detector = VuBallisticsProfile::Detector::Rms;
+    else if (detector == QStringLiteral("peak"))
+        out->detector = VuBallisticsProfile::Detector::Peak;
+    else if (!detector.isEmpty() && warnings)
+        warnings->push_back(QStringLiteral("Unknown ballistics detector: %1").arg(detector));
+
+    // Times are in ms in the file, like the standards quote them; non-positive ones are ignored
+    const auto ms = [&](const char* key, float* seconds) {
+        const qreal value = jsonReal(o, QLatin1String(key), *seconds * 1000.0, warnings);
+        if (value > 0.0)
+            *seconds = static_cast<float>(value / 1000.0);
+    };
+    ms("attackMs", &out->attackTau);
+    ms("releaseMs", &out->releaseTau);
+    ms("peakAttackMs", &out->peakAttackTau);
+    ms("peakReleaseMs", &out->peakReleaseTau);
+
+    out->fallDbPerSecond = static_cast<float>(
+        std::max<qreal>(0.0, jsonReal(o, QStringLiteral("fallDbPerSecond"), out->fallDbPerSecond, warnings)));
+    out->overshootMix = static_cast<float>(
+        std::clamp<qreal>(jsonReal(o, QStringLiteral("overshoot"), out->overshootMix, warnings), 0.0, 1.0));
+    return true;
+}
+
 VUMeterCalibration parseCalibration(const QJsonObject& o, QStringList* warnings) {
     VUMeterCalibration c = defaultCalibration();
 
@@ -113,9 +179,16 @@ VUMeterScaleTable parseScaleTable(const QJsonValue& v, const VUMeterCalibration&
     return t;
 }
 
-bool loadPixmap(QPixmap* out, const QString& absPath, QStringList* warnings) {
+// Worker threads: QImage is safe to decode anywhere, QPixmap only on the GUI thread
+// `decoded` holds the images of this skin decoded so far: meters that share a file
+// (imported skins do) share one image
+bool loadImage(QImage* out, const QString& absPath, QHash<QString, QImage>* decoded, QStringList* warnings) {
     if (!out)
         return false;
+    if (const auto it = decoded->constFind(absPath); it != decoded->constEnd()) {
+        *out = *it;
+        return true;
+    }
     if (!QFileInfo::exists(absPath)) {
         if (warnings)
             warnings->push_back(QStringLiteral("Missing asset: %1").arg(absPath));
@@ -126,12 +199,22 @@ bool loadPixmap(QPixmap* out, const QString& absPath, QStringList* warnings) {
             warnings->push_back(QStringLiteral("Failed to load image: %1").arg(absPath));
         return false;
     }
+
+    // The pixel format of the compiled cache, and what QPixmap keeps on raster anyway
+    *out = out->convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    decoded->insert(absPath, *out);
     return true;
 }
 
-bool parseMeter(const QJsonObject& meterObj, const QDir& skinDir, VUMeterSkin* outSkin, VUMeterScaleTable* outScale,
-               QStringList* warnings) {
-    if (!outSkin || !outScale)
+struct MeterImages {
+    QImage face;
+    QImage needle;
+    QImage cap;
+};
+
+bool parseMeter(const QJsonObject& meterObj, const QDir& skinDir, VUMeterSkin* outSkin, MeterImages* outImages,
+               VUMeterScaleTable* outScale, QHash<QString, QImage>* decoded, QStringList* warnings) {
+    if (!outSkin || !outImages || !outScale)
         return false;
 
     const QJsonObject assets = meterObj.value(QStringLiteral("assets")).toObject();
@@ -148,37 +231,137 @@ bool parseMeter(const QJsonObject& meterObj, const QDir& skinDir, VUMeterSkin* o
     const QString needleAbs = skinDir.filePath(needleRel);
     const QString capAbs = skinDir.filePath(capRel);
 
-    const bool okFace = loadPixmap(&outSkin->face, faceAbs, warnings);
-    const bool okNeedle = loadPixmap(&outSkin->needle, needleAbs, warnings);
-    const bool okCap = loadPixmap(&outSkin->cap, capAbs, warnings);
+    const bool okFace = loadImage(&outImages->face, faceAbs, decoded, warnings);
+    const bool okNeedle = loadImage(&outImages->needle, needleAbs, decoded, warnings);
+    const bool okCap = loadImage(&outImages->cap, capAbs, decoded, warnings);
 
     return okFace && okNeedle && okCap;
 }
 
+bool sameImages(const MeterImages& a, const MeterImages& b) {
+    return a.face.cacheKey() == b.face.cacheKey() && a.needle.cacheKey() == b.needle.cacheKey() &&
+           a.cap.cacheKey() == b.cap.cacheKey();
+}
+
+// GUI thread. Meters that share their images (mono skins) share the pixmaps too.
+void applyImages(VUMeterSkin* skin,
+                 const MeterImages& images,
+                 const VUMeterSkin* shared,
+                 const MeterImages* sharedImages) {
+    if (shared && sharedImages && sameImages(images, *sharedImages)) {
+        skin->face = shared->face;
+        skin->needle = shared->needle;
+        skin->cap = shared->cap;
+        return;
+    }
+    skin->face = QPixmap::fromImage(images.face);
+    skin->needle = QPixmap::fromImage(images.needle);
+    skin->cap = QPixmap::fromImage(images.cap);
+}
+
+// --- Metadata index ---
+// One entry per skin directory; an entry is reused while its modification time matches
+constexpr int kIndexVersion = 1;
+
+QString indexPath() {
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/skin-index.json");
+}
+
+qint64 skinModified(const QFileInfo& dirInfo, const QFileInfo& jsonInfo) {
+    return std::max(dirInfo.lastModified().toMSecsSinceEpoch(), jsonInfo.lastModified().toMSecsSinceEpoch());
+}
+
+// Decoded skins kept in memory; a stereo skin at 2x is a few MB
+constexpr int kSkinCacheSize = 6;
+
 } // namespace
 
-SkinManager::SkinManager() = default;
+struct SkinManager::DecodedSkin {
+    LoadedSkin skin; // everything but the pixmaps
+    MeterImages single;
+    MeterImages left;
+    MeterImages right;
+};
+
+SkinManager::SkinManager(QObject* parent) : QObject(parent) {
+    // Decoding is mostly inflate and disk: a few threads are plenty
+    pool_.setMaxThreadCount(std::clamp(QThread::idealThreadCount(), 1, 4));
+}
+
+SkinManager::~SkinManager() {
+    // Finished decodes post to this object; let them land before it is gone
+    pool_.waitForDone();
+}
 
 QString SkinManager::skinsRootPath() {
     return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/skins");
 }
 
 void SkinManager::scan() {
-    skins_.clear();
+    setSkins(scanSkins());
+}
+
+void SkinManager::scanAsync() {
+    pool_.start([this] {
+        QList<SkinInfo> skins;
+        {
+            StartupTrace::Phase phase("skin scan");
+            skins = scanSkins();
+        }
+        QMetaObject::invokeMethod(
+            this,
+            [this, skins = std::move(skins)] {
+                setSkins(skins);
+                emit skinsScanned();
+            },
+            Qt::QueuedConnection);
+    });
+}
+
+QList<SkinManager::SkinInfo> SkinManager::scanSkins() {
+    QList<SkinInfo> skins;
 
     const QDir root(skinsRootPath());
     if (!root.exists())
-        return;
+        return skins;
+
+    QJsonObject index;
+    {
+        QFile f(indexPath());
+        if (f.open(QIODevice::ReadOnly)) {
+            const QJsonObject rootObj = QJsonDocument::fromJson(f.readAll()).object();
+            if (rootObj.value(QStringLiteral("version")).toInt() == kIndexVersion)
+                index = rootObj.value(QStringLiteral("skins")).toObject();
+        }
+    }
 
     const QFileInfoList dirs = root.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
 
+    QJsonObject newIndex;
+    bool indexChanged = false;
+
     for (const QFileInfo& di : dirs) {
         const QDir skinDir(di.absoluteFilePath());
-        const QString jsonPath = skinDir.filePath(QStringLiteral("skin.json"));
-        if (!QFileInfo::exists(jsonPath))
+        const QFileInfo jsonInfo(skinDir.filePath(QStringLiteral("skin.json")));
+        if (!jsonInfo.exists())
             continue;
 
-        QFile f(jsonPath);
+        SkinInfo info;
+        info.id = di.fileName();
+        info.skinDir = di.absoluteFilePath();
+        info.modified = skinModified(di, jsonInfo);
+
+        const QJsonObject entry = index.value(info.id).toObject();
+        const auto indexed = static_cast<qint64>(entry.value(QStringLiteral("modified")).toDouble());
+        if (!entry.isEmpty() && indexed == info.modified) {
+            info.name = entry.value(QStringLiteral("name")).toString(info.id);
+            info.isStereo = entry.value(QStringLiteral("stereo")).toBool();
+            newIndex.insert(info.id, entry);
+            skins.push_back(info);
+            continue;
+        }
+
+        QFile f(jsonInfo.absoluteFilePath());
         if (!f.open(QIODevice::ReadOnly))
             continue;
         const QByteArray data = f.readAll();
@@ -192,31 +375,189 @@ void SkinManager::scan() {
         const QString name = rootObj.value(QStringLiteral("name")).toString(di.fileName());
         const QString type = rootObj.value(QStringLiteral("type")).toString(QStringLiteral("single"));
 
-        SkinInfo info;
-        info.id = di.fileName();
         info.name = name;
         info.isStereo = (type == QStringLiteral("stereo"));
-        info.skinDir = di.absoluteFilePath();
-        skins_.push_back(info);
+        skins.push_back(info);
+
+        QJsonObject fresh;
+        fresh.insert(QStringLiteral("modified"), static_cast<double>(info.modified));
+        fresh.insert(QStringLiteral("name"), info.name);
+        fresh.insert(QStringLiteral("stereo"), info.isStereo);
+        newIndex.insert(info.id, fresh);
+        indexChanged = true;
+    }
+
+    // Removed skins drop out of the index too
+    if (indexChanged || newIndex.size() != index.size()) {
+        QDir().mkpath(QFileInfo(indexPath()).absolutePath());
+        QSaveFile f(indexPath());
+        if (f.open(QIODevice::WriteOnly)) {
+            QJsonObject rootObj;
+            rootObj.insert(QStringLiteral("version"), kIndexVersion);
+            rootObj.insert(QStringLiteral("skins"), newIndex);
+            f.write(QJsonDocument(rootObj).toJson(QJsonDocument::Compact));
+            if (!f.commit())
+                qWarning("SkinManager: cannot write %s", qPrintable(indexPath()));
+        }
     }
+
+    return skins;
 }
 
-SkinManager::LoadedSkin SkinManager::loadSkin(const QString& skinId) const {
-    LoadedSkin out;
+void SkinManager::setSkins(const QList<SkinInfo>& skins) {
+    skins_ = skins;
 
+    // A skin that changed on disk must not be served from memory
+    for (auto it = cache_.begin(); it != cache_.end();) {
+        const SkinInfo* info = findSkin(it->id);
+        if (!info || info->modified != it->modified)
+            it = cache_.erase(it);
+        else
+            ++it;
+    }
+}
+
+const SkinManager::SkinInfo* SkinManager::findSkin(const QString& skinId) const {
     const auto it = std::find_if(skins_.begin(), skins_.end(), [&](const SkinInfo& i) { return i.id == skinId; });
-    if (it == skins_.end()) {
+    return it == skins_.end() ? nullptr : &*it;
+}
+
+const SkinManager::LoadedSkin* SkinManager::cachedSkin(const SkinInfo& info) {
+    for (int i = 0; i < cache_.size(); ++i) {
+        if (cache_[i].id == info.id && cache_[i].modified == info.modified) {
+            cache_.move(i, 0);
+            return &cache_.front().skin;
+        }
+    }
+    return nullptr;
+}
+
+void SkinManager::cacheSkin(const SkinInfo& info, const LoadedSkin& skin) {
+    if (!skin.ok)
+        return;
+    cache_.removeIf([&](const CachedSkin& c) { return c.id == info.id; });
+    cache_.prepend(CachedSkin{info.id, info.modified, skin});
+    while (cache_.size() > kSkinCacheSize)
+        cache_.removeLast();
+}
+
+SkinManager::LoadedSkin SkinManager::loadSkin(const QString& skinId) {
+    const SkinInfo* info = findSkin(skinId);
+    if (!info) {
+        LoadedSkin out;
         out.error = QStringLiteral("Unknown skin id: %1").arg(skinId);
         return out;
     }
+    if (const LoadedSkin* cached = cachedSkin(*info))
+        return *cached;
 
-    const QDir skinDir(it->skinDir);
+    const LoadedSkin out = finishSkin(decodeSkin(*info));
+    cacheSkin(*info, out);
+    return out;
+}
+
+void SkinManager::loadSkinAsync(const QString& skinId) {
+    const SkinInfo* info = findSkin(skinId);
+    if (!info) {
+        LoadedSkin out;
+        out.error = QStringLiteral("Unknown skin id: %1").arg(skinId);
+        emit skinLoaded(skinId, out);
+        return;
+    }
+    if (const LoadedSkin* cached = cachedSkin(*info)) {
+        emit skinLoaded(skinId, *cached);
+        return;
+    }
+    if (decoding_.contains(skinId))
+        return;
+
+    decoding_.insert(skinId);
+    pool_.start([this, info = *info] {
+        auto decoded = std::make_shared<DecodedSkin>(decodeSkin(info));
+        QMetaObject::invokeMethod(
+            this,
+            [this, info, decoded] {
+                decoding_.remove(info.id);
+                const LoadedSkin out = finishSkin(std::move(*decoded));
+
+                // Cached under the stamp it was decoded from; a rescan in between drops it
+                cacheSkin(info, out);
+                emit skinLoaded(info.id, out);
+            },
+            Qt::QueuedConnection);
+    });
+}
+
+void SkinManager::prefetch(const QString& skinId) {
+    const SkinInfo* info = findSkin(skinId);
+    if (!info || decoding_.contains(skinId))
+        return;
+    for (const CachedSkin& c : cache_) {
+        if (c.id == info->id && c.modified == info->modified)
+            return;
+    }
+    loadSkinAsync(skinId);
+}
+
+SkinManager::DecodedSkin SkinManager::decodeSkin(const SkinInfo& info) {
+    const QString cachePath = CompiledSkinCache::pathFor(info.id);
+    const QByteArray hash = CompiledSkinCache::contentHash(info.skinDir);
+
+    CompiledSkin compiled;
+    if (CompiledSkinCache::read(cachePath, hash, &compiled)) {
+        DecodedSkin decoded;
+        LoadedSkin& out = decoded.skin;
+        out.package.isStereo = compiled.isStereo;
+        out.package.hasBallistics = compiled.hasBallistics;
+        out.package.ballistics = compiled.ballistics;
+
+        const auto unpack = [](CompiledSkin::Meter& m,
+                               VUMeterSkin* skin,
+                               MeterImages* images,
+                               VUMeterScaleTable* scale) {
+            skin->calib = m.calib;
+            *scale = std::move(m.scale);
+            *images = MeterImages{std::move(m.face), std::move(m.needle), std::move(m.cap)};
+        };
+        unpack(compiled.single, &out.package.single, &decoded.single, &out.singleScale);
+        unpack(compiled.left, &out.package.left, &decoded.left, &out.leftScale);
+        unpack(compiled.right, &out.package.right, &decoded.right, &out.rightScale);
+        out.ok = true;
+        return decoded;
+    }
+
+    DecodedSkin decoded = parseSkin(info);
+    if (!decoded.skin.ok)
+        return decoded;
+
+    const LoadedSkin& out = decoded.skin;
+    compiled.isStereo = out.package.isStereo;
+    compiled.hasBallistics = out.package.hasBallistics;
+    compiled.ballistics = out.package.ballistics;
+    const auto pack = [](const VUMeterSkin& skin, const MeterImages& images, const VUMeterScaleTable& scale) {
+        return CompiledSkin::Meter{skin.calib, scale, images.face, images.needle, images.cap};
+    };
+    compiled.single = pack(out.package.single, decoded.single, out.singleScale);
+    compiled.left = pack(out.package.left, decoded.left, out.leftScale);
+    compiled.right = pack(out.package.right, decoded.right, out.rightScale);
+
+    QString error;
+    if (!CompiledSkinCache::write(cachePath, hash, compiled, &error))
+        qWarning("SkinManager: %s", qPrintable(error));
+    return decoded;
+}
+
+SkinManager::DecodedSkin SkinManager::parseSkin(const SkinInfo& info) {
+    DecodedSkin decoded;
+    LoadedSkin& out = decoded.skin;
+
+    const QDir skinDir(info.skinDir);
     const QString jsonPath = skinDir.filePath(QStringLiteral("skin.json"));
 
     QFile f(jsonPath);
     if (!f.open(QIODevice::ReadOnly)) {
         out.error = QStringLiteral("Failed to open skin.json");
-        return out;
+        return decoded;
     }
     const QByteArray data = f.readAll();
     f.close();
@@ -224,7 +565,7 @@ SkinManager::LoadedSkin SkinManager::loadSkin(const QString& skinId) const {
     const QJsonDocument doc = QJsonDocument::fromJson(data);
     if (!doc.isObject()) {
         out.error = QStringLiteral("skin.json is not a JSON object");
-        return out;
+        return decoded;
     }
 
     const QJsonObject rootObj = doc.object();
@@ -235,13 +576,10 @@ SkinManager::LoadedSkin SkinManager::loadSkin(const QString& skinId) const {
     const QJsonObject singleObj = meters.value(QStringLiteral("single")).toObject();
     const QJsonObject stereoObj = meters.value(QStringLiteral("stereo")).toObject();
 
-    VUMeterSkin singleSkin;
-    VUMeterSkin leftSkin;
-    VUMeterSkin rightSkin;
-
-    VUMeterScaleTable singleScale;
-    VUMeterScaleTable leftScale;
-    VUMeterScaleTable rightScale;
+    QHash<QString, QImage> images;
+    VUMeterSkin& singleSkin = out.package.single;
+    VUMeterSkin& leftSkin = out.package.left;
+    VUMeterSkin& rightSkin = out.package.right;
 
     bool ok = true;
 
@@ -249,37 +587,49 @@ SkinManager::LoadedSkin SkinManager::loadSkin(const QString& skinId) const {
         const QJsonObject leftObj = stereoObj.value(QStringLiteral("left")).toObject();
         const QJsonObject rightObj = stereoObj.value(QStringLiteral("right")).toObject();
 
-        ok = parseMeter(leftObj, skinDir, &leftSkin, &leftScale, &out.warnings) &&
-             parseMeter(rightObj, skinDir, &rightSkin, &rightScale, &out.warnings);
+        ok = parseMeter(leftObj, skinDir, &leftSkin, &decoded.left, &out.leftScale, &images, &out.warnings) &&
+             parseMeter(rightObj, skinDir, &rightSkin, &decoded.right, &out.rightScale, &images, &out.warnings);
 
         if (!singleObj.isEmpty()) {
-            parseMeter(singleObj, skinDir, &singleSkin, &singleScale, &out.warnings);
+            parseMeter(singleObj, skinDir, &singleSkin, &decoded.single, &out.singleScale, &images, &out.warnings);
         } else {
             singleSkin = leftSkin;
-            singleScale = leftScale;
+            decoded.single = decoded.left;
+            out.singleScale = out.leftScale;
         }
     } else {
-        ok = parseMeter(singleObj, skinDir, &singleSkin, &singleScale, &out.warnings);
+        ok = parseMeter(singleObj, skinDir, &singleSkin, &decoded.single, &out.singleScale, &images, &out.warnings);
         leftSkin = singleSkin;
         rightSkin = singleSkin;
-        leftScale = singleScale;
-        rightScale = singleScale;
+        decoded.left = decoded.single;
+        decoded.right = decoded.single;
+        out.leftScale = out.singleScale;
+        out.rightScale = out.singleScale;
     }
 
     if (!ok) {
         out.error = QStringLiteral("Failed to load one or more required skin assets");
-        return out;
+        return decoded;
     }
 
     out.package.isStereo = isStereo;
-    out.package.single = singleSkin;
-    out.package.left = leftSkin;
-    out.package.right = rightSkin;
 
-    out.singleScale = singleScale;
-    out.leftScale = leftScale;
-    out.rightScale = rightScale;
+    const QJsonValue ballisticsV = rootObj.value(QStringLiteral("ballistics"));
+    if (!ballisticsV.isUndefined())
+        out.package.hasBallistics = parseBallistics(ballisticsV, &out.package.ballistics, &out.warnings);
 
     out.ok = true;
+    return decoded;
+}
+
+SkinManager::LoadedSkin SkinManager::finishSkin(DecodedSkin&& decoded) {
+    LoadedSkin out = std::move(decoded.skin);
+    if (!out.ok)
+        return out;
+
+    VUSkinPackage& package = out.package;
+    applyImages(&package.single, decoded.single, nullptr, nullptr);
+    applyImages(&package.left, decoded.left, &package.single, &decoded.single);
+    applyImages(&package.right, decoded.right, &package.single, &decoded.single);
     return out;
 }
@@ -4,16 +4,29 @@
 #include "VUMeterSkin.h"
 
 #include <QList>
+#include <QObject>
+#include <QSet>
 #include <QString>
 #include <QStringList>
+#include <QThreadPool>
+
+// Skin discovery and loading.
+//
+// scan() only reads manifest metadata, and keeps it in an index file so that an
+// unchanged skin directory is not even opened on the next start. Images are
+// decoded off the GUI thread (QImage, on a small pool, so several skins can decode
+// at once) and the most recently used skins stay decoded in memory. The first load
+// of a skin also compiles it (see CompiledSkinCache); later loads map that file.
+class SkinManager final : public QObject {
+    Q_OBJECT
 
-class SkinManager {
   public:
     struct SkinInfo {
         QString id;
         QString name;
         bool isStereo = false;
         QString skinDir;
+        qint64 modified = 0; // ms since epoch: newest of the directory and its skin.json
     };
 
     struct LoadedSkin {
@@ -27,9 +40,12 @@ class SkinManager {
         VUMeterScaleTable rightScale;
     };
 
-    SkinManager();
+    explicit SkinManager(QObject* parent = nullptr);
+    ~SkinManager() override;
 
     void scan();
+    // scan() off the GUI thread; skinsScanned() follows
+    void scanAsync();
     QList<SkinInfo> availableSkins() const { return skins_; }
 
     void setActiveSkinId(const QString& skinId) { activeSkinId_ = skinId; }
@@ -38,13 +54,55 @@ class SkinManager {
     void reset() {
         skins_.clear();
         activeSkinId_.clear();
+        cache_.clear();
     }
 
-    LoadedSkin loadSkin(const QString& skinId) const;
+    // Blocking load: returns the cached skin or decodes it on the calling (GUI) thread
+    LoadedSkin loadSkin(const QString& skinId);
+
+    // Decodes in the background; skinLoaded() follows, right away if the skin is cached.
+    // A skin already being decoded is not decoded twice.
+    void loadSkinAsync(const QString& skinId);
+
+    // loadSkinAsync() for a skin that will probably be wanted soon (menu hover)
+    void prefetch(const QString& skinId);
 
     static QString skinsRootPath();
 
+  signals:
+    // GUI thread; also emitted for prefetched skins
+    void skinLoaded(const QString& skinId, const SkinManager::LoadedSkin& skin);
+    // GUI thread, once availableSkins() holds the result of scanAsync()
+    void skinsScanned();
+
   private:
+    struct DecodedSkin;
+    struct CachedSkin {
+        QString id;
+        qint64 modified = 0;
+        LoadedSkin skin;
+    };
+
+    // The disk side of scan() (any thread; also rewrites the index), and applying its result
+    static QList<SkinInfo> scanSkins();
+    void setSkins(const QList<SkinInfo>& skins);
+
+    const SkinInfo* findSkin(const QString& skinId) const;
+    const LoadedSkin* cachedSkin(const SkinInfo& info);
+    void cacheSkin(const SkinInfo& info, const LoadedSkin& skin);
+
+    // Worker side: JSON and QImage only, no QPixmap. decodeSkin() goes through the
+    // compiled skin cache and only falls back to parseSkin() when that is stale.
+    static DecodedSkin decodeSkin(const SkinInfo& info);
+    static DecodedSkin parseSkin(const SkinInfo& info);
+
+    // GUI side: turns the decoded images into pixmaps
+    static LoadedSkin finishSkin(DecodedSkin&& decoded);
+
     QList<SkinInfo> skins_;
     QString activeSkinId_;
+
+    QList<CachedSkin> cache_; // most recently used first
+    QSet<QString> decoding_;
+    QThreadPool pool_;
 };
@@ -0,0 +1,57 @@
+#include "StartupTrace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+// Both taken during static initialisation, on the main thread before main() and QApplication
+static const std::chrono::steady_clock::time_point kProcessStart = std::chrono::steady_clock::now();
+static const std::thread::id kMainThread = std::this_thread::get_id();
+
+std::int64_t StartupTrace::sinceStartNs() noexcept {
+    const auto elapsed = std::chrono::steady_clock::now() - kProcessStart;
+    // Never 0, which Phase uses for "not traced"
+    return std::max<std::int64_t>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+void StartupTrace::print(const char* name, std::int64_t atNs, std::int64_t durationNs) {
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> guard(mutex);
+
+    const double atMs = static_cast<double>(atNs) / 1e6;
+    const char* const thread = std::this_thread::get_id() == kMainThread ? "" : ", background";
+    if (durationNs < 0) {
+        std::fprintf(stderr, "startup: %9.1f ms  %s\n", atMs, name);
+    } else {
+        std::fprintf(stderr,
+                     "startup: %9.1f ms  %s (%.1f ms%s)\n",
+                     atMs,
+                     name,
+                     static_cast<double>(durationNs) / 1e6,
+                     thread);
+    }
+    std::fflush(stderr);
+}
+
+void StartupTrace::mark(const char* event) {
+    if (!enabled()) {
+        return;
+    }
+    print(event, sinceStartNs(), -1);
+}
+
+StartupTrace::Phase::Phase(const char* name) noexcept : name_(name) {
+    if (StartupTrace::enabled()) {
+        startNs_ = StartupTrace::sinceStartNs();
+    }
+}
+
+StartupTrace::Phase::~Phase() {
+    if (startNs_ == 0) {
+        return;
+    }
+    const std::int64_t endNs = StartupTrace::sinceStartNs();
+    StartupTrace::print(name_, endNs, endNs - startNs_);
+}
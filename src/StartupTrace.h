@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Cold start timeline for --startup-trace.
+//
+// Points in time are measured from process start (static initialisation of the
+// binary), phases by their own start and end, from whichever thread runs them.
+// Each entry goes to stderr as it completes, so the lines show the order in which
+// the background phases actually finished. Off by default; while off every probe
+// is a relaxed load of a flag.
+class StartupTrace final {
+  public:
+    static void setEnabled(bool enabled) noexcept { enabled_.store(enabled, std::memory_order_relaxed); }
+    static bool enabled() noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+    // "event" happened now
+    static void mark(const char* event);
+
+    // Times its own lifetime as the phase `name`
+    class Phase final {
+      public:
+        explicit Phase(const char* name) noexcept;
+        ~Phase();
+
+        Phase(const Phase&) = delete;
+        Phase& operator=(const Phase&) = delete;
+
+      private:
+        const char* name_;
+        std::int64_t startNs_ = 0; // 0 = tracing was off when the phase began
+    };
+
+  private:
+    static std::int64_t sinceStartNs() noexcept;
+    static void print(const char* name, std::int64_t atNs, std::int64_t durationNs);
+
+    static inline std::atomic<bool> enabled_{false};
+};
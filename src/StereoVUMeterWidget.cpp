@@ -1,19 +1,77 @@
 #include "StereoVUMeterWidget.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <mutex>
 
+#include <QCoreApplication>
+#include <QEvent>
 #include <QFontDatabase>
+#include <QFontMetrics>
 #include <QPainter>
-#include <QPainterPath>
+#include <QPointer>
+#include <QRegion>
+#include <QResizeEvent>
+#include <QThreadPool>
+#include <QTimer>
 #include <qnamespace.h>
 #include <qpixmap.h>
 #include <qtypes.h>
 
+#include "StartupTrace.h"
 #include "VUMeterScale.h"
+#if defined(ANALOGVU_HAS_OPENGL) && (ANALOGVU_HAS_OPENGL == 1)
+#include "VUMeterGLWidget.h"
+#endif
 
 static constexpr float kPi = 3.14159265358979323846f;
 
+// Needle tip movements smaller than this (in logical pixels) are not repainted.
+static constexpr qreal kNeedleRepaintThresholdPx = 0.25;
+
+static_assert(StereoVUMeterWidget::kMaxMeters <= MeterRenderThread::kMaxMeters);
+
+// The built-in skin's images are embedded twice: at full size, and at half size in
+// preview/, which decodes in a fraction of the time and carries the first frames
+// until the full-size images are ready. Its calibration is in full-size pixels.
+static constexpr int kDefaultSkinPreviewScale = 2;
+
+// --- Process-wide resources, loaded off the GUI thread ---
+
+// Registering the SONY logo font goes through fontconfig and can take a while on a
+// slow machine. The first caller does it (QFontDatabase is thread-safe); a caller
+// that arrives meanwhile waits for it instead of registering the font twice.
+static QString logoFontFamily() {
+    static const QString family = [] {
+        StartupTrace::Phase phase("logo font");
+        const int fontId = QFontDatabase::addApplicationFont(":/fonts/clarendon_regular.otf");
+        const QStringList families = fontId != -1 ? QFontDatabase::applicationFontFamilies(fontId) : QStringList();
+        return families.isEmpty() ? QString() : families.first();
+    }();
+    return family;
+}
+
+struct DefaultSkinImages {
+    QImage face;
+    QImage needle;
+    QImage cap;
+};
+
+static std::atomic<bool> defaultSkinDecoded{false};
+
+// Full-size images of the built-in skin, decoded once by the first caller
+static const DefaultSkinImages& defaultSkinImages() {
+    static const DefaultSkinImages images = [] {
+        StartupTrace::Phase phase("default skin");
+        return DefaultSkinImages{QImage(":/images/model_702w/0.png"),
+                                 QImage(":/images/model_702w/1.png"),
+                                 QImage(":/images/model_702w/2.png")};
+    }();
+    defaultSkinDecoded.store(true, std::memory_order_release);
+    return images;
+}
+
 static QPointF polarFromBottomPivot(const QPointF& pivot, float radius, float thetaDeg) {
     const float theta = thetaDeg * (kPi / 180.0f);
     const float sx = std::sin(theta);
@@ -21,40 +79,319 @@ static QPointF polarFromBottomPivot(const QPointF& pivot, float radius, float th
     return QPointF(pivot.x() + radius * sx, pivot.y() - radius * cy);
 }
 
+// Rotation center of a skin needle in widget coordinates.
+static QPointF skinPivot(const QRectF& rect, const VUMeterSkin& skin) {
+    const qreal scaleX = rect.width() / skin.face.width();
+    const qreal scaleY = rect.height() / skin.face.height();
+    return QPointF(rect.left() + skin.calib.pivotX * scaleX, rect.top() + skin.calib.pivotY * scaleY);
+}
+
+// Bounding box (always including the pivot) of a set of points rotated around pivot through every
+// angle in [fromDeg, toDeg], in the same sense as QPainter::rotate(). Because the box of a convex shape is attained at its
+// vertices, passing the corners of a shape bounds the whole swept shape.
+static QRectF rotatedSweepBounds(const QPointF& pivot, const QList<QPointF>& points, float fromDeg, float toDeg) {
+    const float lo = std::min(fromDeg, toDeg);
+    const float hi = std::max(fromDeg, toDeg);
+
+    qreal minX = pivot.x();
+    qreal maxX = pivot.x();
+    qreal minY = pivot.y();
+    qreal maxY = pivot.y();
+    auto include = [&](const QPointF& pt) {
+        minX = std::min(minX, pt.x());
+        maxX = std::max(maxX, pt.x());
+        minY = std::min(minY, pt.y());
+        maxY = std::max(maxY, pt.y());
+    };
+
+    for (const QPointF& pt : points) {
+        const QPointF d = pt - pivot;
+        const qreal rho = std::hypot(d.x(), d.y());
+        const qreal phi = std::atan2(d.y(), d.x()) * (180.0 / kPi);
+
+        auto at = [&](qreal deg) {
+            const qreal rad = deg * (kPi / 180.0);
+            return pivot + QPointF(rho * std::cos(rad), rho * std::sin(rad));
+        };
+
+        const qreal start = phi + lo;
+        const qreal end = phi + hi;
+        include(at(start));
+        include(at(end));
+
+        // Axis extremes crossed during the sweep
+        for (qreal k = std::ceil(start / 90.0) * 90.0; k <= end; k += 90.0) {
+            include(at(k));
+        }
+    }
+
+    return QRectF(QPointF(minX, minY), QPointF(maxX, maxY));
+}
+
+// Bounding rectangle of all non-transparent pixels of an image.
+static QRect opaqueBounds(const QPixmap& pixmap) {
+    if (pixmap.isNull()) {
+        return {};
+    }
+    if (!pixmap.hasAlphaChannel()) {
+        return pixmap.rect();
+    }
+
+    const QImage img = pixmap.toImage().convertToFormat(QImage::Format_ARGB32);
+    int minX = img.width();
+    int minY = img.height();
+    int maxX = -1;
+    int maxY = -1;
+
+    for (int y = 0; y < img.height(); ++y) {
+        const QRgb* line = reinterpret_cast<const QRgb*>(img.constScanLine(y));
+        for (int x = 0; x < img.width(); ++x) {
+            if (qAlpha(line[x]) != 0) {
+                minX = std::min(minX, x);
+                maxX = std::max(maxX, x);
+                minY = std::min(minY, y);
+                maxY = std::max(maxY, y);
+            }
+        }
+    }
+
+    if (maxX < 0) {
+        return {};
+    }
+    return QRect(QPoint(minX, minY), QPoint(maxX, maxY));
+}
+
 void StereoVUMeterWidget::setSkinPackage(const VUSkinPackage& skin,
                                         const VUMeterScaleTable& singleScale,
                                         const VUMeterScaleTable& leftScale,
                                         const VUMeterScaleTable& rightScale) {
     skin_ = skin;
-    singleScaleTable_ = singleScale;
-    leftScaleTable_ = leftScale;
-    rightScaleTable_ = rightScale;
+    defaultSkinPreview_ = false;
+    singleScale_ = VUMeterScaleLut(singleScale);
+    leftScale_ = VUMeterScaleLut(leftScale);
+    rightScale_ = VUMeterScaleLut(rightScale);
+    updateNeedleBounds();
+    invalidateFaceLayers();
+    invalidateRenderScene();
+    rebuildSkinLayers();
+    rebuildNeedleAtlases();
+    updateGlView();
     update();
 }
 
 void StereoVUMeterWidget::clearSkin() {
     loadDefaultSkin();
+    invalidateFaceLayers();
+    invalidateRenderScene();
+    rebuildSkinLayers();
+    rebuildNeedleAtlases();
+    updateGlView();
+    update();
+}
+
+bool StereoVUMeterWidget::isRenderBackendAvailable(VUMeterRenderBackend backend) {
+#if defined(ANALOGVU_HAS_OPENGL) && (ANALOGVU_HAS_OPENGL == 1)
+    (void)backend;
+    return true;
+#else
+    return backend == VUMeterRenderBackend::Raster;
+#endif
+}
+
+void StereoVUMeterWidget::setRenderBackend(VUMeterRenderBackend backend) {
+    if (!isRenderBackendAvailable(backend) || renderBackend_ == backend) {
+        return;
+    }
+    renderBackend_ = backend;
+    updateGlView();
+    update();
+}
+
+bool StereoVUMeterWidget::glViewActive() const {
+    return glView_ && renderBackend_ == VUMeterRenderBackend::OpenGL && style_ == VUMeterStyle::Skin;
+}
+
+void StereoVUMeterWidget::updateGlView() {
+#if defined(ANALOGVU_HAS_OPENGL) && (ANALOGVU_HAS_OPENGL == 1)
+    const bool wanted = renderBackend_ == VUMeterRenderBackend::OpenGL && style_ == VUMeterStyle::Skin;
+    if (!wanted) {
+        if (glView_) {
+            // Drop the GL surface (and its textures) entirely when not in use
+            delete glView_;
+            glView_ = nullptr;
+        }
+        return;
+    }
+
+    if (!glView_) {
+        glView_ = new VUMeterGLWidget(this);
+        glView_->setGeometry(rect());
+        glView_->show();
+    }
+    glView_->setSkin(skin_);
+    syncGlView();
+#endif
+}
+
+void StereoVUMeterWidget::syncGlView() {
+#if defined(ANALOGVU_HAS_OPENGL) && (ANALOGVU_HAS_OPENGL == 1)
+    if (!glViewActive()) {
+        return;
+    }
+
+    const MeterLayout layout = computeLayout();
+
+    QVector<VUMeterGLWidget::MeterQuad> meters(layout.rects.size());
+    for (int i = 0; i < meters.size(); ++i) {
+        VUMeterGLWidget::MeterQuad& m = meters[i];
+        m.rect = layout.rects[i];
+        m.pivot = skinPivot(m.rect, meterSkin(i));
+        m.angleDeg = meterScale(i).angleDeg(levels_[i]);
+        m.rightSide = isRightSide(i);
+    }
+
+    glView_->setMeters(meters);
+#endif
+}
+
+void StereoVUMeterWidget::resizeEvent(QResizeEvent* event) {
+    QWidget::resizeEvent(event);
+    if (style_ == VUMeterStyle::Skin) {
+        scheduleSkinRebuild();
+    }
+    if (glView_) {
+        glView_->setGeometry(rect());
+        syncGlView();
+    }
+}
+
+void StereoVUMeterWidget::setNeedleAtlasStep(float degrees) {
+    degrees = degrees > 0.0f ? std::max(degrees, NeedleSpriteAtlas::kMinStepDeg) : 0.0f;
+    if (qFuzzyCompare(needleAtlasStepDeg_ + 1.0f, degrees + 1.0f)) {
+        return;
+    }
+    needleAtlasStepDeg_ = degrees;
+    rebuildNeedleAtlases();
+    invalidateRenderScene();
     update();
 }
 
+void StereoVUMeterWidget::scheduleSkinRebuild() {
+    // Restarting the timer debounces interactive resizes
+    skinRebuildTimer_->start();
+}
+
+void StereoVUMeterWidget::ensureSkinRebuildScheduled() {
+    // Paints arrive at the display rate while the needles move; restarting the
+    // timer from each of them would keep it from ever firing
+    if (!skinRebuildTimer_->isActive()) {
+        skinRebuildTimer_->start();
+    }
+}
+
+void StereoVUMeterWidget::rebuildSkinLayers() {
+    if (style_ != VUMeterStyle::Skin || width() <= 0 || height() <= 0) {
+        for (ScaledSkinLayers& layers : skinLayers_) {
+            layers.clear();
+        }
+        return;
+    }
+
+    const MeterLayout layout = computeLayout();
+    const qreal dpr = devicePixelRatio();
+
+    // Meters of one side all share the size of the first one in the grid
+    for (int side = 0; side < 2; ++side) {
+        if (side >= layout.rects.size()) {
+            skinLayers_[side].clear();
+            continue;
+        }
+        skinLayers_[side].build(meterSkin(side), layout.rects[side].size(), dpr);
+    }
+}
+
+void StereoVUMeterWidget::rebuildNeedleAtlases() {
+    needleAtlases_.clear();
+
+    if (needleAtlasStepDeg_ <= 0.0f || style_ != VUMeterStyle::Skin || width() <= 0 || height() <= 0) {
+        return;
+    }
+
+    const MeterLayout layout = computeLayout();
+    const qreal dpr = devicePixelRatio();
+
+    needleAtlases_.resize(layout.rects.size());
+    for (int i = 0; i < layout.rects.size(); ++i) {
+        const QRectF& rect = layout.rects[i];
+        const VUMeterSkin& skin = meterSkin(i);
+        const VUMeterScaleLut& scale = meterScale(i);
+        const QRect& opaque = isRightSide(i) ? needleOpaqueRight_ : needleOpaqueLeft_;
+        if (skin.face.isNull()) {
+            continue;
+        }
+
+        float minDeg = static_cast<float>(std::min(skin.calib.minAngle, skin.calib.maxAngle));
+        float maxDeg = static_cast<float>(std::max(skin.calib.minAngle, skin.calib.maxAngle));
+        if (!scale.isEmpty()) {
+            minDeg = std::min({minDeg, scale.firstAngleDeg(), scale.lastAngleDeg()});
+            maxDeg = std::max({maxDeg, scale.firstAngleDeg(), scale.lastAngleDeg()});
+        }
+
+        needleAtlases_[i].build(
+            skin.needle, opaque, rect, skinPivot(rect, skin), dpr, minDeg, maxDeg, needleAtlasStepDeg_);
+    }
+}
+
 StereoVUMeterWidget::StereoVUMeterWidget(QWidget* parent) : QWidget(parent) {
     setAttribute(Qt::WA_OpaquePaintEvent);
     setAttribute(Qt::WA_NoSystemBackground);
 
+    skinRebuildTimer_ = new QTimer(this);
+    skinRebuildTimer_->setSingleShot(true);
+    skinRebuildTimer_->setInterval(150);
+    connect(skinRebuildTimer_, &QTimer::timeout, this, [this]() {
+        rebuildSkinLayers();
+        rebuildNeedleAtlases();
+        invalidateRenderScene();
+        update();
+    });
+
+    // Starts on the preview images; the full-size ones replace them once decoded
     loadDefaultSkin();
-    // Load the SONY logo font from resources
-    int fontId = QFontDatabase::addApplicationFont(":/fonts/clarendon_regular.otf");
-    if (fontId != -1) {
-        QStringList families = QFontDatabase::applicationFontFamilies(fontId);
-        if (!families.isEmpty()) {
-            sonyFontFamily_ = families.first();
-        }
+    if (defaultSkinPreview_) {
+        QThreadPool::globalInstance()->start([widget = QPointer<StereoVUMeterWidget>(this)] {
+            defaultSkinImages();
+            // The pointer is only read on the GUI thread, where the widget is deleted
+            QMetaObject::invokeMethod(
+                QCoreApplication::instance(),
+                [widget] {
+                    if (widget) {
+                        widget->onDefaultSkinDecoded();
+                    }
+                },
+                Qt::QueuedConnection);
+        });
+    }
+
+    // Only the Sony style needs the logo font; it is usually registered before anyone picks it
+    static std::once_flag logoFontRequested;
+    std::call_once(logoFontRequested, [] { QThreadPool::globalInstance()->start([] { logoFontFamily(); }); });
+}
+
+void StereoVUMeterWidget::onDefaultSkinDecoded() {
+    // Unless a skin package has replaced the default skin meanwhile
+    if (defaultSkinPreview_) {
+        clearSkin();
     }
 }
 
 void StereoVUMeterWidget::setStyle(VUMeterStyle style) {
     if (style_ != style) {
         style_ = style;
+        rebuildSkinLayers();
+        rebuildNeedleAtlases();
+        invalidateRenderScene();
+        updateGlView();
         update();
     }
 }
@@ -135,17 +472,160 @@ StereoVUMeterWidget::StyleParams StereoVUMeterWidget::getStyleParams() const {
     return params;
 }
 
-void StereoVUMeterWidget::setLevels(float leftVuDb, float rightVuDb) {
-    left_ = leftVuDb;
-    right_ = rightVuDb;
+void StereoVUMeterWidget::setMeterCount(int count) {
+    count = std::clamp(count, 1, kMaxMeters);
+    if (count == meterCount()) {
+        return;
+    }
+
+    levels_.resize(count, -20.0f);
+    invalidateFaceLayers();
+    invalidateRenderScene();
+    rebuildSkinLayers();
+    rebuildNeedleAtlases();
+    syncGlView();
     update();
 }
 
-void StereoVUMeterWidget::paintEvent(QPaintEvent*) {
-    QPainter p(this);
-    p.setRenderHint(QPainter::Antialiasing, true);
-    p.setRenderHint(QPainter::TextAntialiasing, true);
+void StereoVUMeterWidget::setLevels(float leftVuDb, float rightVuDb) {
+    const float levels[2] = {leftVuDb, rightVuDb};
+    setLevels(levels, 2);
+}
+
+void StereoVUMeterWidget::setLevels(const float* vuDb, int count) {
+    const MeterLayout layout = computeLayout();
+    const int n = std::min(count, meterCount());
+
+    QRegion dirty;
+    for (int i = 0; i < n; ++i) {
+        if (invalidateNeedle(layout.rects[i], i, levels_[i], vuDb[i], &dirty)) {
+            levels_[i] = vuDb[i];
+        }
+    }
+
+    if (dirty.isEmpty()) {
+        return;
+    }
+    if (PerfCounters::enabled()) {
+        PerfCounters::increment(PerfCounters::Counter::LevelUpdates);
+    }
+
+    if (glViewActive()) {
+        syncGlView();
+    } else if (renderThread_) {
+        submitRenderFrame(dirty);
+    } else {
+        update(dirty);
+    }
+}
+
+float StereoVUMeterWidget::needleAngleDeg(float vuDb, int meter) const {
+    if (style_ != VUMeterStyle::Skin) {
+        return singleScale_.angleDeg(vuDb);
+    }
+    return meterScale(meter).angleDeg(vuDb);
+}
 
+StereoVUMeterWidget::NeedleSweep
+StereoVUMeterWidget::needleSweep(const QRectF& rect, int meter, float fromDeg, float toDeg) const {
+    NeedleSweep sweep{QRectF(), 0.0};
+
+    if (style_ != VUMeterStyle::Skin) {
+        const MeterGeometry g = meterGeometry(rect);
+        sweep.reach = g.radius * 0.98;
+
+        const QList<QPointF> points = {g.pivot, g.pivot + QPointF(0.0, -sweep.reach)};
+        QRectF b = rotatedSweepBounds(g.pivot, points, fromDeg, toDeg);
+
+        // Pen half-width plus antialiasing, and the (+2, +2) shadow offset
+        const qreal margin = std::max<qreal>(3.0, rect.width() * 0.008) / 2.0 + 1.0;
+        b.adjust(-margin, -margin, margin + 2.0, margin + 2.0);
+
+        // The needle is clipped to the face
+        sweep.bounds = b.intersected(g.face.adjusted(-1.0, -1.0, 1.0, 1.0));
+        return sweep;
+    }
+
+    const VUMeterSkin& skin = meterSkin(meter);
+    const QRect& opaque = isRightSide(meter) ? needleOpaqueRight_ : needleOpaqueLeft_;
+    if (opaque.isNull() || skin.face.isNull() || skin.needle.isNull()) {
+        return sweep;
+    }
+
+    // The needle pixmap is stretched over the meter rect on its own (it need not be the
+    // face's size), and rotates around the calibrated pivot, which is in face pixels
+    const qreal scaleX = rect.width() / skin.needle.width();
+    const qreal scaleY = rect.height() / skin.needle.height();
+    const QPointF pivot = skinPivot(rect, skin);
+
+    auto toWidget = [&](qreal x, qreal y) { return QPointF(rect.left() + x * scaleX, rect.top() + y * scaleY); };
+    const QList<QPointF> corners = {toWidget(opaque.left(), opaque.top()),
+                                    toWidget(opaque.right() + 1, opaque.top()),
+                                    toWidget(opaque.left(), opaque.bottom() + 1),
+                                    toWidget(opaque.right() + 1, opaque.bottom() + 1)};
+
+    for (const QPointF& c : corners) {
+        sweep.reach = std::max(sweep.reach, std::hypot(c.x() - pivot.x(), c.y() - pivot.y()));
+    }
+
+    // Smooth pixmap transforms bleed about a pixel beyond the source bounds
+    sweep.bounds = rotatedSweepBounds(pivot, corners, fromDeg, toDeg).adjusted(-2.0, -2.0, 2.0, 2.0);
+    return sweep;
+}
+
+bool StereoVUMeterWidget::invalidateNeedle(
+    const QRectF& rect, int meter, float fromVu, float toVu, QRegion* dirty) const {
+    const float fromDeg = needleAngleDeg(fromVu, meter);
+    const float toDeg = needleAngleDeg(toVu, meter);
+
+    // With the atlas the needle moves in whole sprites: repaint exactly when the sprite
+    // changes, over the full extent of the old and the new one
+    if (style_ == VUMeterStyle::Skin && meter < needleAtlases_.size() &&
+        needleAtlases_[meter].matches(rect, devicePixelRatio())) {
+        const NeedleSpriteAtlas& atlas = needleAtlases_[meter];
+        const int fromSprite = atlas.spriteIndex(fromDeg);
+        const int toSprite = atlas.spriteIndex(toDeg);
+        if (fromSprite == toSprite) {
+            return false;
+        }
+        *dirty += atlas.spriteBounds(fromSprite).toAlignedRect();
+        *dirty += atlas.spriteBounds(toSprite).toAlignedRect();
+        return true;
+    }
+
+    const NeedleSweep sweep = needleSweep(rect, meter, fromDeg, toDeg);
+    const qreal tipTravel = std::abs(toDeg - fromDeg) * (kPi / 180.0) * sweep.reach;
+    if (tipTravel < kNeedleRepaintThresholdPx) {
+        return false;
+    }
+
+    if (!sweep.bounds.isEmpty()) {
+        *dirty += sweep.bounds.toAlignedRect();
+    }
+    return true;
+}
+
+void StereoVUMeterWidget::updateNeedleBounds() {
+    needleOpaqueLeft_ = opaqueBounds(skin_.left.needle);
+    needleOpaqueRight_ = opaqueBounds(skin_.right.needle);
+}
+
+void StereoVUMeterWidget::changeEvent(QEvent* event) {
+    // Size, DPR and style are checked on every paint; a font change must be flagged explicitly.
+    if (event->type() == QEvent::FontChange) {
+        invalidateFaceLayers();
+        invalidateRenderScene();
+    }
+#if QT_VERSION >= QT_VERSION_CHECK(6, 6, 0)
+    // Moving to a screen with another DPR does not resize the widget
+    if (event->type() == QEvent::DevicePixelRatioChange && style_ == VUMeterStyle::Skin) {
+        scheduleSkinRebuild();
+    }
+#endif
+    QWidget::changeEvent(event);
+}
+
+StereoVUMeterWidget::MeterLayout StereoVUMeterWidget::computeLayout() const {
     const QRectF r = rect();
 
     // --- Common layout calculations (shared by all styles) ---
@@ -160,67 +640,446 @@ void StereoVUMeterWidget::paintEvent(QPaintEvent*) {
         aspect = qreal(skin_.single.face.width()) / qreal(skin_.single.face.height());
     }
 
-    const qreal gap =
-        (style_ == VUMeterStyle::Skin && skin_.isStereo) ? 0.0 : std::max<qreal>(16.0, inner.width() * 0.03);
+    // Stereo skins are drawn as abutting left/right pairs; the gap separates units
+    const int count = meterCount();
+    const int perUnit = (style_ == VUMeterStyle::Skin && skin_.isStereo && count > 1) ? 2 : 1;
+    const int units = (count + perUnit - 1) / perUnit;
+    const qreal unitAspect = aspect * perUnit;
+    const qreal gap = std::max<qreal>(16.0, inner.width() * 0.03);
+
+    // --- Grid with the largest meters ---
+    int columns = 1;
+    int rows = units;
+    qreal unitW = 0.0;
+    qreal unitH = 0.0;
+    for (int c = 1; c <= units; ++c) {
+        const int rw = (units + c - 1) / c;
+        qreal w = (inner.width() - gap * (c - 1)) / c;
+        qreal h = w / unitAspect;
+        const qreal maxH = (inner.height() - gap * (rw - 1)) / rw;
+        if (h > maxH) {
+            h = maxH;
+            w = h * unitAspect;
+        }
+        if (w > unitW) {
+            columns = c;
+            rows = rw;
+            unitW = w;
+            unitH = h;
+        }
+    }
 
-    qreal meterW = (inner.width() - gap) / 2.0;
-    qreal meterH = meterW / aspect;
+    qreal meterW = unitW / perUnit;
 
-    if (meterH > inner.height()) {
-        meterH = inner.height();
-        meterW = meterH * aspect;
+    // Skin meters sit on the device pixel grid, so their pre-scaled layers are blitted
+    // 1:1 and the faces of a stereo pair still abut exactly
+    const qreal dpr = devicePixelRatio();
+    const bool snap = style_ == VUMeterStyle::Skin && dpr > 0.0;
+    if (snap) {
+        meterW = std::floor(meterW * dpr) / dpr;
+        unitH = std::floor(unitH * dpr) / dpr;
+        unitW = meterW * perUnit;
     }
 
-    const qreal y = inner.center().y() - meterH / 2.0;
+    const qreal gridH = rows * unitH + (rows - 1) * gap;
+    const qreal y0 = inner.center().y() - gridH / 2.0;
+
+    MeterLayout layout;
+    layout.rects.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const int unit = i / perUnit;
+        qreal x = inner.left() + (unit % columns) * (unitW + gap);
+        qreal y = y0 + (unit / columns) * (unitH + gap);
+        if (snap) {
+            x = std::round(x * dpr) / dpr;
+            y = std::round(y * dpr) / dpr;
+        }
+        layout.rects.append(QRectF(x + (i % perUnit) * meterW, y, meterW, unitH));
+    }
+    return layout;
+}
 
-    const QRectF leftRect(inner.left(), y, meterW, meterH);
-    const QRectF rightRect(leftRect.right() + gap, y, meterW, meterH);
+StereoVUMeterWidget::MeterGeometry StereoVUMeterWidget::meterGeometry(const QRectF& rect) {
+    MeterGeometry g;
 
-    // --- Mode switch ---
-    if (style_ != VUMeterStyle::Skin) {
-        // All vector-drawn styles (Original, Sony, Vintage, Modern, Black)
+    // --- Frame ---
+    g.frameRadius = std::min(rect.width(), rect.height()) * 0.06;
+
+    // --- Face ---
+    const qreal inset = std::max<qreal>(10.0, rect.width() * 0.04);
+    g.face = rect.adjusted(inset, inset, -inset, -inset);
+    g.faceRadius = g.frameRadius * 0.75;
+
+    // --- Needle geometry ---
+    g.pivot = QPointF(g.face.center().x(), g.face.bottom() + g.face.height() * 0.35);
+    g.radius = std::min(g.face.width(), g.face.height()) * 1.00;
+
+    return g;
+}
+
+void StereoVUMeterWidget::ensureFaceLayers(const MeterLayout& layout) {
+    const QSize logicalSize = size();
+    const qreal dpr = devicePixelRatio();
 
-        // Background gradient
+    if (faceLayersValid_ && faceLayerSize_ == logicalSize && qFuzzyCompare(faceLayerDpr_, dpr) &&
+        faceLayerStyle_ == style_) {
+        return;
+    }
+
+    const QSize pixelSize = (QSizeF(logicalSize) * dpr).toSize();
+
+    // Point-sized fonts resolve against the paint device's DPI, so the layers must
+    // report the same logical DPI as the widget or labels would change size.
+    const int dpmX = qRound(logicalDpiX() / 0.0254);
+    const int dpmY = qRound(logicalDpiY() / 0.0254);
+
+    // --- Underlay: background + frame + face (fully opaque) ---
+    faceUnderlay_ = QImage(pixelSize, QImage::Format_RGB32);
+    faceUnderlay_.setDevicePixelRatio(dpr);
+    faceUnderlay_.setDotsPerMeterX(dpmX);
+    faceUnderlay_.setDotsPerMeterY(dpmY);
+    {
+        QPainter lp(&faceUnderlay_);
+        lp.setRenderHint(QPainter::Antialiasing, true);
+
+        const QRectF r(QPointF(0, 0), QSizeF(logicalSize));
         QLinearGradient bg(r.topLeft(), r.bottomRight());
         bg.setColorAt(0.0, QColor(20, 20, 22));
         bg.setColorAt(1.0, QColor(6, 6, 7));
-        p.fillRect(r, bg);
+        lp.fillRect(r, bg);
+
+        for (const QRectF& meterRect : layout.rects) {
+            drawMeterUnderlay(lp, meterRect);
+        }
+    }
 
-        // Vector-drawn meters
-        drawMeter(p, leftRect, left_);
-        drawMeter(p, rightRect, right_);
+    // --- Overlay: everything drawn on top of the needle (transparent) ---
+    faceOverlay_ = QImage(pixelSize, QImage::Format_ARGB32_Premultiplied);
+    faceOverlay_.setDevicePixelRatio(dpr);
+    faceOverlay_.setDotsPerMeterX(dpmX);
+    faceOverlay_.setDotsPerMeterY(dpmY);
+    faceOverlay_.fill(Qt::transparent);
+    {
+        QPainter lp(&faceOverlay_);
+        lp.setRenderHint(QPainter::Antialiasing, true);
+        lp.setRenderHint(QPainter::TextAntialiasing, true);
+        lp.setFont(font());
+
+        for (const QRectF& meterRect : layout.rects) {
+            drawMeterOverlay(lp, meterRect);
+        }
+    }
+
+    faceLayerSize_ = logicalSize;
+    faceLayerDpr_ = dpr;
+    faceLayerStyle_ = style_;
+    faceLayersValid_ = true;
+}
+
+void StereoVUMeterWidget::paintEvent(QPaintEvent*) {
+    if (glViewActive()) {
+        return; // the GL child covers the widget
+    }
+
+    const std::int64_t paintStartNs = PerfCounters::enabled() ? PerfCounters::nowNs() : 0;
+
+    QPainter p(this);
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.setRenderHint(QPainter::TextAntialiasing, true);
+
+    const QRectF r = rect();
+    const MeterLayout layout = computeLayout();
+    const int count = layout.rects.size();
+
+    if (renderThreadActive()) {
+        ensureRenderScene();
+    }
+
+    // --- Mode switch ---
+    if (renderThreadActive() && renderThread_->present(p)) {
+        // Composed on the render thread; only the blit happens here
+    } else if (style_ != VUMeterStyle::Skin) {
+        // All vector-drawn styles (Original, Sony, Vintage, Modern, Black)
+        // Static parts come from the cached layers; only the needles are drawn per frame.
+        ensureFaceLayers(layout);
+
+        p.drawImage(QPointF(0, 0), faceUnderlay_);
+
+        for (int i = 0; i < count; ++i) {
+            drawNeedle(p, layout.rects[i], levels_[i]);
+        }
+
+        p.drawImage(QPointF(0, 0), faceOverlay_);
     } else {
         // --- Skin mode ---
         p.fillRect(r, Qt::black);
 
+        // Scaled layers and sprites are only valid for the rects/DPR they were rendered at
+        const qreal dpr = devicePixelRatio();
+        bool layersCurrent = true;
+        for (int i = 0; layersCurrent && i < count; ++i) {
+            layersCurrent = skinLayers(i).matches(layout.rects[i].size(), dpr);
+        }
+        bool atlasesCurrent = needleAtlases_.size() == count;
+        for (int i = 0; atlasesCurrent && i < count; ++i) {
+            atlasesCurrent = needleAtlases_[i].matches(layout.rects[i], dpr);
+        }
+        if (!layersCurrent || (needleAtlasStepDeg_ > 0.0f && !atlasesCurrent)) {
+            ensureSkinRebuildScheduled();
+        }
+
         // Draw face images
-        p.drawPixmap(leftRect, skin_.left.face, skin_.left.face.rect());
-        p.drawPixmap(rightRect, skin_.right.face, skin_.right.face.rect());
+        for (int i = 0; i < count; ++i) {
+            const ScaledSkinLayers& layers = skinLayers(i);
+            if (layers.matches(layout.rects[i].size(), dpr)) {
+                p.drawPixmap(layers.targetRect(layout.rects[i]).topLeft(), layers.face());
+            } else {
+                const QPixmap& face = meterSkin(i).face;
+                p.drawPixmap(layout.rects[i], face, face.rect());
+            }
+        }
 
         // Draw needles + caps
-        drawMeterImageOnly(p, leftRect, left_, skin_.left, leftScaleTable_);
-        drawMeterImageOnly(p, rightRect, right_, skin_.right, rightScaleTable_);
+        static const NeedleSpriteAtlas kNoAtlas;
+        for (int i = 0; i < count; ++i) {
+            const NeedleSpriteAtlas& atlas = (i < needleAtlases_.size()) ? needleAtlases_[i] : kNoAtlas;
+            drawMeterImageOnly(
+                p, layout.rects[i], levels_[i], meterSkin(i), meterScale(i), skinLayers(i), atlas);
+        }
+    }
+
+    if (perfHudTimer_) {
+        drawPerfHud(p);
+    }
+
+    if (!firstFramePainted_) {
+        firstFramePainted_ = true;
+        StartupTrace::mark("first frame");
+    }
+
+    if (paintStartNs > 0) {
+        const std::int64_t endNs = PerfCounters::nowNs();
+        PerfCounters::record(PerfCounters::Histogram::Paint, endNs - paintStartNs);
+        PerfCounters::increment(PerfCounters::Counter::Paints);
+        PerfCounters::framePresented(endNs);
+    }
+}
+
+static QFont perfHudFont() {
+    QFont font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    font.setPointSizeF(9.0);
+    return font;
+}
+
+void StereoVUMeterWidget::setPerfHudVisible(bool visible) {
+    if (visible == perfHudVisible()) {
+        return;
+    }
+
+    if (visible) {
+        perfHudTimer_ = new QTimer(this);
+        perfHudTimer_->setInterval(500);
+        connect(perfHudTimer_, &QTimer::timeout, this, &StereoVUMeterWidget::refreshPerfHud);
+        perfHudBefore_ = PerfCounters::snapshot();
+        perfHudLines_ = QStringList{QStringLiteral("collecting...")};
+        perfHudTimer_->start();
+    } else {
+        delete perfHudTimer_;
+        perfHudTimer_ = nullptr;
+        perfHudLines_.clear();
+    }
+    update();
+}
+
+void StereoVUMeterWidget::refreshPerfHud() {
+    const PerfCounters::Snapshot now = PerfCounters::snapshot();
+    const QRect before = perfHudRect();
+    perfHudLines_ = PerfCounters::summaryLines(now, perfHudBefore_);
+    perfHudBefore_ = now;
+    update(before.united(perfHudRect()));
+}
+
+QRect StereoVUMeterWidget::perfHudRect() const {
+    const QFontMetrics fm(perfHudFont());
+    int width = 0;
+    for (const QString& line : perfHudLines_) {
+        width = std::max(width, fm.horizontalAdvance(line));
+    }
+    return QRect(6, 6, width + 12, fm.lineSpacing() * static_cast<int>(perfHudLines_.size()) + 8);
+}
+
+void StereoVUMeterWidget::drawPerfHud(QPainter& p) const {
+    const QRect box = perfHudRect();
+    const QFont font = perfHudFont();
+    const QFontMetrics fm(font);
+
+    p.save();
+    p.fillRect(box, QColor(0, 0, 0, 170));
+    p.setFont(font);
+    p.setPen(QColor(120, 255, 140));
+    int y = box.top() + 4 + fm.ascent();
+    for (const QString& line : perfHudLines_) {
+        p.drawText(box.left() + 6, y, line);
+        y += fm.lineSpacing();
+    }
+    p.restore();
+}
+
+void StereoVUMeterWidget::setThreadedRendering(bool enabled) {
+    if (enabled == threadedRendering()) {
+        return;
+    }
+
+    if (enabled) {
+        renderThread_ = new MeterRenderThread(this);
+        connect(renderThread_, &MeterRenderThread::frameReady, this, &StereoVUMeterWidget::onRenderFrameReady);
+        renderThread_->start();
+    } else {
+        delete renderThread_; // joins the thread
+        renderThread_ = nullptr;
+        renderDirty_ = QRegion();
+    }
+    invalidateRenderScene();
+    update();
+}
+
+int StereoVUMeterWidget::needleAngles(float* anglesDeg) const {
+    const int count = meterCount();
+    for (int i = 0; i < count; ++i) {
+        anglesDeg[i] = needleAngleDeg(levels_[i], i);
+    }
+    return count;
+}
+
+void StereoVUMeterWidget::ensureRenderScene() {
+    const qreal dpr = devicePixelRatio();
+    const QSize pixelSize = (QSizeF(size()) * dpr).toSize();
+    if (pixelSize.isEmpty() ||
+        (renderSceneValid_ && renderScenePixelSize_ == pixelSize && qFuzzyCompare(renderSceneDpr_, dpr))) {
+        return;
+    }
+
+    auto scene = std::make_shared<MeterRenderScene>();
+    scene->pixelSize = pixelSize;
+    scene->dpr = dpr;
+
+    const MeterLayout layout = computeLayout();
+    const int count = layout.rects.size();
+
+    if (style_ != VUMeterStyle::Skin) {
+        ensureFaceLayers(layout);
+        scene->background = faceUnderlay_;
+        scene->foreground = faceOverlay_;
+        for (const QRectF& rect : layout.rects) {
+            scene->vectorNeedles.append(vectorNeedle(rect));
+        }
+    } else {
+        // Faces and caps are composited once here instead of on every frame
+        QImage background(pixelSize, QImage::Format_RGB32);
+        background.setDevicePixelRatio(dpr);
+        background.fill(Qt::black);
+        QImage foreground(pixelSize, QImage::Format_ARGB32_Premultiplied);
+        foreground.setDevicePixelRatio(dpr);
+        foreground.fill(Qt::transparent);
+
+        bool layersCurrent = true;
+        int atlasesCurrent = 0;
+        {
+            QPainter bp(&background);
+            QPainter fp(&foreground);
+            bp.setRenderHint(QPainter::Antialiasing, true);
+            fp.setRenderHint(QPainter::Antialiasing, true);
+
+            for (int i = 0; i < count; ++i) {
+                const QRectF& rect = layout.rects[i];
+                const VUMeterSkin& skin = meterSkin(i);
+                const ScaledSkinLayers& layers = skinLayers(i);
+
+                MeterRenderScene::SkinNeedle needle;
+                needle.pivot = skinPivot(rect, skin);
+                if (layers.matches(rect.size(), dpr)) {
+                    needle.target = layers.targetRect(rect);
+                    needle.image = layers.needle().toImage();
+                    bp.drawPixmap(needle.target.topLeft(), layers.face());
+                    fp.drawPixmap(needle.target.topLeft(), layers.cap());
+                } else {
+                    layersCurrent = false;
+                    needle.target = rect;
+                    needle.image = skin.needle.toImage();
+                    bp.drawPixmap(rect, skin.face, skin.face.rect());
+                    fp.drawPixmap(rect, skin.cap, skin.cap.rect());
+                }
+                if (i < needleAtlases_.size() && needleAtlases_[i].matches(rect, dpr)) {
+                    needle.atlas = needleAtlases_[i];
+                    ++atlasesCurrent;
+                }
+                scene->skinNeedles.append(needle);
+            }
+        }
+        scene->background = background;
+        scene->foreground = foreground;
+
+        if (!layersCurrent || (needleAtlasStepDeg_ > 0.0f && atlasesCurrent < count)) {
+            ensureSkinRebuildScheduled();
+        }
+    }
+
+    float angles[kMaxMeters];
+    const int n = needleAngles(angles);
+    renderSubmitted_ = renderThread_->setScene(std::move(scene), angles, n);
+
+    renderScenePixelSize_ = pixelSize;
+    renderSceneDpr_ = dpr;
+    renderSceneValid_ = true;
+}
+
+void StereoVUMeterWidget::submitRenderFrame(const QRegion& dirty) {
+    ensureRenderScene();
+
+    float angles[kMaxMeters];
+    const int n = needleAngles(angles);
+    renderSubmitted_ = renderThread_->submit(angles, n);
+    renderDirty_ += dirty;
+}
+
+void StereoVUMeterWidget::onRenderFrameReady() {
+    // The first frame of a new scene has no dirty region of its own
+    if (renderDirty_.isEmpty()) {
+        update();
+        return;
+    }
+
+    // Areas of frames still being composed stay dirty for the next one
+    update(renderDirty_);
+    if (renderThread_->completedSerial() >= renderSubmitted_) {
+        renderDirty_ = QRegion();
     }
 }
 
 void StereoVUMeterWidget::drawMeterImageOnly(QPainter& p,
                                              const QRectF& rect,
                                              float vuDb,
-                                             VUMeterSkin& skin,
-                                             const VUMeterScaleTable& scaleTable) {
+                                             const VUMeterSkin& skin,
+                                             const VUMeterScaleLut& scale,
+                                             const ScaledSkinLayers& layers,
+                                             const NeedleSpriteAtlas& atlas) {
     p.save();
 
     // --- Compute pivot in widget coordinates ---
-    const qreal scaleX = rect.width() / skin.face.width();
-    const qreal scaleY = rect.height() / skin.face.height();
-
-    const QPointF pivot(rect.left() + skin.calib.pivotX * scaleX, rect.top() + skin.calib.pivotY * scaleY);
+    const QPointF pivot = skinPivot(rect, skin);
 
     // --- Compute rotation angle ---
-    const float angleDeg = vuToAngleDeg(vuDb, scaleTable);
+    const float angleDeg = scale.angleDeg(vuDb);
 
-    // --- Rotate ONLY the needle ---
-    {
+    const qreal dpr = p.device()->devicePixelRatio();
+    const NeedleSpriteAtlas::Sprite* sprite = atlas.matches(rect, dpr) ? atlas.spriteFor(angleDeg) : nullptr;
+    const bool scaled = layers.matches(rect.size(), dpr);
+
+    if (sprite) {
+        // --- Pre-rotated sprite: plain blit ---
+        p.drawImage(sprite->position, sprite->image);
+    } else {
+        // --- Rotate ONLY the needle ---
         p.save();
 
         // Rotate around pivot
@@ -229,26 +1088,33 @@ void StereoVUMeterWidget::drawMeterImageOnly(QPainter& p,
         p.translate(-pivot);
 
         // Draw needle exactly as before (same rect)
-        p.drawPixmap(rect, skin.needle, skin.needle.rect());
+        if (scaled) {
+            p.drawPixmap(layers.targetRect(rect).topLeft(), layers.needle());
+        } else {
+            p.drawPixmap(rect, skin.needle, skin.needle.rect());
+        }
 
         p.restore(); // <-- restores painter so cap is NOT rotated
     }
 
     // --- Draw cap overlay (no rotation) ---
-    p.drawPixmap(rect, skin.cap, skin.cap.rect());
+    if (scaled) {
+        p.drawPixmap(layers.targetRect(rect).topLeft(), layers.cap());
+    } else {
+        p.drawPixmap(rect, skin.cap, skin.cap.rect());
+    }
 
     p.restore();
 }
 
-void StereoVUMeterWidget::drawMeter(QPainter& p, const QRectF& rect, float vuDb) {
+void StereoVUMeterWidget::drawMeterUnderlay(QPainter& p, const QRectF& rect) const {
     p.save();
-    
+
     // Get style-dependent parameters
     const StyleParams sp = getStyleParams();
+    const MeterGeometry g = meterGeometry(rect);
 
     // --- Frame ---
-    const qreal frameRadius = std::min(rect.width(), rect.height()) * 0.06;
-
     QLinearGradient frameGrad(rect.topLeft(), rect.bottomRight());
     frameGrad.setColorAt(0.0, QColor(60, 62, 66));
     frameGrad.setColorAt(0.5, QColor(26, 27, 29));
@@ -256,61 +1122,57 @@ void StereoVUMeterWidget::drawMeter(QPainter& p, const QRectF& rect, float vuDb)
 
     p.setPen(QPen(QColor(0, 0, 0, 160), 2.0));
     p.setBrush(frameGrad);
-    p.drawRoundedRect(rect, frameRadius, frameRadius);
+    p.drawRoundedRect(rect, g.frameRadius, g.frameRadius);
 
     // --- Face ---
-    const qreal inset = std::max<qreal>(10.0, rect.width() * 0.04);
-    const QRectF face = rect.adjusted(inset, inset, -inset, -inset);
-    const qreal faceRadius = frameRadius * 0.75;
-
-    QLinearGradient faceGrad(face.topLeft(), face.bottomLeft());
+    QLinearGradient faceGrad(g.face.topLeft(), g.face.bottomLeft());
     faceGrad.setColorAt(0.0, sp.faceColorTop);
     faceGrad.setColorAt(1.0, sp.faceColorBottom);
 
     p.setPen(QPen(QColor(0, 0, 0, 90), 1.5));
     p.setBrush(faceGrad);
-    p.drawRoundedRect(face, faceRadius, faceRadius);
+    p.drawRoundedRect(g.face, g.faceRadius, g.faceRadius);
 
-    // --- Geometry ---
-    const QPointF pivot(face.center().x(), face.bottom() + face.height() * 0.35);
-    const qreal radius = std::min(face.width(), face.height()) * 1.00;
+    p.restore();
+}
 
-    const float theta = vuToAngleDeg(vuDb, singleScaleTable_);
+MeterRenderScene::VectorNeedle StereoVUMeterWidget::vectorNeedle(const QRectF& rect) const {
+    const MeterGeometry g = meterGeometry(rect);
 
-    // --- Draw needle with clipping to face area ---
-    // This makes the needle visible only within the face, hiding the pivot area
-    {
-        p.save();
-        
-        // Create clipping path for the face (rounded rectangle)
-        QPainterPath clipPath;
-        clipPath.addRoundedRect(face, faceRadius, faceRadius);
-        p.setClipPath(clipPath);
-        
-        // --- Needle shadow ---
-        const QPointF needleTip = polarFromBottomPivot(pivot, radius * 0.98, theta);
-        const QPointF shadowTip = needleTip + QPointF(2.0, 2.0);
-
-        // For Black style, use lighter shadow; for others, dark shadow
-        QColor shadowColor = (style_ == VUMeterStyle::Black) ? QColor(0, 0, 0, 120) : QColor(0, 0, 0, 80);
-        p.setPen(QPen(shadowColor, std::max<qreal>(3.0, rect.width() * 0.008), Qt::SolidLine, Qt::RoundCap));
-        p.drawLine(pivot + QPointF(2.0, 2.0), shadowTip);
-
-        // --- Needle ---
-        // For Black style, use white needle; for others, black needle
-        QColor needleColor = (style_ == VUMeterStyle::Black) ? QColor(235, 235, 240) : QColor(10, 10, 10);
-        p.setPen(QPen(needleColor, std::max<qreal>(3.0, rect.width() * 0.008), Qt::SolidLine, Qt::RoundCap));
-        p.drawLine(pivot, needleTip);
-        
-        p.restore();  // Restore clipping
-    }
+    MeterRenderScene::VectorNeedle needle;
+    needle.face = g.face;
+    needle.faceRadius = g.faceRadius;
+    needle.pivot = g.pivot;
+    needle.length = g.radius * 0.98;
+    needle.width = std::max<qreal>(3.0, rect.width() * 0.008);
+
+    // For Black style, a white needle with a lighter shadow; for others, black on dark
+    needle.color = (style_ == VUMeterStyle::Black) ? QColor(235, 235, 240) : QColor(10, 10, 10);
+    needle.shadowColor = (style_ == VUMeterStyle::Black) ? QColor(0, 0, 0, 120) : QColor(0, 0, 0, 80);
+    return needle;
+}
+
+void StereoVUMeterWidget::drawNeedle(QPainter& p, const QRectF& rect, float vuDb) const {
+    MeterRenderScene::drawNeedle(p, vectorNeedle(rect), singleScale_.angleDeg(vuDb));
+}
+
+void StereoVUMeterWidget::drawMeterOverlay(QPainter& p, const QRectF& rect) const {
+    p.save();
+
+    // Get style-dependent parameters
+    const StyleParams sp = getStyleParams();
+    const MeterGeometry g = meterGeometry(rect);
+
+    const QRectF& face = g.face;
+    const QPointF& pivot = g.pivot;
+    const qreal radius = g.radius;
 
     // --- Bezel (drawn after needle so it appears on top) ---
     const qreal bezelInset = std::max<qreal>(6.0, rect.width() * 0.02);
     const QRectF bezel = rect.adjusted(bezelInset, bezelInset, -bezelInset, -bezelInset);
     p.setPen(QPen(QColor(0, 0, 0, 45), 1.0));
     p.setBrush(Qt::NoBrush);
-    p.drawRoundedRect(bezel, frameRadius * 0.85, frameRadius * 0.85);
+    p.drawRoundedRect(bezel, g.frameRadius * 0.85, g.frameRadius * 0.85);
 
     // --- Tick radii ---
     const qreal tickR1 = radius * 0.98;
@@ -336,8 +1198,8 @@ void StereoVUMeterWidget::drawMeter(QPainter& p, const QRectF& rect, float vuDb)
 
     // Scale angles
     const float aMin = -48.0f;
-    const float a0 = vuToAngleDeg(0.0f, singleScaleTable_); // +18°
-    const float a3 = vuToAngleDeg(3.0f, singleScaleTable_); // +47°
+    const float a0 = singleScale_.angleDeg(0.0f); // +18°
+    const float a3 = singleScale_.angleDeg(3.0f); // +47°
 
     auto arcStart = [](float logicalEndDeg) { return int((90.0f - logicalEndDeg) * 16.0f); };
     auto arcSpan = [](float logicalStartDeg, float logicalEndDeg) {
@@ -358,7 +1220,7 @@ void StereoVUMeterWidget::drawMeter(QPainter& p, const QRectF& rect, float vuDb)
         bool major = (v == -20.0f || v == -10.0f || v == -7.0f || v == -5.0f || v == -3.0f || v == -2.0f ||
                       v == -1.0f || v == 0.0f || v == 1.0f || v == 2.0f || v == 3.0f);
 
-        const float a = vuToAngleDeg(v, singleScaleTable_);
+        const float a = singleScale_.angleDeg(v);
 
         const QPointF p1 = polarFromBottomPivot(pivot, tickR1, a);
         const QPointF p2 = polarFromBottomPivot(pivot, major ? tickR2Major : tickR2Minor, a);
@@ -432,10 +1294,12 @@ void StereoVUMeterWidget::drawMeter(QPainter& p, const QRectF& rect, float vuDb)
     }
 
     // --- SONY logo for Sony style ---
-    if (style_ == VUMeterStyle::Sony && !sonyFontFamily_.isEmpty()) {
+    // Waits for the background registration if it has not finished yet
+    const QString logoFamily = style_ == VUMeterStyle::Sony ? logoFontFamily() : QString();
+    if (!logoFamily.isEmpty()) {
         p.save();
         
-        QFont sonyFont(sonyFontFamily_);
+        QFont sonyFont(logoFamily);
         sonyFont.setPointSizeF(rect.height() * 0.075);  // Adjust size as needed
         sonyFont.setBold(false);
         p.setFont(sonyFont);
@@ -457,9 +1321,6 @@ void StereoVUMeterWidget::drawMeter(QPainter& p, const QRectF& rect, float vuDb)
         p.restore();
     }
 
-    // --- Pivot cap (no longer needed since needle is clipped, but keep the line) ---
-    const qreal capR = std::max<qreal>(10.0, rect.width() * 0.04);
-
     p.restore();
 }
 
@@ -469,9 +1330,17 @@ void StereoVUMeterWidget::loadDefaultSkin() {
 
     VUMeterSkin s;
 
-    s.face.load(":/images/model_702w/0.png");
-    s.needle.load(":/images/model_702w/1.png");
-    s.cap.load(":/images/model_702w/2.png");
+    defaultSkinPreview_ = !defaultSkinDecoded.load(std::memory_order_acquire);
+    if (defaultSkinPreview_) {
+        s.face.load(":/images/model_702w/preview/0.png");
+        s.needle.load(":/images/model_702w/preview/1.png");
+        s.cap.load(":/images/model_702w/preview/2.png");
+    } else {
+        const DefaultSkinImages& images = defaultSkinImages();
+        s.face = QPixmap::fromImage(images.face);
+        s.needle = QPixmap::fromImage(images.needle);
+        s.cap = QPixmap::fromImage(images.cap);
+    }
 
     s.calib.minAngle = -47;
     s.calib.minLevel = -20;
@@ -480,8 +1349,10 @@ void StereoVUMeterWidget::loadDefaultSkin() {
     s.calib.maxAngle = 47;
     s.calib.maxLevel = 3;
 
-    s.calib.pivotX = 310;
-    s.calib.pivotY = 362;
+    // The pivot is in face pixels
+    const int pivotScale = defaultSkinPreview_ ? kDefaultSkinPreviewScale : 1;
+    s.calib.pivotX = 310 / pivotScale;
+    s.calib.pivotY = 362 / pivotScale;
 
     s.calib.mobilityNeg = 0.05;
     s.calib.mobilityPos = 0.10;
@@ -493,7 +1364,9 @@ void StereoVUMeterWidget::loadDefaultSkin() {
     skin_.left = s;
     skin_.right = s;
 
-    singleScaleTable_ = builtInDefaultScaleTable();
-    leftScaleTable_ = singleScaleTable_;
-    rightScaleTable_ = singleScaleTable_;
+    singleScale_ = VUMeterScaleLut(builtInDefaultScaleTable());
+    leftScale_ = singleScale_;
+    rightScale_ = singleScale_;
+
+    updateNeedleBounds();
 }
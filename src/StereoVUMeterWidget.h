@@ -1,15 +1,29 @@
 #pragma once
 
 #include <QFont>
+#include <QImage>
+#include <QRect>
+#include <QRegion>
+#include <QVector>
 #include <QWidget>
 
+#include <cstdint>
+#include <memory>
+
+#include "MeterRenderThread.h"
+#include "NeedleSpriteAtlas.h"
+#include "PerfCounters.h"
+#include "ScaledSkinLayers.h"
 #include "VUMeterScale.h"
 #include "VUMeterSkin.h"
 
 class QPaintEvent;
 class QPainter;
 class QRectF;
+class QResizeEvent;
 class QString;
+class QTimer;
+class VUMeterGLWidget;
 
 // VU Meter visual styles
 enum class VUMeterStyle {
@@ -21,12 +35,29 @@ enum class VUMeterStyle {
     Skin      // Image based graphics
 };
 
+// How the meter is drawn
+enum class VUMeterRenderBackend {
+    Raster, // QPainter on the widget (always available)
+    OpenGL  // Textured quads via QOpenGLWidget; Skin mode only, vector styles stay on QPainter
+};
+
+// Meter bridge: a stereo pair by default, or one meter per channel laid out in a
+// grid (stereo skins keep their left/right faces together as pairs). All meters
+// are drawn in a single paint pass.
 class StereoVUMeterWidget final : public QWidget {
     Q_OBJECT
 
   public:
+    static constexpr int kMaxMeters = 64;
+
     explicit StereoVUMeterWidget(QWidget* parent = nullptr);
+
+    void setMeterCount(int count);
+    int meterCount() const { return static_cast<int>(levels_.size()); }
+
     void setLevels(float leftVuDb, float rightVuDb);
+    // Levels of the first `count` meters (extra values are ignored)
+    void setLevels(const float* vuDb, int count);
     void setStyle(VUMeterStyle style);
     VUMeterStyle style() const { return style_; }
 
@@ -37,21 +68,168 @@ class StereoVUMeterWidget final : public QWidget {
                         const VUMeterScaleTable& leftScale,
                         const VUMeterScaleTable& rightScale);
 
+    // Angular resolution (degrees) of the pre-rotated skin needle sprites.
+    // Smaller steps look smoother but cost more memory; 0 disables the atlas.
+    void setNeedleAtlasStep(float degrees);
+    float needleAtlasStep() const { return needleAtlasStepDeg_; }
+
+    void setRenderBackend(VUMeterRenderBackend backend);
+    VUMeterRenderBackend renderBackend() const { return renderBackend_; }
+    static bool isRenderBackendAvailable(VUMeterRenderBackend backend);
+
+    // Timing overlay in the top-left corner (see PerfCounters, which must be enabled
+    // for it to show anything). Raster renderer only: the GL view covers it.
+    void setPerfHudVisible(bool visible);
+    bool perfHudVisible() const { return perfHudTimer_ != nullptr; }
+
+    // Compose frames on a MeterRenderThread; paintEvent() then only blits the newest
+    // one. Raster renderer only (the GL view draws on its own).
+    void setThreadedRendering(bool enabled);
+    bool threadedRendering() const { return renderThread_ != nullptr; }
+
   protected:
     void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void changeEvent(QEvent* event) override;
 
   private:
-    float left_ = -20.0f;
-    float right_ = -20.0f;
+    QVector<float> levels_{-20.0f, -20.0f};
     VUMeterStyle style_ = VUMeterStyle::Skin;
-    QString sonyFontFamily_; // Font family name for SONY logo
+    bool firstFramePainted_ = false; // for --startup-trace
+
+    // Widget-space rectangle of every meter for the current size/style/count
+    struct MeterLayout {
+        QVector<QRectF> rects;
+    };
+
+    // Geometry of a single vector-drawn meter, shared by the static layers and the needle
+    struct MeterGeometry {
+        qreal frameRadius;
+        QRectF face;
+        qreal faceRadius;
+        QPointF pivot;
+        qreal radius;
+    };
 
-    //QPixmap meterFace_;
-    void drawMeterImageOnly(QPainter& p, const QRectF& rect, float vuDb, VUMeterSkin& skin, const VUMeterScaleTable& scaleTable);
-    void drawMeter(QPainter& p, const QRectF& rect, float vuDb);
-    VUMeterScaleTable singleScaleTable_;
-    VUMeterScaleTable leftScaleTable_;
-    VUMeterScaleTable rightScaleTable_;
+    MeterLayout computeLayout() const;
+    static MeterGeometry meterGeometry(const QRectF& rect);
+
+    // Odd meters use the right-channel images and scale of the skin
+    static bool isRightSide(int meter) { return (meter % 2) == 1; }
+    const VUMeterSkin& meterSkin(int meter) const { return isRightSide(meter) ? skin_.right : skin_.left; }
+    const VUMeterScaleLut& meterScale(int meter) const { return isRightSide(meter) ? rightScale_ : leftScale_; }
+
+    void drawMeterImageOnly(QPainter& p,
+                            const QRectF& rect,
+                            float vuDb,
+                            const VUMeterSkin& skin,
+                            const VUMeterScaleLut& scale,
+                            const ScaledSkinLayers& layers,
+                            const NeedleSpriteAtlas& atlas);
+    void drawMeterUnderlay(QPainter& p, const QRectF& rect) const;
+    void drawMeterOverlay(QPainter& p, const QRectF& rect) const;
+    void drawNeedle(QPainter& p, const QRectF& rect, float vuDb) const;
+    MeterRenderScene::VectorNeedle vectorNeedle(const QRectF& rect) const;
+
+    // --- Partial repaints ---
+    // setLevels() only invalidates the area swept by each needle between its
+    // painted and new angle; sub-pixel movements are not repainted at all.
+    struct NeedleSweep {
+        QRectF bounds; // widget-space area covered by the needle over the sweep
+        qreal reach;   // distance from pivot to the farthest needle pixel
+    };
+
+    float needleAngleDeg(float vuDb, int meter) const;
+    NeedleSweep needleSweep(const QRectF& rect, int meter, float fromDeg, float toDeg) const;
+    bool invalidateNeedle(const QRectF& rect, int meter, float fromVu, float toVu, QRegion* dirty) const;
+    void updateNeedleBounds();
+
+    // Opaque part of each skin needle image (skin pixel coordinates)
+    QRect needleOpaqueLeft_;
+    QRect needleOpaqueRight_;
+
+    // --- Pre-scaled skin layers (Skin mode) ---
+    // Face, needle and cap of the left and right skin meters at the current meter
+    // size and DPR, so a frame never resamples the skin images. Meters of the same
+    // side share one entry. After a resize or DPR change the full-size images are
+    // drawn scaled until the debounced rebuild has run.
+    void rebuildSkinLayers();
+    const ScaledSkinLayers& skinLayers(int meter) const { return skinLayers_[isRightSide(meter) ? 1 : 0]; }
+
+    ScaledSkinLayers skinLayers_[2];
+
+    // --- Needle sprite atlas (Skin mode) ---
+    // One atlas per meter, built for its rect and DPR; after a resize the direct
+    // rotate path is used until the debounced rebuild has run.
+    void rebuildNeedleAtlases();
+
+    QVector<NeedleSpriteAtlas> needleAtlases_;
+    float needleAtlasStepDeg_ = 0.0f;
+
+    // Debounces both rebuilds during interactive resizes (and DPR changes).
+    // Paints that find stale layers only make sure a rebuild is pending.
+    void scheduleSkinRebuild();
+    void ensureSkinRebuildScheduled();
+    QTimer* skinRebuildTimer_ = nullptr;
+
+    // --- Performance overlay ---
+    // The text is refreshed twice a second from a windowed PerfCounters snapshot;
+    // only the overlay's own rect is repainted for it.
+    void refreshPerfHud();
+    void drawPerfHud(QPainter& p) const;
+    QRect perfHudRect() const;
+
+    QTimer* perfHudTimer_ = nullptr;
+    PerfCounters::Snapshot perfHudBefore_;
+    QStringList perfHudLines_;
+
+    // --- Render thread ---
+    // The scene is rebuilt from the cached layers on the first frame after anything
+    // but the levels changed. Dirty regions of submitted frames are collected until
+    // the thread has completed the newest one, then repainted (a blit) in one go.
+    bool renderThreadActive() const { return renderThread_ && !glViewActive(); }
+    void invalidateRenderScene() { renderSceneValid_ = false; }
+    void ensureRenderScene();
+    void submitRenderFrame(const QRegion& dirty);
+    void onRenderFrameReady();
+    int needleAngles(float* anglesDeg) const; // one per meter, returns the count
+
+    MeterRenderThread* renderThread_ = nullptr;
+    bool renderSceneValid_ = false;
+    QSize renderScenePixelSize_;
+    qreal renderSceneDpr_ = 0.0;
+    QRegion renderDirty_;
+    std::uint64_t renderSubmitted_ = 0;
+
+    // --- GPU backend ---
+    // While active, the GL child covers the whole widget and paintEvent() does nothing.
+    bool glViewActive() const;
+    void updateGlView();
+    void syncGlView();
+
+    VUMeterRenderBackend renderBackend_ = VUMeterRenderBackend::Raster;
+    VUMeterGLWidget* glView_ = nullptr;
+
+    // --- Cached static face layers (vector styles) ---
+    // Everything except the needle is rendered once into two device-pixel images:
+    // the underlay (background, frame, face) sits below the needle and the
+    // overlay (bezel, arcs, ticks, labels, legends, logo) is composited on top.
+    // Both are rebuilt only when the size, device pixel ratio, style, scale or meter
+    // count changes.
+    void ensureFaceLayers(const MeterLayout& layout);
+    void invalidateFaceLayers() { faceLayersValid_ = false; }
+
+    QImage faceUnderlay_;
+    QImage faceOverlay_;
+    QSize faceLayerSize_;
+    qreal faceLayerDpr_ = 0.0;
+    VUMeterStyle faceLayerStyle_ = VUMeterStyle::Skin;
+    bool faceLayersValid_ = false;
+
+    // Compiled from the skin's (or the built-in) scale tables; vector styles use singleScale_
+    VUMeterScaleLut singleScale_;
+    VUMeterScaleLut leftScale_;
+    VUMeterScaleLut rightScale_;
 
     // Style-dependent parameters
     struct StyleParams {
@@ -69,4 +247,8 @@ class StereoVUMeterWidget final : public QWidget {
 
     VUSkinPackage skin_;
     void loadDefaultSkin();
+
+    // The default skin is shown from its preview images until the full-size ones are decoded
+    void onDefaultSkinDecoded();
+    bool defaultSkinPreview_ = false;
 };
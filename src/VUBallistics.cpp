@@ -2,52 +2,175 @@
 
 #include <algorithm>
 #include <cmath>
-#include <cstdlib>
 
-VUBallistics::VUBallistics(float initialDb) : value_(initialDb), peak_(initialDb) {}
+// The timing constants of each meter type are in vuBallisticsPreset() (VUBallistics.h);
+// the defaults are based on measurements of Pioneer / Sansui meters.
+
+bool vuBallisticsPresetByName(std::string_view name, VuBallisticsProfile* out) {
+    struct Named {
+        std::string_view name;
+        VuBallisticsPreset preset;
+    };
+    static constexpr Named kPresets[] = {
+        {"pioneer", VuBallisticsPreset::Pioneer},
+        {"vu", VuBallisticsPreset::IecVu},
+        {"ppm1", VuBallisticsPreset::PpmType1},
+        {"ppm2", VuBallisticsPreset::PpmType2},
+        {"nordic", VuBallisticsPreset::Nordic},
+    };
+    for (const Named& named : kPresets) {
+        if (named.name == name) {
+            *out = vuBallisticsPreset(named.preset);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Seed of channel `index`; splitmix32 spreads neighbouring seeds apart, and xorshift
+// must not start at 0
+static std::uint32_t jitterSeed(std::uint32_t seed, unsigned int index) {
+    std::uint32_t z = seed + 0x9E3779B9u * (index + 1);
+    z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+    z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+    z ^= z >> 16;
+    return z ? z : 0x2545F491u;
+}
+
+static std::uint32_t xorshift32(std::uint32_t& state) {
+    std::uint32_t x = state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state = x;
+    return x;
+}
+
+VUBallistics::VUBallistics(float initialDb, const VuBallisticsProfile& profile, const VuJitterOptions& jitter)
+    : value_(initialDb), peak_(initialDb), jitter_(jitter.enabled), rng_(jitterSeed(jitter.seed, 0)),
+      profile_(profile) {}
 
 void VUBallistics::reset(float valueDb) {
     value_ = valueDb;
     peak_ = valueDb;
 }
 
-static float onePole(float y, float x, float dt, float tau) {
+// Smoothing factor of a one-pole low-pass for one step of dt
+static float onePoleCoefficient(float dt, float tau) {
     if (tau <= 0.0f) {
-        return x;
+        return 0.0f;
     }
-    const float a = std::exp(-dt / tau);
-    return a * y + (1.0f - a) * x;
+    return std::exp(-dt / tau);
 }
 
-// Vintage Hi-Fi VU ballistics
-// Smooth, slightly eager attack, gentle decay, tasteful overshoot, no drift.
+static float onePole(float y, float x, float a) { return a * y + (1.0f - a) * x; }
 
-float VUBallistics::process(float targetDb, float dtSeconds) {
+VUBallistics::Coefficients VUBallistics::coefficientsFor(const VuBallisticsProfile& profile, float dtSeconds) {
     dtSeconds = std::max(0.000001f, dtSeconds);
 
-    // --- Vintage hi-fi timing ---
-    // These values are based on measurements of Pioneer / Sansui meters.
-    const float attackTau = 0.080f;  // Pioneer fast attack (~80 ms)
-    const float releaseTau = 0.320f; // Pioneer medium release (~320 ms)
+    Coefficients c;
+    c.kind = profile.kind;
+    // A quasi-peak target is integrated with attackTau already (in the DSP, per sample)
+    const bool quasiPeak =
+        profile.kind == VuBallisticsProfile::Kind::Ppm && profile.detector == VuBallisticsProfile::Detector::Peak;
+    c.attack = quasiPeak ? 0.0f : onePoleCoefficient(dtSeconds, profile.attackTau);
+    c.release = onePoleCoefficient(dtSeconds, profile.releaseTau);
+    c.peakAttack = onePoleCoefficient(dtSeconds, profile.peakAttackTau);
+    c.peakRelease = onePoleCoefficient(dtSeconds, profile.peakReleaseTau);
+    c.fallDb = profile.fallDbPerSecond * dtSeconds;
+    c.overshootMix = profile.overshootMix;
+    return c;
+}
 
-    const float tau = (targetDb > value_) ? attackTau : releaseTau;
-    value_ = onePole(value_, targetDb, dtSeconds, tau);
+// --- Micro-jitter (needle vibration) ---
+// ±0.001 dB is enough to feel alive without looking fake.
+static float jitter(std::uint32_t* rng) {
+    if (!rng) {
+        return 0.0f;
+    }
+    return ((xorshift32(*rng) >> 16) % 40) / 20000.0f - 0.001f; // ±0.001 dB
+}
 
-    // --- Peak follower for overshoot ---
-    const float peakAttackTau = 0.010f;  // slightly faster peak rise
-    const float peakReleaseTau = 0.200f; // slightly faster fall
-    const float peakTau = (targetDb > peak_) ? peakAttackTau : peakReleaseTau;
-    peak_ = onePole(peak_, targetDb, dtSeconds, peakTau);
+// One step of a meter of kind K; rng is nullptr when jitter is off.
+// Vu: smooth, slightly eager attack, gentle decay, tasteful overshoot, no drift.
+// Ppm: near-instant rise and a constant return rate in dB, no overshoot.
+template <VuBallisticsProfile::Kind K>
+static float advance(
+    float& value, float& peak, float targetDb, const VUBallistics::Coefficients& c, std::uint32_t* rng) {
+    if constexpr (K == VuBallisticsProfile::Kind::Vu) {
+        value = onePole(value, targetDb, (targetDb > value) ? c.attack : c.release);
+        peak = onePole(peak, targetDb, (targetDb > peak) ? c.peakAttack : c.peakRelease);
 
-    // --- Overshoot mix ---
-    // Vintage hi-fi meters often overshoot by 5–10% on transients.
-    const float overshootMix = 0.07f; // Pioneer overshoot ~7%
-    float out = value_ + overshootMix * (peak_ - value_);
+        // --- Overshoot mix ---
+        return value + c.overshootMix * (peak - value) + jitter(rng);
+    } else {
+        (void)peak;
+        value = (targetDb > value) ? onePole(value, targetDb, c.attack) : std::max(targetDb, value - c.fallDb);
+        return value + jitter(rng);
+    }
+}
 
-    // --- Micro-jitter (needle vibration) ---
-    // ±0.02 dB is enough to feel alive without looking fake.
-    float jitter = ((rand() % 40) / 20000.0f) - 0.001f; // ±0.001 dB
-    out += jitter;
+static float advance(
+    float& value, float& peak, float targetDb, const VUBallistics::Coefficients& c, std::uint32_t* rng) {
+    return c.kind == VuBallisticsProfile::Kind::Ppm
+               ? advance<VuBallisticsProfile::Kind::Ppm>(value, peak, targetDb, c, rng)
+               : advance<VuBallisticsProfile::Kind::Vu>(value, peak, targetDb, c, rng);
+}
+
+float VUBallistics::process(float targetDb, float dtSeconds) {
+    if (dtSeconds != cachedDt_) {
+        cached_ = coefficientsFor(profile_, dtSeconds);
+        cachedDt_ = dtSeconds;
+    }
+    return advance(value_, peak_, targetDb, cached_, jitter_ ? &rng_ : nullptr);
+}
 
-    return out;
+float VUBallistics::step(float targetDb, const Coefficients& coefficients) {
+    return advance(value_, peak_, targetDb, coefficients, jitter_ ? &rng_ : nullptr);
+}
+
+// -------- VUBallisticsBank --------
+
+void VUBallisticsBank::configure(unsigned int channels, float initialDb) {
+    value_.assign(channels, initialDb);
+    peak_.assign(channels, initialDb);
+    seedJitter();
+}
+
+void VUBallisticsBank::setJitter(const VuJitterOptions& jitter) {
+    jitter_ = jitter;
+    seedJitter();
+}
+
+void VUBallisticsBank::seedJitter() {
+    rng_.resize(value_.size());
+    for (size_t c = 0; c < rng_.size(); ++c) {
+        rng_[c] = jitterSeed(jitter_.seed, static_cast<unsigned int>(c));
+    }
+}
+
+void VUBallisticsBank::reset(unsigned int channel, float valueDb) {
+    value_[channel] = valueDb;
+    peak_[channel] = valueDb;
+}
+
+float VUBallisticsBank::step(unsigned int channel, float targetDb, const VUBallistics::Coefficients& coefficients) {
+    return advance(
+        value_[channel], peak_[channel], targetDb, coefficients, jitter_.enabled ? &rng_[channel] : nullptr);
+}
+
+template <VuBallisticsProfile::Kind K>
+void VUBallisticsBank::stepAllAs(const float* targetDb, const VUBallistics::Coefficients& coefficients, float* out) {
+    const size_t channels = value_.size();
+    for (size_t c = 0; c < channels; ++c) {
+        out[c] = advance<K>(value_[c], peak_[c], targetDb[c], coefficients, jitter_.enabled ? &rng_[c] : nullptr);
+    }
+}
+
+void VUBallisticsBank::stepAll(const float* targetDb, const VUBallistics::Coefficients& coefficients, float* out) {
+    if (coefficients.kind == VuBallisticsProfile::Kind::Ppm) {
+        stepAllAs<VuBallisticsProfile::Kind::Ppm>(targetDb, coefficients, out);
+    } else {
+        stepAllAs<VuBallisticsProfile::Kind::Vu>(targetDb, coefficients, out);
+    }
 }
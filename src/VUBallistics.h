@@ -1,13 +1,154 @@
 #pragma once
 
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Needle micro-jitter: a few thousandths of a dB of noise, so that a steady needle
+// looks alive. Every meter draws from its own xorshift32 generator, seeded from
+// `seed` and its channel, so channels are uncorrelated, nothing is shared between
+// threads, and the same seed reproduces the same output bit for bit.
+struct VuJitterOptions final {
+    bool enabled = true;
+    std::uint32_t seed = 0x2545F491u;
+};
+
+// Dynamics of one kind of meter. The defaults are the Pioneer/Sansui hi-fi timing.
+struct VuBallisticsProfile final {
+    // Filter kernel: Vu = one-pole attack/release with a peak follower mixed in for
+    // overshoot; Ppm = fast attack and a linear return in dB/s
+    enum class Kind { Vu, Ppm };
+
+    // What the DSP feeds the kernel: the RMS of a block, or its sample peak. A Ppm
+    // with the peak detector integrates the rectified signal sample by sample with
+    // attackTau (the quasi-peak of IEC 60268-10), and its needle follows that at once.
+    enum class Detector { Rms, Peak };
+
+    Kind kind = Kind::Vu;
+    Detector detector = Detector::Rms;
+
+    float attackTau = 0.080f;     // s (Ppm + Peak: of the quasi-peak integrator)
+    float releaseTau = 0.320f;    // s (Vu)
+    float fallDbPerSecond = 0.0f; // Ppm
+
+    // Vu: share of the (faster) peak follower mixed into the needle
+    float overshootMix = 0.07f;
+    float peakAttackTau = 0.010f;
+    float peakReleaseTau = 0.200f;
+
+    bool operator==(const VuBallisticsProfile&) const = default;
+};
+
+enum class VuBallisticsPreset { Pioneer, IecVu, PpmType1, PpmType2, Nordic };
+
+constexpr VuBallisticsProfile vuBallisticsPreset(VuBallisticsPreset preset) {
+    VuBallisticsProfile p;
+    switch (preset) {
+    case VuBallisticsPreset::Pioneer:
+        break;
+    case VuBallisticsPreset::IecVu:
+        // IEC 60268-17: 99% of a 0 VU step in 300 ms, 1-1.5% overshoot, same on the way down
+        p.attackTau = 0.065f;
+        p.releaseTau = 0.065f;
+        p.overshootMix = 0.015f;
+        p.peakAttackTau = 0.010f;
+        p.peakReleaseTau = 0.065f;
+        break;
+    case VuBallisticsPreset::PpmType1:
+        // IEC 60268-10 Type I (DIN 45406): 5 ms integration, 20 dB return in 1.5 s.
+        // The integration time is the 5 kHz burst that reads 2 dB low; charging on a
+        // rectified sine, the quasi-peak detector gets there with a quarter of it.
+        p.kind = VuBallisticsProfile::Kind::Ppm;
+        p.detector = VuBallisticsProfile::Detector::Peak;
+        p.attackTau = 0.00125f;
+        p.fallDbPerSecond = 20.0f / 1.5f;
+        break;
+    case VuBallisticsPreset::PpmType2:
+        // IEC 60268-10 Type II (BBC/EBU): 10 ms integration, 24 dB return in 2.8 s
+        p.kind = VuBallisticsProfile::Kind::Ppm;
+        p.detector = VuBallisticsProfile::Detector::Peak;
+        p.attackTau = 0.0025f;
+        p.fallDbPerSecond = 24.0f / 2.8f;
+        break;
+    case VuBallisticsPreset::Nordic:
+        // Nordic N9 (IEC 60268-10 Type I timing): 5 ms integration, 20 dB return in 1.7 s
+        p.kind = VuBallisticsProfile::Kind::Ppm;
+        p.detector = VuBallisticsProfile::Detector::Peak;
+        p.attackTau = 0.00125f;
+        p.fallDbPerSecond = 20.0f / 1.7f;
+        break;
+    }
+    return p;
+}
+
+// "pioneer", "vu" (IEC VU), "ppm1", "ppm2" or "nordic"; false for anything else
+bool vuBallisticsPresetByName(std::string_view name, VuBallisticsProfile* out);
+
 class VUBallistics final {
   public:
-    explicit VUBallistics(float initialDb = -20.0f);
+    // Per-step factors of a profile for a fixed time step, see coefficientsFor()
+    struct Coefficients final {
+        VuBallisticsProfile::Kind kind = VuBallisticsProfile::Kind::Vu;
+        float attack = 0.0f;
+        float release = 0.0f;
+        float peakAttack = 0.0f;
+        float peakRelease = 0.0f;
+        float fallDb = 0.0f; // Ppm: dB the needle returns per step
+        float overshootMix = 0.0f;
+    };
+
+    explicit VUBallistics(float initialDb = -20.0f,
+                          const VuBallisticsProfile& profile = VuBallisticsProfile(),
+                          const VuJitterOptions& jitter = VuJitterOptions());
+
+    static Coefficients coefficientsFor(const VuBallisticsProfile& profile, float dtSeconds);
 
+    // Coefficients are recomputed only when dt changes
     float process(float targetDb, float dtSeconds);
+
+    // Fixed time step advance with precomputed coefficients (no std::exp per call)
+    float step(float targetDb, const Coefficients& coefficients);
+
     void reset(float valueDb);
 
   private:
     float value_;
     float peak_;
+    bool jitter_;
+    std::uint32_t rng_;
+
+    VuBallisticsProfile profile_;
+    float cachedDt_ = -1.0f;
+    Coefficients cached_;
+};
+
+// Ballistics of several meters sharing the same timing, with the per-channel
+// needle and peak-follower values kept as separate arrays.
+class VUBallisticsBank final {
+  public:
+    void configure(unsigned int channels, float initialDb);
+    unsigned int size() const { return static_cast<unsigned int>(value_.size()); }
+
+    // Reseeds every channel; kept across configure(), which reseeds too
+    void setJitter(const VuJitterOptions& jitter);
+
+    void reset(unsigned int channel, float valueDb);
+    float step(unsigned int channel, float targetDb, const VUBallistics::Coefficients& coefficients);
+
+    // Needle position of `channel` as of the last step, without jitter
+    float value(unsigned int channel) const { return value_[channel]; }
+
+    // Advances every channel by one step; the kernel is picked once per call, not per channel
+    void stepAll(const float* targetDb, const VUBallistics::Coefficients& coefficients, float* out);
+
+  private:
+    template <VuBallisticsProfile::Kind K>
+    void stepAllAs(const float* targetDb, const VUBallistics::Coefficients& coefficients, float* out);
+
+    void seedJitter();
+
+    std::vector<float> value_;
+    std::vector<float> peak_;
+    std::vector<std::uint32_t> rng_;
+    VuJitterOptions jitter_;
 };
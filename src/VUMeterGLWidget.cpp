@@ -0,0 +1,165 @@
+#include "VUMeterGLWidget.h"
+
+#include <QImage>
+#include <QOpenGLTexture>
+
+static constexpr float kPi = 3.14159265358979323846f;
+
+// Unit quad, expanded to the meter rect and rotated around the pivot in the vertex shader.
+// Positions are in widget space (y down), which matches QPainter::rotate() and QImage row order.
+static const char* kVertexShader = R"(
+attribute highp vec2 a_pos;
+uniform highp vec4 u_rect;
+uniform highp vec2 u_viewport;
+uniform highp vec2 u_pivot;
+uniform highp float u_angle;
+varying mediump vec2 v_uv;
+void main() {
+    highp vec2 p = u_rect.xy + a_pos * u_rect.zw;
+    highp vec2 d = p - u_pivot;
+    highp float c = cos(u_angle);
+    highp float s = sin(u_angle);
+    p = u_pivot + vec2(d.x * c - d.y * s, d.x * s + d.y * c);
+    gl_Position = vec4(p.x / u_viewport.x * 2.0 - 1.0, 1.0 - p.y / u_viewport.y * 2.0, 0.0, 1.0);
+    v_uv = a_pos;
+}
+)";
+
+static const char* kFragmentShader = R"(
+uniform sampler2D u_texture;
+varying mediump vec2 v_uv;
+void main() {
+    gl_FragColor = texture2D(u_texture, v_uv);
+}
+)";
+
+static std::unique_ptr<QOpenGLTexture> makeTexture(const QPixmap& pixmap) {
+    if (pixmap.isNull()) {
+        return nullptr;
+    }
+
+    auto texture = std::make_unique<QOpenGLTexture>(pixmap.toImage(), QOpenGLTexture::GenerateMipMaps);
+    texture->setMinificationFilter(QOpenGLTexture::LinearMipMapLinear);
+    texture->setMagnificationFilter(QOpenGLTexture::Linear);
+    texture->setWrapMode(QOpenGLTexture::ClampToEdge);
+    return texture;
+}
+
+VUMeterGLWidget::VUMeterGLWidget(QWidget* parent) : QOpenGLWidget(parent), quad_(QOpenGLBuffer::VertexBuffer) {}
+
+VUMeterGLWidget::~VUMeterGLWidget() {
+    makeCurrent();
+    releaseTextures();
+    quad_.destroy();
+    doneCurrent();
+}
+
+void VUMeterGLWidget::setSkin(const VUSkinPackage& skin) {
+    skin_ = skin;
+    texturesDirty_ = true;
+    update();
+}
+
+void VUMeterGLWidget::setMeters(const QVector<MeterQuad>& meters) {
+    meters_ = meters;
+    update();
+}
+
+void VUMeterGLWidget::initializeGL() {
+    initializeOpenGLFunctions();
+
+    program_.addShaderFromSourceCode(QOpenGLShader::Vertex, kVertexShader);
+    program_.addShaderFromSourceCode(QOpenGLShader::Fragment, kFragmentShader);
+    program_.bindAttributeLocation("a_pos", 0);
+    if (!program_.link()) {
+        qWarning("VUMeterGLWidget: shader link failed: %s", qPrintable(program_.log()));
+    }
+
+    rectLoc_ = program_.uniformLocation("u_rect");
+    viewportLoc_ = program_.uniformLocation("u_viewport");
+    pivotLoc_ = program_.uniformLocation("u_pivot");
+    angleLoc_ = program_.uniformLocation("u_angle");
+    samplerLoc_ = program_.uniformLocation("u_texture");
+
+    static const GLfloat kQuad[] = {0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f};
+    quad_.create();
+    quad_.bind();
+    quad_.allocate(kQuad, sizeof(kQuad));
+    quad_.release();
+
+    // Context may have been recreated (e.g. reparenting); textures must follow it
+    releaseTextures();
+    texturesDirty_ = true;
+}
+
+void VUMeterGLWidget::releaseTextures() {
+    leftTextures_ = MeterTextures();
+    rightTextures_ = MeterTextures();
+}
+
+void VUMeterGLWidget::uploadTextures() {
+    releaseTextures();
+
+    leftTextures_.face = makeTexture(skin_.left.face);
+    leftTextures_.needle = makeTexture(skin_.left.needle);
+    leftTextures_.cap = makeTexture(skin_.left.cap);
+
+    rightTextures_.face = makeTexture(skin_.right.face);
+    rightTextures_.needle = makeTexture(skin_.right.needle);
+    rightTextures_.cap = makeTexture(skin_.right.cap);
+
+    texturesDirty_ = false;
+}
+
+void VUMeterGLWidget::drawQuad(QOpenGLTexture* texture, const QRectF& rect, const QPointF& pivot, float angleDeg) {
+    if (!texture || rect.isEmpty()) {
+        return;
+    }
+
+    texture->bind(0);
+    program_.setUniformValue(rectLoc_,
+                             static_cast<GLfloat>(rect.x()),
+                             static_cast<GLfloat>(rect.y()),
+                             static_cast<GLfloat>(rect.width()),
+                             static_cast<GLfloat>(rect.height()));
+    program_.setUniformValue(pivotLoc_, static_cast<GLfloat>(pivot.x()), static_cast<GLfloat>(pivot.y()));
+    program_.setUniformValue(angleLoc_, static_cast<GLfloat>(angleDeg * (kPi / 180.0f)));
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    texture->release(0);
+}
+
+void VUMeterGLWidget::paintGL() {
+    if (texturesDirty_) {
+        uploadTextures();
+    }
+
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    program_.bind();
+    program_.setUniformValue(viewportLoc_, static_cast<GLfloat>(width()), static_cast<GLfloat>(height()));
+    program_.setUniformValue(samplerLoc_, 0);
+
+    quad_.bind();
+    program_.enableAttributeArray(0);
+    program_.setAttributeBuffer(0, GL_FLOAT, 0, 2);
+
+    // --- Faces, needles, caps (same stacking as the raster path) ---
+    for (const MeterQuad& m : meters_) {
+        const MeterTextures& t = m.rightSide ? rightTextures_ : leftTextures_;
+        drawQuad(t.face.get(), m.rect, m.pivot, 0.0f);
+    }
+
+    for (const MeterQuad& m : meters_) {
+        const MeterTextures& t = m.rightSide ? rightTextures_ : leftTextures_;
+        drawQuad(t.needle.get(), m.rect, m.pivot, m.angleDeg);
+        drawQuad(t.cap.get(), m.rect, m.pivot, 0.0f);
+    }
+
+    program_.disableAttributeArray(0);
+    quad_.release();
+    program_.release();
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QOpenGLBuffer>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLWidget>
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+
+#include <memory>
+
+#include "VUMeterSkin.h"
+
+class QOpenGLTexture;
+
+// GPU renderer for Skin mode.
+//
+// The face, needle and cap images of the skin are uploaded as textures once per
+// skin; every frame is then a handful of textured quads, with the needle rotation
+// passed to the vertex shader as a uniform. StereoVUMeterWidget owns this widget,
+// lays it over itself and feeds it geometry and needle angles.
+class VUMeterGLWidget final : public QOpenGLWidget, protected QOpenGLFunctions {
+    Q_OBJECT
+
+  public:
+    struct MeterQuad {
+        QRectF rect;   // widget-space rectangle of the face
+        QPointF pivot; // widget-space needle rotation center
+        float angleDeg = 0.0f;
+        bool rightSide = false; // draw with the right-channel images of the skin
+    };
+
+    explicit VUMeterGLWidget(QWidget* parent = nullptr);
+    ~VUMeterGLWidget() override;
+
+    // Textures are (re)uploaded on the next paint
+    void setSkin(const VUSkinPackage& skin);
+    void setMeters(const QVector<MeterQuad>& meters);
+
+  protected:
+    void initializeGL() override;
+    void paintGL() override;
+
+  private:
+    struct MeterTextures {
+        std::unique_ptr<QOpenGLTexture> face;
+        std::unique_ptr<QOpenGLTexture> needle;
+        std::unique_ptr<QOpenGLTexture> cap;
+    };
+
+    void uploadTextures();
+    void releaseTextures();
+    void drawQuad(QOpenGLTexture* texture, const QRectF& rect, const QPointF& pivot, float angleDeg);
+
+    VUSkinPackage skin_;
+    bool texturesDirty_ = true;
+
+    MeterTextures leftTextures_;
+    MeterTextures rightTextures_;
+
+    QVector<MeterQuad> meters_;
+
+    QOpenGLShaderProgram program_;
+    QOpenGLBuffer quad_;
+    int rectLoc_ = -1;
+    int viewportLoc_ = -1;
+    int pivotLoc_ = -1;
+    int angleLoc_ = -1;
+    int samplerLoc_ = -1;
+};
@@ -1,5 +1,7 @@
 #include "VUMeterScale.h"
 
+#include <algorithm>
+
 VUMeterScaleTable builtInDefaultScaleTable() {
     return {{-20, -47},
             {-10, -34},
@@ -16,6 +18,64 @@ VUMeterScaleTable builtInDefaultScaleTable() {
             {3, 47}};
 }
 
+VUMeterScaleLut::VUMeterScaleLut(const VUMeterScaleTable& table) {
+    if (table.isEmpty()) {
+        return;
+    }
+
+    empty_ = false;
+    minVu_ = table.first().first;
+    maxVu_ = table.last().first;
+    firstAngle_ = table.first().second;
+    lastAngle_ = table.last().second;
+
+    // Zero-width segments can never be the one a level falls in
+    segments_.reserve(table.size());
+    for (int i = 0; i + 1 < table.size(); ++i) {
+        if (table[i + 1].first > table[i].first) {
+            segments_.push_back({table[i].first, table[i + 1].first, table[i].second, table[i + 1].second});
+        }
+    }
+    if (segments_.empty()) {
+        return;
+    }
+
+    const int cells = static_cast<int>(segments_.size()) * kCellsPerSegment;
+    cellScale_ = cells / (maxVu_ - minVu_);
+    cellSegment_.resize(cells);
+
+    std::size_t segment = 0;
+    for (int c = 0; c < cells; ++c) {
+        const float cellStart = minVu_ + c / cellScale_;
+        while (segment + 1 < segments_.size() && segments_[segment].vu1 < cellStart) {
+            ++segment;
+        }
+        // One segment early, so rounding in angleDeg() can never land past the right one
+        cellSegment_[c] = static_cast<std::uint16_t>(segment > 0 ? segment - 1 : 0);
+    }
+}
+
+float VUMeterScaleLut::angleDeg(float vuDb) const {
+    // Clamp to table range (NaN ends up at the top, as before)
+    if (vuDb <= minVu_) {
+        return firstAngle_;
+    }
+    if (!(vuDb < maxVu_) || segments_.empty()) {
+        return lastAngle_;
+    }
+
+    const int lastCell = static_cast<int>(cellSegment_.size()) - 1;
+    const int cell = std::min(static_cast<int>((vuDb - minVu_) * cellScale_), lastCell);
+    std::size_t segment = cellSegment_[cell];
+    while (segments_[segment].vu1 < vuDb) {
+        ++segment;
+    }
+
+    const Segment& s = segments_[segment];
+    const float t = (vuDb - s.vu0) / (s.vu1 - s.vu0);
+    return s.angle0 + t * (s.angle1 - s.angle0);
+}
+
 float vuToAngleDeg(float vuDb, const VUMeterScaleTable& table) {
     if (table.isEmpty()) {
         return 0.0f;
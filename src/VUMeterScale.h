@@ -3,6 +3,9 @@
 #include <QPair>
 #include <QVector>
 
+#include <cstdint>
+#include <vector>
+
 // Data-driven scale mapping: VU (dB) -> needle angle (degrees).
 //
 // The default table values represent the built-in calibration shipped with the app.
@@ -12,4 +15,45 @@ using VUMeterScaleTable = QVector<QPair<float, float>>;
 
 VUMeterScaleTable builtInDefaultScaleTable();
 
+// A scale table compiled for lookups: the segments are stored contiguously with a
+// uniform grid over the VU range pointing at the segment each grid cell starts in,
+// so a lookup is a multiply, an index and at most a step or two to the next
+// segment, independent of the table size. Results are identical to interpolating
+// the table directly. Built once when a skin or style is set, then shared by every
+// needle drawn with that scale.
+class VUMeterScaleLut final {
+  public:
+    VUMeterScaleLut() = default;
+    // `table` must be sorted by level (as the skin loader leaves it)
+    explicit VUMeterScaleLut(const VUMeterScaleTable& table);
+
+    bool isEmpty() const { return empty_; }
+
+    float angleDeg(float vuDb) const;
+
+    // Angles at the ends of the table
+    float firstAngleDeg() const { return firstAngle_; }
+    float lastAngleDeg() const { return lastAngle_; }
+
+  private:
+    struct Segment {
+        float vu0;
+        float vu1;
+        float angle0;
+        float angle1;
+    };
+
+    static constexpr int kCellsPerSegment = 4;
+
+    std::vector<Segment> segments_;
+    std::vector<std::uint16_t> cellSegment_;
+    float minVu_ = 0.0f;
+    float maxVu_ = 0.0f;
+    float cellScale_ = 0.0f; // cells per dB
+    float firstAngle_ = 0.0f;
+    float lastAngle_ = 0.0f;
+    bool empty_ = true;
+};
+
+// One-off lookup scanning the table; anything called per frame should keep a VUMeterScaleLut instead
 float vuToAngleDeg(float vuDb, const VUMeterScaleTable& table);
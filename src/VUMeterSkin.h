@@ -3,6 +3,8 @@
 #include <QtGlobal>
 #include <QPixmap>
 
+#include "VUBallistics.h"
+
 // Skin data types are intentionally lightweight and data-focused.
 // The widget owns the built-in default skin and is responsible for drawing.
 // TODO: Future work: load skin packages from disk/resources.
@@ -39,4 +41,8 @@ struct VUSkinPackage {
     // Stereo meters
     VUMeterSkin left;
     VUMeterSkin right;
+
+    // Optional "ballistics" in skin.json: a PPM face can ask for PPM dynamics
+    bool hasBallistics = false;
+    VuBallisticsProfile ballistics;
 };
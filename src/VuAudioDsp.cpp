@@ -2,113 +2,302 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 
 #include "VUBallistics.h"
+#include "VuAudioKernels.h"
 
-void processInterleavedFloatAudioToVuDb(const float* data,
-                                       unsigned int frames,
-                                       unsigned int channels,
-                                       float sampleRate,
-                                       const VuReferenceOptions& ref,
-                                       VUBallistics& ballisticsL,
-                                       VUBallistics& ballisticsR,
-                                       VuAudioDspState& state,
-                                       float minVu,
-                                       float maxVu,
-                                       float& outVuL,
-                                       float& outVuR) {
-    if (!data || frames == 0 || channels == 0 || sampleRate <= 0.0f) {
-        outVuL = minVu;
-        outVuR = minVu;
+static constexpr float kVuTau = 0.020f;
+static constexpr float kNoiseFloor = 0.001f;
+
+void VuAudioDspState::configure(unsigned int channelCount, float initialVu) {
+    if (channels == channelCount) {
         return;
     }
 
-    // --- Compute raw RMS for this buffer ---
-    double sumL = 0.0;
-    double sumR = 0.0;
+    channels = channelCount;
+    prev.assign(channelCount, 0.0f);
+    sums.assign(channelCount, 0.0);
+    rmsSmooth.assign(channelCount, 0.0f);
+    awake.assign(channelCount, 0);
+    targets.assign(channelCount, initialVu);
+    ballistics.configure(channelCount, initialVu);
 
-    for (unsigned int i = 0; i < frames; ++i) {
-        const float rawL = data[i * channels + 0];
-        const float rawR = (channels > 1) ? data[i * channels + 1] : rawL;
+    peak.assign(channelCount, 0.0f);
+    blockPeak.assign(channelCount, 0.0f);
+    peakDbfs.assign(channelCount, kVuPeakFloorDbfs);
+    quasiPeak.assign(channelCount, 0.0f);
 
-        // Transient pre-emphasis (very subtle)
-        const float l = rawL + 0.15f * (rawL - state.prevL);
-        const float r = rawR + 0.15f * (rawR - state.prevR);
+    subSums.assign(channelCount, 0.0);
+    subPeak.assign(channelCount, 0.0f);
+    subFrames = 0;
+    lastVu.assign(channelCount, initialVu);
+    hasOutput = false;
+}
 
-        state.prevL = rawL;
-        state.prevR = rawR;
+void VuAudioDspState::setBallisticsProfile(const VuBallisticsProfile& profile) {
+    if (profile == ballisticsProfile) {
+        return;
+    }
+    ballisticsProfile = profile;
 
-        sumL += static_cast<double>(l) * static_cast<double>(l);
-        sumR += static_cast<double>(r) * static_cast<double>(r);
+    // Recomputed on the next buffer; the control-rate step keeps its partial sub-block
+    cachedBlockFrames = 0;
+    quasiPeakSampleRate = 0.0f;
+    if (subBlockFrames > 0 && cachedSampleRate > 0.0f) {
+        ballisticsCoefficients =
+            VUBallistics::coefficientsFor(profile, static_cast<float>(subBlockFrames) / cachedSampleRate);
     }
+}
 
-    const float rmsL = std::sqrt(static_cast<float>(sumL / frames));
-    const float rmsR = std::sqrt(static_cast<float>(sumR / frames));
+static float effectiveReferenceDbfs(const VuReferenceOptions& ref) {
+    // --- Reference level for hi-fi VU behavior ---
+    if (ref.referenceDbfsOverride) {
+        return static_cast<float>(ref.referenceDbfs);
+    }
+    if (ref.deviceType == 1) {
+        // Microphone mode
+        return -0.0f;
+    }
+    // System output mode
+    return -14.0f;
+}
 
+// RMS integration, noise floor and reference for one measurement block of one
+// channel. Returns the raw (pre-ballistics) VU target and wakes the meter on first
+// signal; a Ppm needle rises from rest with its own attack instead.
+static float integrateRms(float rms, float alpha, float refDbfs, VuAudioDspState& state, unsigned int c) {
     // --- Vintage VU RMS integration (250 ms) ---
-    const float wakeThreshold = 0.002f; // about -54 dBFS
+    float& smooth = state.rmsSmooth[c];
+    if (rms > kVuWakeThreshold) {
+        smooth = rms * rms;
+    }
+    smooth = alpha * smooth + (1.0f - alpha) * (rms * rms);
 
-    if (rmsL > wakeThreshold) {
-        state.rmsL_smooth = rmsL * rmsL;
+    float rmsVu = std::sqrt(smooth);
+
+    // --- Noise floor applied to smoothed RMS ---
+    if (rmsVu < kNoiseFloor) {
+        rmsVu = 0.0f;
     }
-    if (rmsR > wakeThreshold) {
-        state.rmsR_smooth = rmsR * rmsR;
+
+    // --- Convert to dBFS ---
+    const float eps = 1e-12f;
+    const float targetVu = 20.0f * std::log10(std::max(rmsVu, eps)) - refDbfs;
+
+    if (!state.awake[c] && rmsVu > kVuWakeThreshold) {
+        if (state.ballisticsProfile.kind != VuBallisticsProfile::Kind::Ppm) {
+            state.ballistics.reset(c, targetVu);
+        }
+        state.awake[c] = 1;
     }
+    return targetVu;
+}
 
-    const float vuTau = 0.020f;
-    float dt = static_cast<float>(frames) / sampleRate;
-    dt = std::min(dt, 0.050f); // clamp to 50 ms
-    const float alpha = std::exp(-dt / vuTau);
+// Peak detector: a level (the block's sample peak, or the quasi-peak) relative to the reference.
+// Never snaps the needle: a PPM reads short bursts low, and so must a meter waking from rest.
+static float peakTarget(float peak, float refDbfs) {
+    const float eps = 1e-12f;
+    return 20.0f * std::log10(std::max(peak, eps)) - refDbfs;
+}
 
-    state.rmsL_smooth = alpha * state.rmsL_smooth + (1.0f - alpha) * (rmsL * rmsL);
-    state.rmsR_smooth = alpha * state.rmsR_smooth + (1.0f - alpha) * (rmsR * rmsR);
+static bool usesQuasiPeak(const VuBallisticsProfile& profile) {
+    return profile.kind == VuBallisticsProfile::Kind::Ppm && profile.detector == VuBallisticsProfile::Detector::Peak;
+}
 
-    float rmsL_vu = std::sqrt(state.rmsL_smooth);
-    float rmsR_vu = std::sqrt(state.rmsR_smooth);
+static void updateQuasiPeakRise(float sampleRate, VuAudioDspState& state) {
+    if (state.quasiPeakSampleRate == sampleRate) {
+        return;
+    }
+    const float tau = state.ballisticsProfile.attackTau;
+    state.quasiPeakRise = tau > 0.0f ? -std::expm1(-1.0f / (sampleRate * tau)) : 1.0f;
+    state.quasiPeakSampleRate = sampleRate;
+}
 
-    // --- Noise floor applied to smoothed RMS ---
-    const float noiseFloor = 0.001f;
-    if (rmsL_vu < noiseFloor) {
-        rmsL_vu = 0.0f;
+// --- IEC 60268-10 quasi-peak: full-wave rectify, charge with the attack time ---
+static void integrateQuasiPeak(
+    const float* data, unsigned int frames, unsigned int channels, float rise, float* quasiPeak) {
+    for (unsigned int i = 0; i < frames; ++i) {
+        const float* frame = data + static_cast<std::size_t>(i) * channels;
+        for (unsigned int c = 0; c < channels; ++c) {
+            const float x = std::fabs(frame[c]);
+            if (x > quasiPeak[c]) {
+                quasiPeak[c] += rise * (x - quasiPeak[c]);
+            }
+        }
     }
-    if (rmsR_vu < noiseFloor) {
-        rmsR_vu = 0.0f;
+}
+
+// The decay is the needle's: after a step the integrator holds no more than the needle shows
+static void releaseQuasiPeak(float refDbfs, VuAudioDspState& state) {
+    for (unsigned int c = 0; c < state.channels; ++c) {
+        const float needle = std::pow(10.0f, (state.ballistics.value(c) + refDbfs) / 20.0f);
+        state.quasiPeak[c] = std::min(state.quasiPeak[c], needle);
     }
+}
 
-    // --- Convert to dBFS ---
-    const float eps = 1e-12f;
-    const float dbfsL = 20.0f * std::log10(std::max(rmsL_vu, eps));
-    const float dbfsR = 20.0f * std::log10(std::max(rmsR_vu, eps));
+static void updatePeakDbfs(VuAudioDspState& state) {
+    for (unsigned int c = 0; c < state.channels; ++c) {
+        const float p = state.peak[c];
+        state.peakDbfs[c] = p > 0.0f ? std::max(20.0f * std::log10(p), kVuPeakFloorDbfs) : kVuPeakFloorDbfs;
+    }
+}
 
-    // --- Reference level for hi-fi VU behavior ---
-    float effectiveRefDbfs;
-    if (ref.referenceDbfsOverride) {
-        effectiveRefDbfs = static_cast<float>(ref.referenceDbfs);
-    } else if (ref.deviceType == 1) {
-        // Microphone mode
-        effectiveRefDbfs = -0.0f;
-    } else {
-        // System output mode
-        effectiveRefDbfs = -14.0f;
+void processInterleavedFloatAudioToVuDb(const float* data,
+                                        unsigned int frames,
+                                        unsigned int channels,
+                                        float sampleRate,
+                                        const VuReferenceOptions& ref,
+                                        VuAudioDspState& state,
+                                        float minVu,
+                                        float maxVu,
+                                        float* outVu) {
+    if (!data || frames == 0 || channels == 0 || sampleRate <= 0.0f) {
+        std::fill(outVu, outVu + channels, minVu);
+        return;
+    }
+
+    state.configure(channels, minVu);
+
+    // --- Pre-emphasized sum of squares and sample peak of every channel ---
+    vuPreEmphasisSumSquares(data, frames, channels, state.prev.data(), state.sums.data(), state.peak.data());
+    updatePeakDbfs(state);
+
+    if (frames != state.cachedBlockFrames || sampleRate != state.cachedBlockSampleRate) {
+        float dt = static_cast<float>(frames) / sampleRate;
+        dt = std::min(dt, 0.050f); // clamp to 50 ms
+        state.blockRmsAlpha = std::exp(-dt / kVuTau);
+        state.blockCoefficients = VUBallistics::coefficientsFor(state.ballisticsProfile, dt);
+        state.cachedBlockFrames = frames;
+        state.cachedBlockSampleRate = sampleRate;
+    }
+    const float refDbfs = effectiveReferenceDbfs(ref);
+    const bool peakDetector = state.ballisticsProfile.detector == VuBallisticsProfile::Detector::Peak;
+    const bool quasiPeak = usesQuasiPeak(state.ballisticsProfile);
+    if (quasiPeak) {
+        updateQuasiPeakRise(sampleRate, state);
+        integrateQuasiPeak(data, frames, channels, state.quasiPeakRise, state.quasiPeak.data());
+    }
+
+    for (unsigned int c = 0; c < channels; ++c) {
+        if (peakDetector) {
+            state.targets[c] = peakTarget(quasiPeak ? state.quasiPeak[c] : state.peak[c], refDbfs);
+        } else {
+            const float rms = std::sqrt(static_cast<float>(state.sums[c] / frames));
+            state.targets[c] = integrateRms(rms, state.blockRmsAlpha, refDbfs, state, c);
+        }
+    }
+
+    // --- Apply ballistics using per-callback dt, clamp to meter scale ---
+    state.ballistics.stepAll(state.targets.data(), state.blockCoefficients, outVu);
+    if (quasiPeak) {
+        releaseQuasiPeak(refDbfs, state);
+    }
+    for (unsigned int c = 0; c < channels; ++c) {
+        outVu[c] = std::clamp(outVu[c], minVu, maxVu);
     }
+}
 
-    const float targetVuL = dbfsL - effectiveRefDbfs;
-    const float targetVuR = dbfsR - effectiveRefDbfs;
+static void updateControlRateCoefficients(float sampleRate, float controlRateHz, VuAudioDspState& state) {
+    if (state.cachedSampleRate == sampleRate && state.cachedControlRateHz == controlRateHz) {
+        return;
+    }
+
+    state.cachedSampleRate = sampleRate;
+    state.cachedControlRateHz = controlRateHz;
+    state.subBlockFrames = std::max(1u, static_cast<unsigned int>(std::lround(sampleRate / controlRateHz)));
+
+    // Exact step of the rounded sub-block, not 1 / controlRateHz
+    const float dt = static_cast<float>(state.subBlockFrames) / sampleRate;
+    state.rmsAlpha = std::exp(-dt / kVuTau);
+    state.ballisticsCoefficients = VUBallistics::coefficientsFor(state.ballisticsProfile, dt);
+
+    // A partial sub-block from the previous rate would be measured with the wrong length
+    std::fill(state.subSums.begin(), state.subSums.end(), 0.0);
+    std::fill(state.subPeak.begin(), state.subPeak.end(), 0.0f);
+    state.subFrames = 0;
+}
 
-    if (!state.meterAwake && (rmsL_vu > 0.002f || rmsR_vu > 0.002f)) {
-        ballisticsL.reset(targetVuL);
-        ballisticsR.reset(targetVuR);
-        state.meterAwake = true;
+void processInterleavedFloatAudioToVuDbFixedRate(const float* data,
+                                                 unsigned int frames,
+                                                 unsigned int channels,
+                                                 float sampleRate,
+                                                 float controlRateHz,
+                                                 const VuReferenceOptions& ref,
+                                                 VuAudioDspState& state,
+                                                 float minVu,
+                                                 float maxVu,
+                                                 float* outVu) {
+    if (!data || frames == 0 || channels == 0 || sampleRate <= 0.0f || controlRateHz <= 0.0f) {
+        for (unsigned int c = 0; c < channels; ++c) {
+            outVu[c] = (state.hasOutput && c < state.channels) ? state.lastVu[c] : minVu;
+        }
+        return;
+    }
+
+    state.configure(channels, minVu);
+    updateControlRateCoefficients(sampleRate, controlRateHz, state);
+
+    const unsigned int blockFrames = state.subBlockFrames;
+    const float refDbfs = effectiveReferenceDbfs(ref);
+    const bool peakDetector = state.ballisticsProfile.detector == VuBallisticsProfile::Detector::Peak;
+    const bool quasiPeak = usesQuasiPeak(state.ballisticsProfile);
+    if (quasiPeak) {
+        updateQuasiPeakRise(sampleRate, state);
     }
+    unsigned int i = 0;
+    std::fill(state.peak.begin(), state.peak.end(), 0.0f);
 
-    // --- Apply ballistics using per-callback dt ---
-    float vuL = ballisticsL.process(targetVuL, dt);
-    float vuR = ballisticsR.process(targetVuR, dt);
+    while (i < frames) {
+        const unsigned int n = std::min(frames - i, blockFrames - state.subFrames);
 
-    // --- Clamp to meter scale ---
-    vuL = std::clamp(vuL, minVu, maxVu);
-    vuR = std::clamp(vuR, minVu, maxVu);
+        vuPreEmphasisSumSquares(data + static_cast<std::size_t>(i) * channels,
+                                n,
+                                channels,
+                                state.prev.data(),
+                                state.sums.data(),
+                                state.blockPeak.data());
+        if (quasiPeak) {
+            integrateQuasiPeak(data + static_cast<std::size_t>(i) * channels,
+                               n,
+                               channels,
+                               state.quasiPeakRise,
+                               state.quasiPeak.data());
+        }
+        for (unsigned int c = 0; c < channels; ++c) {
+            state.subSums[c] += state.sums[c];
+            state.subPeak[c] = std::max(state.subPeak[c], state.blockPeak[c]);
+            state.peak[c] = std::max(state.peak[c], state.blockPeak[c]);
+        }
+        state.subFrames += n;
+        i += n;
+
+        if (state.subFrames < blockFrames) {
+            break; // carried over to the next buffer
+        }
+
+        for (unsigned int c = 0; c < channels; ++c) {
+            if (peakDetector) {
+                state.targets[c] = peakTarget(quasiPeak ? state.quasiPeak[c] : state.subPeak[c], refDbfs);
+            } else {
+                const float rms = std::sqrt(static_cast<float>(state.subSums[c] / blockFrames));
+                state.targets[c] = integrateRms(rms, state.rmsAlpha, refDbfs, state, c);
+            }
+            state.subSums[c] = 0.0;
+            state.subPeak[c] = 0.0f;
+        }
+
+        state.ballistics.stepAll(state.targets.data(), state.ballisticsCoefficients, state.lastVu.data());
+        if (quasiPeak) {
+            releaseQuasiPeak(refDbfs, state);
+        }
+        for (unsigned int c = 0; c < channels; ++c) {
+            state.lastVu[c] = std::clamp(state.lastVu[c], minVu, maxVu);
+        }
+        state.subFrames = 0;
+        state.hasOutput = true;
+    }
 
-    outVuL = vuL;
-    outVuR = vuR;
+    updatePeakDbfs(state);
+    std::copy(state.lastVu.begin(), state.lastVu.end(), outVu);
 }
@@ -1,6 +1,17 @@
 #pragma once
 
-class VUBallistics;
+#include <vector>
+
+#include "VUBallistics.h"
+
+// Upper bound on the number of channels metered per stream
+static constexpr unsigned int kVuMaxChannels = 64;
+
+// Sample peaks below this (digital silence included) are reported as this value
+static constexpr float kVuPeakFloorDbfs = -120.0f;
+
+// Linear level (about -54 dBFS) above which a resting meter wakes up and follows the signal
+static constexpr float kVuWakeThreshold = 0.002f;
 
 struct VuReferenceOptions {
     double referenceDbfs = -18.0;
@@ -10,25 +21,98 @@ struct VuReferenceOptions {
     int deviceType = 0;
 };
 
+// Metering state of one interleaved stream, one entry per channel in each array.
+// Sized on first use and whenever the stream's channel count changes.
 struct VuAudioDspState {
-    float prevL = 0.0f;
-    float prevR = 0.0f;
+    VuAudioDspState() = default;
+    explicit VuAudioDspState(const VuJitterOptions& jitter,
+                             const VuBallisticsProfile& profile = VuBallisticsProfile())
+        : ballisticsProfile(profile) {
+        ballistics.setJitter(jitter);
+    }
+
+    unsigned int channels = 0;
+
+    std::vector<float> prev;             // previous raw sample (pre-emphasis)
+    std::vector<double> sums;            // sum of squares of the current block
+    std::vector<float> rmsSmooth;        // VU-integrated mean square
+    std::vector<unsigned char> awake;    // meter has seen signal since the last reset
+    std::vector<float> targets;          // detector output of the current step
+    VUBallisticsBank ballistics;
+    VuBallisticsProfile ballisticsProfile;
+
+    // Sample peak (no ballistics) of the audio passed to the last process call
+    std::vector<float> peak;      // largest |x| of the call
+    std::vector<float> blockPeak; // largest |x| of one kernel run (fixed-rate sub-blocks)
+    std::vector<float> peakDbfs;  // peak in dBFS, floored at kVuPeakFloorDbfs
 
-    float rmsL_smooth = 0.0f;
-    float rmsR_smooth = 0.0f;
+    // --- Quasi-peak detector (Ppm kind with the peak detector) ---
+    // Rectified signal integrated per sample with the attack time, linear. It charges
+    // only; after every step it is pulled down to the needle, whose dB/s return is
+    // the meter's decay.
+    std::vector<float> quasiPeak;
+    float quasiPeakSampleRate = 0.0f; // rate quasiPeakRise was computed for, 0 = recompute
+    float quasiPeakRise = 1.0f;       // share of the distance to |x| charged per sample
 
-    bool meterAwake = false;
+    // --- Per-buffer mode ---
+    // Coefficients for the last (sample rate, buffer size); hosts rarely change either
+    float cachedBlockSampleRate = 0.0f;
+    unsigned int cachedBlockFrames = 0;
+    float blockRmsAlpha = 0.0f;
+    VUBallistics::Coefficients blockCoefficients;
+
+    // --- Fixed control-rate mode ---
+    // Partial sub-block carried over to the next buffer
+    std::vector<double> subSums;
+    std::vector<float> subPeak;
+    unsigned int subFrames = 0;
+
+    // Coefficients for the current sample rate / control rate
+    float cachedSampleRate = 0.0f;
+    float cachedControlRateHz = 0.0f;
+    unsigned int subBlockFrames = 0;
+    float rmsAlpha = 0.0f;
+    VUBallistics::Coefficients ballisticsCoefficients;
+
+    std::vector<float> lastVu;
+    bool hasOutput = false;
+
+    // Resizes every array for `channelCount` and resets all meters to initialVu.
+    // Does nothing if the channel count is unchanged.
+    void configure(unsigned int channelCount, float initialVu);
+
+    // Switches the meter type; the needles carry on from where they are
+    void setBallisticsProfile(const VuBallisticsProfile& profile);
 };
 
+// Per-buffer mode: one RMS measurement and one ballistics step per call, with
+// dt = frames / sampleRate (clamped to 50 ms). outVu receives `channels` values;
+// state.peakDbfs the sample peak of the buffer.
 void processInterleavedFloatAudioToVuDb(const float* data,
-                                       unsigned int frames,
-                                       unsigned int channels,
-                                       float sampleRate,
-                                       const VuReferenceOptions& ref,
-                                       VUBallistics& ballisticsL,
-                                       VUBallistics& ballisticsR,
-                                       VuAudioDspState& state,
-                                       float minVu,
-                                       float maxVu,
-                                       float& outVuL,
-                                       float& outVuR);
+                                        unsigned int frames,
+                                        unsigned int channels,
+                                        float sampleRate,
+                                        const VuReferenceOptions& ref,
+                                        VuAudioDspState& state,
+                                        float minVu,
+                                        float maxVu,
+                                        float* outVu);
+
+// Fixed control-rate variant.
+//
+// Audio is integrated in sub-blocks of round(sampleRate / controlRateHz) frames that
+// carry across calls, and the RMS integrator and ballistics advance once per
+// sub-block with coefficients computed once per rate. The result is independent of
+// how the host splits the stream into buffers. Until the first sub-block completes
+// (and between completions) the last output is repeated. state.peakDbfs is the
+// sample peak of this call's buffer, whatever the sub-block boundaries.
+void processInterleavedFloatAudioToVuDbFixedRate(const float* data,
+                                                 unsigned int frames,
+                                                 unsigned int channels,
+                                                 float sampleRate,
+                                                 float controlRateHz,
+                                                 const VuReferenceOptions& ref,
+                                                 VuAudioDspState& state,
+                                                 float minVu,
+                                                 float maxVu,
+                                                 float* outVu);
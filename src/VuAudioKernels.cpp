@@ -0,0 +1,87 @@
+#include "VuAudioKernels.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "VuAudioKernelsImpl.h"
+
+namespace {
+
+#if defined(__SSE2__)
+struct Sse2Ops final {
+    using Vector = __m128;
+    static constexpr unsigned int kWidth = 4;
+
+    static Vector zero() { return _mm_setzero_ps(); }
+    static Vector set1(float v) { return _mm_set1_ps(v); }
+    static Vector load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, Vector v) { _mm_store_ps(p, v); }
+    static Vector add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+    static Vector sub(Vector a, Vector b) { return _mm_sub_ps(a, b); }
+    static Vector mul(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+    static Vector abs(Vector a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static Vector max(Vector a, Vector b) { return _mm_max_ps(a, b); }
+};
+#elif defined(__ARM_NEON)
+struct NeonOps final {
+    using Vector = float32x4_t;
+    static constexpr unsigned int kWidth = 4;
+
+    static Vector zero() { return vdupq_n_f32(0.0f); }
+    static Vector set1(float v) { return vdupq_n_f32(v); }
+    static Vector load(const float* p) { return vld1q_f32(p); }
+    static void store(float* p, Vector v) { vst1q_f32(p, v); }
+    static Vector add(Vector a, Vector b) { return vaddq_f32(a, b); }
+    static Vector sub(Vector a, Vector b) { return vsubq_f32(a, b); }
+    static Vector mul(Vector a, Vector b) { return vmulq_f32(a, b); }
+    static Vector abs(Vector a) { return vabsq_f32(a); }
+    static Vector max(Vector a, Vector b) { return vmaxq_f32(a, b); }
+};
+#endif
+
+using KernelFn = void (*)(const float*, unsigned int, unsigned int, float*, double*, float*);
+
+struct Kernel final {
+    KernelFn fn;
+    const char* name;
+};
+
+Kernel selectKernel() {
+#if defined(ANALOGVU_HAS_AVX2) && (ANALOGVU_HAS_AVX2 == 1)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {&vuPreEmphasisSumSquaresAvx2, "avx2"};
+    }
+#endif
+#if defined(__SSE2__)
+    return {&preEmphasisSumSquaresVector<Sse2Ops>, "sse2"};
+#elif defined(__ARM_NEON)
+    return {&preEmphasisSumSquaresVector<NeonOps>, "neon"};
+#else
+    return {&preEmphasisSumSquaresScalar, "scalar"};
+#endif
+}
+
+const Kernel& kernel() {
+    static const Kernel selected = selectKernel();
+    return selected;
+}
+
+} // namespace
+
+void vuPreEmphasisSumSquares(
+    const float* data, unsigned int frames, unsigned int channels, float* prev, double* sums, float* peaks) {
+    if (!data || frames == 0 || channels == 0) {
+        for (unsigned int c = 0; c < channels; ++c) {
+            sums[c] = 0.0;
+            peaks[c] = 0.0f;
+        }
+        return;
+    }
+    kernel().fn(data, frames, channels, prev, sums, peaks);
+}
+
+const char* vuPreEmphasisKernelName() { return kernel().name; }
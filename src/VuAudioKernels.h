@@ -0,0 +1,18 @@
+#pragma once
+
+// Highest channel count handled by the vectorized kernels (wider streams use the scalar path)
+static constexpr unsigned int kVuKernelMaxChannels = 64;
+
+// Pre-emphasized sum of squares and sample peak for every channel of an interleaved
+// float block.
+//
+// For each channel c, sums[c] receives the sum over the block of y[k]^2 with
+// y[k] = x[k] + 0.15 * (x[k] - x[k-1]), where x[-1] is prev[c], and peaks[c] the
+// largest |x[k]| (taken in the same pass). prev[c] is then updated to the block's
+// last sample of channel c. All arrays hold `channels` entries. The implementation
+// (AVX2, SSE2, NEON or scalar) is chosen at runtime.
+void vuPreEmphasisSumSquares(
+    const float* data, unsigned int frames, unsigned int channels, float* prev, double* sums, float* peaks);
+
+// Name of the implementation selected for this CPU
+const char* vuPreEmphasisKernelName();
@@ -0,0 +1,160 @@
+#pragma once
+
+// Shared body of the vectorized audio kernels.
+//
+// Included by one translation unit per instruction set, so everything in here has
+// internal linkage to keep the instantiations from being merged across ISAs by the
+// linker. An extended-ISA unit is compiled with the baseline flags and defines
+// ANALOGVU_KERNEL_TARGET (a target attribute) before including this file: with
+// -mavx2 on the whole unit, the inline std templates it instantiates would be AVX2
+// COMDAT copies, and the linker may keep one of those for every other caller.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+
+#include "VuAudioKernels.h"
+
+#ifndef ANALOGVU_KERNEL_TARGET
+#define ANALOGVU_KERNEL_TARGET
+#endif
+
+#if defined(ANALOGVU_HAS_AVX2) && (ANALOGVU_HAS_AVX2 == 1)
+void vuPreEmphasisSumSquaresAvx2(
+    const float* data, unsigned int frames, unsigned int channels, float* prev, double* sums, float* peaks);
+#endif
+
+namespace {
+
+// x + 0.15 (x - prev) == 1.15 x - 0.15 prev: no loop-carried dependency, the
+// previous frame is just the same stream read `channels` floats earlier.
+constexpr float kPreEmphasisGain = 1.15f;
+constexpr float kPreEmphasisPrevGain = 0.15f;
+
+// Flat interleaved range [begin, end). Indices below `channels` (the first frame)
+// take their previous sample from prev[].
+inline void preEmphasisSumSquaresRange(const float* data,
+                                       std::size_t begin,
+                                       std::size_t end,
+                                       unsigned int channels,
+                                       const float* prev,
+                                       double* sums,
+                                       float* peaks) {
+    unsigned int c = static_cast<unsigned int>(begin % channels);
+    for (std::size_t i = begin; i < end; ++i) {
+        const float x = data[i];
+        const float xp = (i < channels) ? prev[i] : data[i - channels];
+        const float y = kPreEmphasisGain * x - kPreEmphasisPrevGain * xp;
+        sums[c] += static_cast<double>(y) * static_cast<double>(y);
+        peaks[c] = std::max(peaks[c], std::fabs(x));
+        if (++c == channels) {
+            c = 0;
+        }
+    }
+}
+
+inline void updatePrev(const float* data, unsigned int frames, unsigned int channels, float* prev) {
+    if (frames == 0) {
+        return;
+    }
+    const float* last = data + static_cast<std::size_t>(frames - 1) * channels;
+    for (unsigned int c = 0; c < channels; ++c) {
+        prev[c] = last[c];
+    }
+}
+
+inline void preEmphasisSumSquaresScalar(
+    const float* data, unsigned int frames, unsigned int channels, float* prev, double* sums, float* peaks) {
+    for (unsigned int c = 0; c < channels; ++c) {
+        sums[c] = 0.0;
+        peaks[c] = 0.0f;
+    }
+    preEmphasisSumSquaresRange(data, 0, static_cast<std::size_t>(frames) * channels, channels, prev, sums, peaks);
+    updatePrev(data, frames, channels, prev);
+}
+
+constexpr unsigned int kMinAccumulators = 4;
+
+// Ops provides: Vector, kWidth, zero(), set1(), load() (unaligned), store(), add(), sub(), mul(),
+// abs(), max().
+//
+// Vectors are loaded straight from the interleaved stream, so lane l of a vector
+// at flat offset i belongs to channel (i + l) % channels. Rotating through a
+// multiple of channels / gcd(channels, W) accumulators keeps that mapping fixed
+// per accumulator; the lanes are folded back into per-channel sums at the end.
+// Each accumulator is a Kahan-compensated float sum with a running |x| maximum
+// next to it, fed from the same load.
+template <typename Ops>
+ANALOGVU_KERNEL_TARGET void preEmphasisSumSquaresVector(
+    const float* data, unsigned int frames, unsigned int channels, float* prev, double* sums, float* peaks) {
+    using Vector = typename Ops::Vector;
+    constexpr unsigned int W = Ops::kWidth;
+
+    if (channels > kVuKernelMaxChannels) {
+        preEmphasisSumSquaresScalar(data, frames, channels, prev, sums, peaks);
+        return;
+    }
+
+    for (unsigned int c = 0; c < channels; ++c) {
+        sums[c] = 0.0;
+        peaks[c] = 0.0f;
+    }
+
+    const std::size_t total = static_cast<std::size_t>(frames) * channels;
+    const std::size_t head = std::min<std::size_t>(channels, total);
+    preEmphasisSumSquaresRange(data, 0, head, channels, prev, sums, peaks);
+
+    // At least kMinAccumulators independent chains so the compensated add's latency
+    // does not bound throughput at low channel counts. The cycle stays a multiple of
+    // lcm(channels, W).
+    const unsigned int period = channels / std::gcd(channels, W);
+    const unsigned int accumulators = period * ((kMinAccumulators + period - 1) / period);
+    const std::size_t cycle = static_cast<std::size_t>(accumulators) * W;
+
+    Vector sum[kVuKernelMaxChannels];
+    Vector comp[kVuKernelMaxChannels];
+    Vector peak[kVuKernelMaxChannels];
+    for (unsigned int k = 0; k < accumulators; ++k) {
+        sum[k] = Ops::zero();
+        comp[k] = Ops::zero();
+        peak[k] = Ops::zero();
+    }
+
+    const Vector gain = Ops::set1(kPreEmphasisGain);
+    const Vector prevGain = Ops::set1(kPreEmphasisPrevGain);
+
+    std::size_t i = head;
+    for (; i + cycle <= total; i += cycle) {
+        const float* p = data + i;
+        for (unsigned int k = 0; k < accumulators; ++k, p += W) {
+            const Vector x = Ops::load(p);
+            const Vector y = Ops::sub(Ops::mul(gain, x), Ops::mul(prevGain, Ops::load(p - channels)));
+            const Vector t = Ops::sub(Ops::mul(y, y), comp[k]);
+            const Vector s = Ops::add(sum[k], t);
+            comp[k] = Ops::sub(Ops::sub(s, sum[k]), t);
+            sum[k] = s;
+            peak[k] = Ops::max(peak[k], Ops::abs(x));
+        }
+    }
+
+    // The vector loop starts at flat offset `channels`, i.e. channel 0
+    alignas(64) float sumLanes[W];
+    alignas(64) float compLanes[W];
+    alignas(64) float peakLanes[W];
+    for (unsigned int k = 0; k < accumulators; ++k) {
+        Ops::store(sumLanes, sum[k]);
+        Ops::store(compLanes, comp[k]);
+        Ops::store(peakLanes, peak[k]);
+        for (unsigned int l = 0; l < W; ++l) {
+            const unsigned int c = (k * W + l) % channels;
+            sums[c] += static_cast<double>(sumLanes[l]) - static_cast<double>(compLanes[l]);
+            peaks[c] = std::max(peaks[c], peakLanes[l]);
+        }
+    }
+
+    preEmphasisSumSquaresRange(data, i, total, channels, prev, sums, peaks);
+    updatePrev(data, frames, channels, prev);
+}
+
+} // namespace
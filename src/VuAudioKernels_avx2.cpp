@@ -0,0 +1,31 @@
+// Built with the baseline flags, AVX2 only inside the target("avx2") functions below
+// (see VuAudioKernelsImpl.h); only called after a runtime CPU check.
+
+#include <immintrin.h>
+
+#define ANALOGVU_KERNEL_TARGET __attribute__((target("avx2")))
+#include "VuAudioKernelsImpl.h"
+
+namespace {
+
+struct Avx2Ops final {
+    using Vector = __m256;
+    static constexpr unsigned int kWidth = 8;
+
+    ANALOGVU_KERNEL_TARGET static Vector zero() { return _mm256_setzero_ps(); }
+    ANALOGVU_KERNEL_TARGET static Vector set1(float v) { return _mm256_set1_ps(v); }
+    ANALOGVU_KERNEL_TARGET static Vector load(const float* p) { return _mm256_loadu_ps(p); }
+    ANALOGVU_KERNEL_TARGET static void store(float* p, Vector v) { _mm256_store_ps(p, v); }
+    ANALOGVU_KERNEL_TARGET static Vector add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+    ANALOGVU_KERNEL_TARGET static Vector sub(Vector a, Vector b) { return _mm256_sub_ps(a, b); }
+    ANALOGVU_KERNEL_TARGET static Vector mul(Vector a, Vector b) { return _mm256_mul_ps(a, b); }
+    ANALOGVU_KERNEL_TARGET static Vector abs(Vector a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    ANALOGVU_KERNEL_TARGET static Vector max(Vector a, Vector b) { return _mm256_max_ps(a, b); }
+};
+
+} // namespace
+
+ANALOGVU_KERNEL_TARGET void vuPreEmphasisSumSquaresAvx2(
+    const float* data, unsigned int frames, unsigned int channels, float* prev, double* sums, float* peaks) {
+    preEmphasisSumSquaresVector<Avx2Ops>(data, frames, channels, prev, sums, peaks);
+}
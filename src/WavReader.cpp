@@ -0,0 +1,225 @@
+#include "WavReader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static constexpr std::uint16_t kWaveFormatPcm = 0x0001;
+static constexpr std::uint16_t kWaveFormatFloat = 0x0003;
+static constexpr std::uint16_t kWaveFormatExtensible = 0xFFFE;
+
+// WAVE headers are little-endian whatever the host
+static std::uint16_t readU16(const unsigned char* p) {
+    return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+}
+
+static std::uint32_t readU32(const unsigned char* p) {
+    return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8) |
+           (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+}
+
+WavReader::~WavReader() { close(); }
+
+bool WavReader::open(const QString& path, QString* errorOut) {
+    close();
+
+    const int fd = ::open(path.toLocal8Bit().constData(), O_RDONLY);
+    if (fd < 0) {
+        if (errorOut) {
+            *errorOut = QStringLiteral("Cannot open %1: %2").arg(path, QString::fromLocal8Bit(std::strerror(errno)));
+        }
+        return false;
+    }
+
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        if (errorOut) {
+            *errorOut = QStringLiteral("Cannot read %1").arg(path);
+        }
+        return false;
+    }
+
+    mapSize_ = static_cast<std::size_t>(info.st_size);
+    void* map = ::mmap(nullptr, mapSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps the file
+    if (map == MAP_FAILED) {
+        mapSize_ = 0;
+        if (errorOut) {
+            *errorOut = QStringLiteral("Cannot map %1: %2").arg(path, QString::fromLocal8Bit(std::strerror(errno)));
+        }
+        return false;
+    }
+    map_ = map;
+
+    // Analysis walks each segment front to back
+    ::madvise(map_, mapSize_, MADV_SEQUENTIAL);
+
+    if (!parse(errorOut)) {
+        close();
+        return false;
+    }
+
+    if (errorOut) {
+        *errorOut = QString();
+    }
+    return true;
+}
+
+void WavReader::close() {
+    if (map_) {
+        ::munmap(map_, mapSize_);
+    }
+    map_ = nullptr;
+    mapSize_ = 0;
+    data_ = nullptr;
+    channels_ = 0;
+    frames_ = 0;
+}
+
+bool WavReader::parse(QString* errorOut) {
+    const auto fail = [errorOut](const QString& message) {
+        if (errorOut) {
+            *errorOut = message;
+        }
+        return false;
+    };
+
+    const auto* bytes = static_cast<const unsigned char*>(map_);
+    if (mapSize_ < 12 || std::memcmp(bytes, "RIFF", 4) != 0 || std::memcmp(bytes + 8, "WAVE", 4) != 0) {
+        return fail(QStringLiteral("Not a RIFF/WAVE file"));
+    }
+
+    bool haveFormat = false;
+    std::uint16_t formatTag = 0;
+    std::size_t offset = 12;
+
+    while (offset + 8 <= mapSize_) {
+        const unsigned char* chunk = bytes + offset;
+        const std::uint32_t size = readU32(chunk + 4);
+        const std::size_t body = offset + 8;
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0) {
+            if (size < 16 || body + size > mapSize_) {
+                return fail(QStringLiteral("Truncated fmt chunk"));
+            }
+            formatTag = readU16(bytes + body);
+            channels_ = readU16(bytes + body + 2);
+            sampleRate_ = static_cast<float>(readU32(bytes + body + 4));
+            bytesPerFrame_ = readU16(bytes + body + 12);
+            bitsPerSample_ = readU16(bytes + body + 14);
+            if (formatTag == kWaveFormatExtensible && size >= 40) {
+                // The sub-format GUID starts with the actual format tag
+                formatTag = readU16(bytes + body + 24);
+            }
+            haveFormat = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (!haveFormat) {
+                return fail(QStringLiteral("data chunk before fmt chunk"));
+            }
+            // Recorders that stop abruptly leave the size at 0 or too large: use what is there
+            const std::size_t available = mapSize_ - body;
+            const std::size_t dataSize = (size == 0 || size > available) ? available : size;
+            data_ = bytes + body;
+            frames_ = bytesPerFrame_ ? dataSize / bytesPerFrame_ : 0;
+            break;
+        }
+
+        // Chunks are padded to an even size
+        offset = body + size + (size & 1u);
+    }
+
+    if (!haveFormat || !data_) {
+        return fail(QStringLiteral("No fmt or data chunk"));
+    }
+    if (channels_ == 0 || sampleRate_ <= 0.0f || bytesPerFrame_ != channels_ * ((bitsPerSample_ + 7) / 8)) {
+        return fail(QStringLiteral("Invalid WAVE format header"));
+    }
+
+    if (formatTag == kWaveFormatPcm && (bitsPerSample_ == 8 || bitsPerSample_ == 16 || bitsPerSample_ == 24 ||
+                                        bitsPerSample_ == 32)) {
+        format_ = SampleFormat::Pcm;
+    } else if (formatTag == kWaveFormatFloat && (bitsPerSample_ == 32 || bitsPerSample_ == 64)) {
+        format_ = SampleFormat::Float;
+    } else {
+        return fail(QStringLiteral("Unsupported sample format (tag %1, %2 bits)").arg(formatTag).arg(bitsPerSample_));
+    }
+    return true;
+}
+
+const float* WavReader::floatFrames(std::uint64_t frame) const {
+    if (format_ != SampleFormat::Float || bitsPerSample_ != 32 || frame >= frames_) {
+        return nullptr;
+    }
+    const unsigned char* p = data_ + frame * bytesPerFrame_;
+    if (reinterpret_cast<std::uintptr_t>(p) % alignof(float) != 0) {
+        return nullptr;
+    }
+    return reinterpret_cast<const float*>(p);
+}
+
+void WavReader::readFrames(std::uint64_t frame, std::size_t count, float* out) const {
+    count = static_cast<std::size_t>(std::min<std::uint64_t>(count, frame < frames_ ? frames_ - frame : 0));
+    const unsigned char* p = data_ + frame * bytesPerFrame_;
+    const std::size_t samples = count * channels_;
+
+    if (format_ == SampleFormat::Float) {
+        if (bitsPerSample_ == 32) {
+            std::memcpy(out, p, samples * sizeof(float));
+        } else {
+            for (std::size_t i = 0; i < samples; ++i) {
+                double v;
+                std::memcpy(&v, p + i * 8, sizeof(v));
+                out[i] = static_cast<float>(v);
+            }
+        }
+        return;
+    }
+
+    switch (bitsPerSample_) {
+    case 8:
+        for (std::size_t i = 0; i < samples; ++i) {
+            out[i] = (static_cast<float>(p[i]) - 128.0f) * (1.0f / 128.0f);
+        }
+        break;
+    case 16:
+        for (std::size_t i = 0; i < samples; ++i) {
+            out[i] = static_cast<float>(static_cast<std::int16_t>(readU16(p + i * 2))) * (1.0f / 32768.0f);
+        }
+        break;
+    case 24:
+        for (std::size_t i = 0; i < samples; ++i) {
+            const unsigned char* s = p + i * 3;
+            const std::int32_t v = static_cast<std::int32_t>((static_cast<std::uint32_t>(s[0]) << 8) |
+                                                             (static_cast<std::uint32_t>(s[1]) << 16) |
+                                                             (static_cast<std::uint32_t>(s[2]) << 24)) >>
+                                   8;
+            out[i] = static_cast<float>(v) * (1.0f / 8388608.0f);
+        }
+        break;
+    default:
+        for (std::size_t i = 0; i < samples; ++i) {
+            out[i] = static_cast<float>(static_cast<std::int32_t>(readU32(p + i * 4))) * (1.0f / 2147483648.0f);
+        }
+        break;
+    }
+}
+
+void WavReader::willNeed(std::uint64_t frame, std::size_t count) const {
+    if (frame >= frames_) {
+        return;
+    }
+
+    // madvise wants a page-aligned start
+    static const std::uintptr_t pageSize = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+    const auto begin = reinterpret_cast<std::uintptr_t>(data_ + frame * bytesPerFrame_);
+    const std::uint64_t frames = std::min<std::uint64_t>(count, frames_ - frame);
+    const std::uintptr_t aligned = begin & ~(pageSize - 1);
+    const auto length = static_cast<std::size_t>(begin - aligned + frames * bytesPerFrame_);
+    ::madvise(reinterpret_cast<void*>(aligned), length, MADV_WILLNEED);
+}
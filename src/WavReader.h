@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QString>
+
+#include <cstddef>
+#include <cstdint>
+
+// Read-only, memory-mapped RIFF/WAVE file.
+//
+// Accepts PCM (8/16/24/32-bit) and IEEE float (32/64-bit) samples, including
+// WAVE_FORMAT_EXTENSIBLE headers. The sample data is never copied as a whole:
+// readers convert just the frames they need, and a 32-bit float file can be
+// metered straight from the mapping. Safe to read from several threads at once.
+class WavReader final {
+  public:
+    WavReader() = default;
+    ~WavReader();
+
+    WavReader(const WavReader&) = delete;
+    WavReader& operator=(const WavReader&) = delete;
+
+    bool open(const QString& path, QString* errorOut = nullptr);
+    void close();
+
+    unsigned int channels() const { return channels_; }
+    float sampleRate() const { return sampleRate_; }
+    std::uint64_t frames() const { return frames_; }
+
+    // Interleaved float view of the data from `frame` on when the file holds exactly
+    // that (aligned 32-bit float); nullptr otherwise
+    const float* floatFrames(std::uint64_t frame) const;
+
+    // Converts `count` frames from `frame` on to interleaved float in [-1, 1]
+    void readFrames(std::uint64_t frame, std::size_t count, float* out) const;
+
+    // Asks the kernel to read ahead the given frames
+    void willNeed(std::uint64_t frame, std::size_t count) const;
+
+  private:
+    enum class SampleFormat { Pcm, Float };
+
+    bool parse(QString* errorOut);
+
+    void* map_ = nullptr;
+    std::size_t mapSize_ = 0;
+
+    const unsigned char* data_ = nullptr; // first byte of the data chunk
+    SampleFormat format_ = SampleFormat::Pcm;
+    unsigned int bitsPerSample_ = 0;
+    unsigned int bytesPerFrame_ = 0;
+    unsigned int channels_ = 0;
+    float sampleRate_ = 0.0f;
+    std::uint64_t frames_ = 0;
+};
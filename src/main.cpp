@@ -2,18 +2,125 @@
 #include <QCommandLineParser>
 #include <QCoreApplication>
 #include <QTextStream>
+#include <QTimer>
+
+#include <csignal>
+#include <cstring>
+#include <memory>
 
 #include "AudioCapture.h"
+#include "CaptureManager.h"
+#include "FileAnalyzer.h"
+#include "LevelOutput.h"
 #include "MainWindow.h"
+#include "NeedleSpriteAtlas.h"
+#include "StartupTrace.h"
+
+static volatile std::sig_atomic_t quitRequested = 0;
+
+static void requestQuit(int) { quitRequested = 1; }
+
+// Decided before QCoreApplication exists: headless and analysis runs must not touch the display
+static bool hasOption(int argc, char** argv, const char* name) {
+    const size_t length = std::strlen(name);
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], name, length) == 0 && (argv[i][length] == '\0' || argv[i][length] == '=')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Capture and DSP only, with levels going to a LevelOutput instead of widgets
+static int runHeadless(const QList<AudioCapture::Options>& captures, const LevelOutput::Options& outputOptions) {
+    QTextStream err(stderr);
+
+    CaptureManager captureManager;
+    for (const AudioCapture::Options& options : captures) {
+        captureManager.addCapture(options);
+    }
+
+    captureManager.retainConnection();
+    int started = 0;
+    for (AudioCapture* capture : captureManager.captures()) {
+        QString error;
+        if (capture->start(&error)) {
+            ++started;
+        } else {
+            const QString device =
+                capture->currentDeviceUID().isEmpty() ? QStringLiteral("default device") : capture->currentDeviceUID();
+            err << device << ": " << error << Qt::endl;
+        }
+        QObject::connect(capture, &AudioCapture::errorOccurred, [capture](const QString& message) {
+            QTextStream(stderr) << capture->currentDeviceUID() << ": " << message << Qt::endl;
+        });
+    }
+    if (started == 0) {
+        return 1;
+    }
+
+    LevelOutput output(captureManager.captures(), outputOptions);
+    QString error;
+    if (!output.open(&error)) {
+        err << error << Qt::endl;
+        return 1;
+    }
+
+    int exitCode = 0;
+    QObject::connect(&output, &LevelOutput::errorOccurred, [&exitCode](const QString& message) {
+        QTextStream(stderr) << message << Qt::endl;
+        exitCode = 1;
+        QCoreApplication::quit();
+    });
+
+    // A closed pipe is reported by write(); SIGINT/SIGTERM flush the last batch first
+    std::signal(SIGPIPE, SIG_IGN);
+    std::signal(SIGINT, requestQuit);
+    std::signal(SIGTERM, requestQuit);
+    QTimer quitPoll;
+    QObject::connect(&quitPoll, &QTimer::timeout, [] {
+        if (quitRequested) {
+            QCoreApplication::quit();
+        }
+    });
+    quitPoll.start(100);
+
+    output.start();
+    QCoreApplication::exec();
+
+    output.stop();
+    captureManager.stopAll();
+    return exitCode;
+}
+
+// Offline: the file goes through the meter DSP as fast as it can be read
+static int runAnalyze(const FileAnalyzer::Options& options) {
+    FileAnalyzer analyzer(options);
+    QString error;
+    if (!analyzer.run(&error)) {
+        QTextStream(stderr) << error << Qt::endl;
+        return 1;
+    }
+    QTextStream(stderr) << analyzer.summaryString();
+    return 0;
+}
 
 int main(int argc, char** argv) {
-    QApplication app(argc, argv);
+    // Also decided early, so that creating the application is on the timeline
+    StartupTrace::setEnabled(hasOption(argc, argv, "--startup-trace"));
+
+    const bool headless = hasOption(argc, argv, "--headless") || hasOption(argc, argv, "--analyze");
+    std::unique_ptr<QCoreApplication> app =
+        headless ? std::make_unique<QCoreApplication>(argc, argv) : std::make_unique<QApplication>(argc, argv);
+    StartupTrace::mark("application");
     QCoreApplication::setApplicationName("AnalogVUMeterQt");
     QCoreApplication::setApplicationVersion("0.1.0");
 
     QCommandLineParser parser;
 #if defined(__APPLE__)
     parser.setApplicationDescription("Analog stereo VU meter (Qt 6 + CoreAudio)");
+#elif defined(ANALOGVU_HAS_PIPEWIRE) && (ANALOGVU_HAS_PIPEWIRE == 1)
+    parser.setApplicationDescription("Analog stereo VU meter (Qt 6 + PipeWire)");
 #else
     parser.setApplicationDescription("Analog stereo VU meter (Qt 6 + PulseAudio)");
 #endif
@@ -27,17 +134,109 @@ int main(int argc, char** argv) {
 #else
     QCommandLineOption deviceNameOpt(QStringList() << "device-name", "PulseAudio device name (sink/source).", "name");
 #endif
+    QCommandLineOption alsoDeviceOpt(QStringList() << "also-device",
+                                     "Meter this device too, next to the main one (repeatable).",
+                                     "name");
     QCommandLineOption deviceTypeOpt(
         QStringList() << "device-type", "Device type: 0=system output, 1=microphone.", "type", "0");
     QCommandLineOption refOpt(QStringList() << "ref-dbfs", "Reference dBFS for 0 VU.", "db", "-18");
+    QCommandLineOption controlRateOpt(QStringList() << "control-rate",
+                                      "Run meter ballistics at a fixed rate in Hz, independent of buffer size "
+                                      "(0 = once per buffer).",
+                                      "hz",
+                                      "0");
+    QCommandLineOption realtimeOpt(QStringList() << "realtime",
+                                   "Run audio callbacks with realtime priority (SCHED_FIFO/rtkit; always on macOS).");
+    QCommandLineOption idleAfterOpt(QStringList() << "idle-after",
+                                    "Seconds of silence before the meters stop repainting and capture in larger "
+                                    "blocks (0 = never).",
+                                    "seconds",
+                                    "3");
+    QCommandLineOption noJitterOpt(QStringList() << "no-jitter", "Turn off the needle micro-jitter.");
+    QCommandLineOption jitterSeedOpt(QStringList() << "jitter-seed",
+                                     "Seed of the needle micro-jitter, for reproducible levels (also enables it "
+                                     "for --analyze).",
+                                     "seed");
+    QCommandLineOption ballisticsOpt(QStringList() << "ballistics",
+                                     "Meter dynamics: pioneer (default), vu (IEC 60268-17), ppm1, ppm2 or nordic "
+                                     "(IEC 60268-10).",
+                                     "profile",
+                                     "pioneer");
+    QCommandLineOption needleAtlasOpt(QStringList() << "needle-atlas-step",
+                                      "Pre-rotate skin needles in steps of this many degrees (0 = off).",
+                                      "deg",
+                                      "0");
+    QCommandLineOption maxFpsOpt(
+        QStringList() << "max-fps", "Cap the meter frame rate (0 = display refresh rate).", "fps", "0");
+    QCommandLineOption allChannelsOpt(QStringList() << "all-channels",
+                                      "Show one meter per captured channel instead of a stereo pair.");
+    QCommandLineOption rendererOpt(
+        QStringList() << "renderer", "Meter renderer: raster (default) or opengl.", "backend", "raster");
+    QCommandLineOption renderThreadOpt(QStringList() << "render-thread",
+                                       "Compose raster meter frames on a separate thread.");
+    QCommandLineOption headlessOpt(QStringList() << "headless",
+                                   "Run without a window and stream the levels (see --level-output).");
+    QCommandLineOption levelOutputOpt(QStringList() << "level-output",
+                                      "Headless level stream target: stdout, unix:<path> or udp:<host>:<port>.",
+                                      "target",
+                                      "stdout");
+    QCommandLineOption levelFormatOpt(QStringList() << "level-format",
+                                      "Headless level stream format: json (one line per frame) or binary.",
+                                      "format",
+                                      "json");
+    QCommandLineOption levelRateOpt(QStringList() << "level-rate", "Headless level frames per second.", "hz", "30");
+    QCommandLineOption levelBatchOpt(
+        QStringList() << "level-batch", "Headless level frames per write (or datagram).", "frames", "10");
+    QCommandLineOption perfHudOpt(QStringList() << "perf-hud",
+                                  "Show the performance overlay (paint, frame, audio callback and latency timing).");
+    QCommandLineOption startupTraceOpt(
+        QStringList() << "startup-trace",
+        "Print the time of each startup phase (fonts, skins, devices, audio, first frame) to stderr.");
+    QCommandLineOption perfIntervalOpt(QStringList() << "perf-interval",
+                                       "Headless: dump timing statistics every this many seconds (0 = off).",
+                                       "seconds",
+                                       "0");
+    QCommandLineOption analyzeOpt(QStringList() << "analyze",
+                                  "Meter a WAV file offline, faster than realtime, and write its VU curve as CSV.",
+                                  "file");
+    QCommandLineOption analyzeOutputOpt(
+        QStringList() << "analyze-output", "CSV file for the --analyze curve (- = stdout).", "file", "-");
+    QCommandLineOption analyzeRateOpt(
+        QStringList() << "analyze-rate", "Points per second of the --analyze curve.", "hz", "100");
+    QCommandLineOption threadsOpt(
+        QStringList() << "threads", "Threads for --analyze (0 = one per core).", "count", "0");
 
     parser.addOption(listDevicesOpt);
     parser.addOption(deviceOpt);
     parser.addOption(deviceNameOpt);
+    parser.addOption(alsoDeviceOpt);
     parser.addOption(deviceTypeOpt);
     parser.addOption(refOpt);
+    parser.addOption(controlRateOpt);
+    parser.addOption(realtimeOpt);
+    parser.addOption(idleAfterOpt);
+    parser.addOption(noJitterOpt);
+    parser.addOption(jitterSeedOpt);
+    parser.addOption(ballisticsOpt);
+    parser.addOption(needleAtlasOpt);
+    parser.addOption(rendererOpt);
+    parser.addOption(renderThreadOpt);
+    parser.addOption(maxFpsOpt);
+    parser.addOption(allChannelsOpt);
+    parser.addOption(headlessOpt);
+    parser.addOption(levelOutputOpt);
+    parser.addOption(levelFormatOpt);
+    parser.addOption(levelRateOpt);
+    parser.addOption(levelBatchOpt);
+    parser.addOption(perfHudOpt);
+    parser.addOption(startupTraceOpt);
+    parser.addOption(perfIntervalOpt);
+    parser.addOption(analyzeOpt);
+    parser.addOption(analyzeOutputOpt);
+    parser.addOption(analyzeRateOpt);
+    parser.addOption(threadsOpt);
 
-    parser.process(app);
+    parser.process(*app);
 
     if (parser.isSet(listDevicesOpt)) {
         QTextStream(stdout) << AudioCapture::listDevicesString();
@@ -77,8 +276,142 @@ int main(int argc, char** argv) {
         }
     }
 
-    MainWindow w(options);
+    if (parser.isSet(controlRateOpt)) {
+        bool ok = false;
+        const double rate = parser.value(controlRateOpt).toDouble(&ok);
+        if (ok && rate >= 0.0) {
+            options.controlRateHz = rate;
+        }
+    }
+
+    options.realtime = parser.isSet(realtimeOpt);
+
+    if (parser.isSet(idleAfterOpt)) {
+        bool ok = false;
+        const double seconds = parser.value(idleAfterOpt).toDouble(&ok);
+        if (ok && seconds >= 0.0) {
+            options.idleAfterSeconds = seconds;
+        }
+    }
+
+    options.jitter.enabled = !parser.isSet(noJitterOpt);
+    bool jitterSeeded = false;
+    if (parser.isSet(jitterSeedOpt)) {
+        const unsigned int seed = parser.value(jitterSeedOpt).toUInt(&jitterSeeded);
+        if (jitterSeeded) {
+            options.jitter.seed = seed;
+        }
+    }
+
+    if (parser.isSet(ballisticsOpt)) {
+        const QString name = parser.value(ballisticsOpt).toLower();
+        if (!vuBallisticsPresetByName(name.toStdString(), &options.ballistics)) {
+            QTextStream(stderr) << "Unknown ballistics profile: " << name << " (using pioneer)\n";
+        }
+    }
+
+    MainWindow::DisplayOptions display;
+
+    if (parser.isSet(needleAtlasOpt)) {
+        bool ok = false;
+        const float step = parser.value(needleAtlasOpt).toFloat(&ok);
+        if (ok && step > 0.0f && step < NeedleSpriteAtlas::kMinStepDeg) {
+            QTextStream(stderr) << "Needle atlas step below " << NeedleSpriteAtlas::kMinStepDeg
+                                << " degrees: " << step << " (using " << NeedleSpriteAtlas::kMinStepDeg << ")\n";
+            display.needleAtlasStepDeg = NeedleSpriteAtlas::kMinStepDeg;
+        } else if (ok && step >= 0.0f) {
+            display.needleAtlasStepDeg = step;
+        }
+    }
+
+    if (parser.isSet(maxFpsOpt)) {
+        bool ok = false;
+        const int fps = parser.value(maxFpsOpt).toInt(&ok);
+        if (ok && fps >= 0) {
+            display.maxFps = fps;
+        }
+    }
+
+    display.meterAllChannels = parser.isSet(allChannelsOpt);
+    display.perfHud = parser.isSet(perfHudOpt);
+    display.renderThread = parser.isSet(renderThreadOpt);
+
+    if (parser.isSet(rendererOpt)) {
+        const QString renderer = parser.value(rendererOpt).toLower();
+        if (renderer == QStringLiteral("opengl")) {
+            display.useOpenGL = true;
+        } else if (renderer != QStringLiteral("raster")) {
+            QTextStream(stderr) << "Unknown renderer: " << renderer << " (using raster)\n";
+        }
+    }
+
+    // Additional devices share every setting of the main one except the device itself
+    QList<AudioCapture::Options> captures{options};
+    for (const QString& name : parser.values(alsoDeviceOpt)) {
+        AudioCapture::Options extra = options;
+        extra.deviceName = name;
+        captures.append(extra);
+    }
+
+    if (parser.isSet(analyzeOpt)) {
+        FileAnalyzer::Options analysis;
+        analysis.inputPath = parser.value(analyzeOpt);
+        analysis.outputPath = parser.value(analyzeOutputOpt);
+        analysis.reference.referenceDbfs = options.referenceDbfs;
+        analysis.reference.referenceDbfsOverride = options.referenceDbfsOverride;
+        analysis.reference.deviceType = options.deviceType;
+        if (options.controlRateHz > 0.0) {
+            analysis.controlRateHz = options.controlRateHz;
+        }
+        if (jitterSeeded && options.jitter.enabled) {
+            analysis.jitter = options.jitter;
+        }
+        analysis.ballistics = options.ballistics;
+
+        bool ok = false;
+        const double rate = parser.value(analyzeRateOpt).toDouble(&ok);
+        if (ok && rate > 0.0) {
+            analysis.curveRateHz = rate;
+        }
+
+        const int threads = parser.value(threadsOpt).toInt(&ok);
+        if (ok && threads >= 0) {
+            analysis.threads = threads;
+        }
+
+        return runAnalyze(analysis);
+    }
+
+    if (headless) {
+        LevelOutput::Options output;
+        output.target = parser.value(levelOutputOpt);
+
+        if (!LevelOutput::parseFormat(parser.value(levelFormatOpt), &output.format)) {
+            QTextStream(stderr) << "Unknown level format: " << parser.value(levelFormatOpt) << " (using json)\n";
+        }
+
+        bool ok = false;
+        const double rate = parser.value(levelRateOpt).toDouble(&ok);
+        if (ok && rate > 0.0) {
+            output.rateHz = rate;
+        }
+
+        const int batch = parser.value(levelBatchOpt).toInt(&ok);
+        if (ok && batch > 0) {
+            output.batchFrames = batch;
+        }
+
+        const double perfInterval = parser.value(perfIntervalOpt).toDouble(&ok);
+        if (ok && perfInterval >= 0.0) {
+            output.perfIntervalSeconds = perfInterval;
+        }
+
+        return runHeadless(captures, output);
+    }
+
+    MainWindow w(captures, display);
     w.show();
+    StartupTrace::mark("window shown");
 
-    return app.exec();
+    return app->exec();
 }